@@ -0,0 +1,413 @@
+
+/// @file BenchGrammer.cc
+/// @brief ベンチマーク用の文法を作る関数の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "BenchGrammer.h"
+#include "../src/Grammer.h"
+#include "../src/Token.h"
+#include <sstream>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 再現性のための簡単な乱数生成器 (xorshift)
+class Rand
+{
+public:
+
+  // コンストラクタ
+  Rand(ymuint seed) :
+    mX(seed * 2654435761U + 1U)
+  {
+  }
+
+  // 0 〜 n - 1 の乱数を返す．
+  ymuint
+  operator()(ymuint n)
+  {
+    mX ^= mX << 13;
+    mX ^= mX >> 17;
+    mX ^= mX << 5;
+    return mX % n;
+  }
+
+private:
+
+  ymuint32 mX;
+
+};
+
+// 右辺を作って規則を追加する．
+void
+add_rule(Grammer& g,
+	 Token* left,
+	 Token* t0,
+	 Token* t1 = NULL,
+	 Token* t2 = NULL)
+{
+  vector<Token*> right;
+  right.push_back(t0);
+  if ( t1 != NULL ) {
+    right.push_back(t1);
+  }
+  if ( t2 != NULL ) {
+    right.push_back(t2);
+  }
+  g.add_rule(left, right);
+}
+
+// 規則 A -> X1 ... Xn の X1 ... X(k-1) が全て空列を導出する時の
+// A から Xk への辺
+struct Edge
+{
+  // 元の非終端記号の番号
+  ymuint mFrom;
+
+  // 行き先の非終端記号の番号
+  ymuint mTo;
+
+  // 規則の番号
+  ymuint mRule;
+
+  // 右辺の中の Xk の位置 (k - 1)
+  ymuint mPos;
+
+  // k = 1 かつ Xk より後に空列を導出しない記号がある時 true
+  bool mPlain;
+};
+
+// remove_loop() の下請け関数
+// from から to への辺の列を幅優先で探して path に加える．
+bool
+find_path(ymuint from,
+	  ymuint to,
+	  const vector<vector<Edge> >& edge_list,
+	  vector<Edge>& path)
+{
+  ymuint nn = edge_list.size();
+  vector<bool> mark(nn, false);
+  vector<Edge> from_edge(nn);
+  vector<ymuint> queue;
+  queue.push_back(from);
+  mark[from] = true;
+  for (ymuint rpos = 0; rpos < queue.size(); ++ rpos) {
+    ymuint i = queue[rpos];
+    if ( i == to ) {
+      while ( i != from ) {
+	path.push_back(from_edge[i]);
+	i = from_edge[i].mFrom;
+      }
+      return true;
+    }
+    const vector<Edge>& edges = edge_list[i];
+    for (ymuint e = 0; e < edges.size(); ++ e) {
+      ymuint j = edges[e].mTo;
+      if ( !mark[j] ) {
+	mark[j] = true;
+	from_edge[j] = edges[e];
+	queue.push_back(j);
+      }
+    }
+  }
+  return false;
+}
+
+// LR 構文解析器が shift せずに reduce を繰り返すことになる再帰をなくす．
+// @param[in] nt 終端記号数
+// @param[in] first_num 各非終端記号の最初の規則の数
+// @param[in] left_list 規則の左辺
+// @param[in] right_list 規則の右辺
+// @param[in] empty_list 空規則を持つ時 true となる配列
+// @param[in] rand 置き換える終端記号を選ぶ乱数
+//
+// 次の二つをなくす．
+// - A =>+ A となる導出 (cyclic grammar)
+// - A =>+ B A C で B が空列を導出するもの (隠れた左再帰)
+// どちらも文法が曖昧になり，衝突の解消によっては構文解析器が
+// 止まらなくなる．Edge の辺の閉路は左再帰を表し，普通の左再帰
+// (mPlain が true の辺) だけからなる閉路以外が上のいずれかを含む．
+// そのような閉路があれば，その上の辺のうち後から加えた規則のものの
+// Xk を終端記号に置き換え，なくなるまで繰り返す．
+// 最初の規則の辺は番号の大きい非終端記号にしか向かわないので，
+// 閉路には必ず後から加えた規則の辺が含まれる．
+void
+remove_loop(ymuint nt,
+	    ymuint first_num,
+	    const vector<ymuint>& left_list,
+	    vector<vector<ymuint> >& right_list,
+	    const vector<bool>& empty_list,
+	    Rand& rand)
+{
+  ymuint nn = empty_list.size();
+  for ( ; ; ) {
+    // 空列を導出する非終端記号を求める．
+    vector<bool> nullable(empty_list);
+    for (bool changed = true; changed; ) {
+      changed = false;
+      for (ymuint r = 0; r < left_list.size(); ++ r) {
+	if ( nullable[left_list[r]] ) {
+	  continue;
+	}
+	const vector<ymuint>& right = right_list[r];
+	bool all = true;
+	for (ymuint k = 0; k < right.size(); ++ k) {
+	  if ( right[k] < nt || !nullable[right[k] - nt] ) {
+	    all = false;
+	    break;
+	  }
+	}
+	if ( all ) {
+	  nullable[left_list[r]] = true;
+	  changed = true;
+	}
+      }
+    }
+
+    vector<vector<Edge> > edge_list(nn);
+    for (ymuint r = 0; r < left_list.size(); ++ r) {
+      const vector<ymuint>& right = right_list[r];
+      // rest_nullable[k] は k 番目より後が全て空列を導出する時 true
+      vector<bool> rest_nullable(right.size(), true);
+      for (ymuint k = right.size() - 1; k > 0; -- k) {
+	ymuint sym = right[k];
+	rest_nullable[k - 1] = rest_nullable[k] && sym >= nt && nullable[sym - nt];
+      }
+      for (ymuint k = 0; k < right.size() && right[k] >= nt; ++ k) {
+	Edge edge;
+	edge.mFrom = left_list[r];
+	edge.mTo = right[k] - nt;
+	edge.mRule = r;
+	edge.mPos = k;
+	edge.mPlain = k == 0 && !rest_nullable[k];
+	edge_list[edge.mFrom].push_back(edge);
+	if ( !nullable[edge.mTo] ) {
+	  break;
+	}
+      }
+    }
+
+    vector<Edge> path;
+    for (ymuint i = 0; i < nn && path.empty(); ++ i) {
+      const vector<Edge>& edges = edge_list[i];
+      for (ymuint e = 0; e < edges.size(); ++ e) {
+	if ( !edges[e].mPlain &&
+	     find_path(edges[e].mTo, i, edge_list, path) ) {
+	  path.push_back(edges[e]);
+	  break;
+	}
+      }
+    }
+    if ( path.empty() ) {
+      break;
+    }
+
+    for (ymuint k = 0; ; ++ k) {
+      ASSERT_COND( k < path.size() );
+      const Edge& edge = path[k];
+      if ( edge.mRule >= first_num ) {
+	right_list[edge.mRule][edge.mPos] = rand(nt);
+	break;
+      }
+    }
+  }
+}
+
+END_NONAMESPACE
+
+
+// @brief tests/Grammer_test.cc と同じテスト用の文法を作る．
+// @param[in] test_id テスト番号 ( 1 <= test_id <= 3 )
+// @param[in] g 文法を作る対象
+// @return 開始記号を返す．
+Token*
+make_test_grammer(ymuint test_id,
+		  Grammer& g)
+{
+  switch ( test_id ) {
+  case 1:
+    {
+      Token* id = g.add_token("id");
+      Token* plus = g.add_token("+");
+      Token* times = g.add_token("*");
+      Token* lpar = g.add_token("(");
+      Token* rpar = g.add_token(")");
+      Token* expr = g.add_token("expr");
+      Token* term = g.add_token("term");
+      Token* factor = g.add_token("factor");
+
+      add_rule(g, expr, expr, plus, term);
+      add_rule(g, expr, term);
+      add_rule(g, term, term, times, factor);
+      add_rule(g, term, factor);
+      add_rule(g, factor, lpar, expr, rpar);
+      add_rule(g, factor, id);
+      return expr;
+    }
+
+  case 2:
+    {
+      Token* id = g.add_token("id");
+      Token* eq = g.add_token("=");
+      Token* star = g.add_token("*");
+      Token* S = g.add_token("S");
+      Token* L = g.add_token("L");
+      Token* R = g.add_token("R");
+
+      add_rule(g, S, L, eq, R);
+      add_rule(g, S, R);
+      add_rule(g, L, star, R);
+      add_rule(g, L, id);
+      add_rule(g, R, L);
+      return S;
+    }
+
+  case 3:
+    {
+      Token* id = g.add_token("id");
+      Token* plus = g.add_token("+", 1, kLeftAssoc);
+      Token* times = g.add_token("*", 2, kLeftAssoc);
+      Token* lpar = g.add_token("(");
+      Token* rpar = g.add_token(")");
+      Token* expr = g.add_token("expr");
+
+      add_rule(g, expr, id);
+      add_rule(g, expr, expr, plus, expr);
+      add_rule(g, expr, expr, times, expr);
+      add_rule(g, expr, lpar, expr, rpar);
+      return expr;
+    }
+
+  default:
+    break;
+  }
+  ASSERT_NOT_REACHED;
+  return NULL;
+}
+
+// @brief 人工的な文法を作る．
+// @param[in] param パラメータ
+// @param[in] g 文法を作る対象
+// @return 開始記号を返す．
+//
+// - 非終端記号 n(i) の最初の規則は終端記号と n(j) (j > i) のみからなり，
+//   n(i + 1) を必ず含む．これで全ての非終端記号が到達可能かつ有限の
+//   終端記号列を導出することが保証される．
+// - 残りの規則は任意の記号からなる．
+// - 空規則を加えた後で A =>+ A となる導出や隠れた左再帰があれば，
+//   後から加えた規則の非終端記号を終端記号に置き換えてなくす．
+// - prec_num > 0 の時は expr -> expr op(k) expr という二項演算子の
+//   規則と n(0) -> expr を加える．
+Token*
+make_synth_grammer(const SynthParam& param,
+		   Grammer& g)
+{
+  ASSERT_COND( param.token_num > 0 );
+  ASSERT_COND( param.nonterm_num > 0 );
+  ASSERT_COND( param.rhs_len > 0 );
+
+  Rand rand(param.seed);
+
+  vector<Token*> term_list(param.token_num);
+  for (ymuint i = 0; i < param.token_num; ++ i) {
+    ostringstream buf;
+    buf << "t" << i;
+    term_list[i] = g.add_token(buf.str());
+  }
+
+  vector<Token*> op_list(param.prec_num);
+  for (ymuint i = 0; i < param.prec_num; ++ i) {
+    ostringstream buf;
+    buf << "op" << i;
+    op_list[i] = g.add_token(buf.str(), i + 1, kLeftAssoc);
+  }
+
+  ymuint nn = param.nonterm_num;
+  vector<Token*> nonterm_list(nn);
+  for (ymuint i = 0; i < nn; ++ i) {
+    ostringstream buf;
+    buf << "n" << i;
+    nonterm_list[i] = g.add_token(buf.str());
+  }
+
+  // 右辺の記号は token_num 未満なら終端記号，以上なら非終端記号の番号
+  // に token_num を足したもので表す．
+  ymuint nt = param.token_num;
+  vector<ymuint> left_list;
+  vector<vector<ymuint> > right_list;
+
+  // 各非終端記号の最初の規則
+  for (ymuint i = 0; i < nn; ++ i) {
+    ymuint len = rand(param.rhs_len) + 1;
+    ymuint chain_pos = rand(len);
+    vector<ymuint> right;
+    for (ymuint k = 0; k < len; ++ k) {
+      if ( i + 1 < nn && k == chain_pos ) {
+	right.push_back(nt + i + 1);
+      }
+      else if ( i + 1 < nn && rand(4) == 0 ) {
+	right.push_back(nt + i + 1 + rand(nn - i - 1));
+      }
+      else {
+	right.push_back(rand(nt));
+      }
+    }
+    left_list.push_back(i);
+    right_list.push_back(right);
+  }
+
+  // 残りの規則
+  ymuint ns = nt + nn;
+  for (ymuint r = nn; r < param.rule_num; ++ r) {
+    ymuint len = rand(param.rhs_len) + 1;
+    vector<ymuint> right(len);
+    left_list.push_back(rand(nn));
+    for (ymuint k = 0; k < len; ++ k) {
+      right[k] = rand(ns);
+    }
+    right_list.push_back(right);
+  }
+
+  // 空規則
+  vector<bool> empty_list(nn);
+  for (ymuint i = 0; i < nn; ++ i) {
+    empty_list[i] = rand(100) < param.nullable_pct;
+  }
+
+  remove_loop(nt, nn, left_list, right_list, empty_list, rand);
+
+  for (ymuint r = 0; r < left_list.size(); ++ r) {
+    const vector<ymuint>& right = right_list[r];
+    vector<Token*> right_token(right.size());
+    for (ymuint k = 0; k < right.size(); ++ k) {
+      ymuint sym = right[k];
+      right_token[k] = sym < nt ? term_list[sym] : nonterm_list[sym - nt];
+    }
+    g.add_rule(nonterm_list[left_list[r]], right_token);
+  }
+  for (ymuint i = 0; i < nn; ++ i) {
+    if ( empty_list[i] ) {
+      g.add_rule(nonterm_list[i], vector<Token*>(0));
+    }
+  }
+
+  // 二項演算子
+  if ( param.prec_num > 0 ) {
+    Token* expr = g.add_token("expr");
+    for (ymuint i = 0; i < param.prec_num; ++ i) {
+      add_rule(g, expr, expr, op_list[i], expr);
+    }
+    add_rule(g, expr, term_list[0]);
+    add_rule(g, nonterm_list[0], expr);
+  }
+
+  return nonterm_list[0];
+}
+
+END_NAMESPACE_YM
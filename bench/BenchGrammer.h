@@ -0,0 +1,88 @@
+#ifndef BENCHGRAMMER_H
+#define BENCHGRAMMER_H
+
+/// @file BenchGrammer.h
+/// @brief ベンチマーク用の文法を作る関数のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class Grammer;
+class Token;
+
+//////////////////////////////////////////////////////////////////////
+/// @class SynthParam BenchGrammer.h "BenchGrammer.h"
+/// @brief 人工的な文法を作るためのパラメータ
+//////////////////////////////////////////////////////////////////////
+struct SynthParam
+{
+  /// @brief コンストラクタ
+  ///
+  /// デフォルト値を設定する．
+  SynthParam() :
+    token_num(16),
+    nonterm_num(16),
+    rule_num(48),
+    rhs_len(4),
+    prec_num(0),
+    nullable_pct(0),
+    seed(1)
+  {
+  }
+
+  /// @brief 終端記号数 (演算子は除く)
+  ymuint token_num;
+
+  /// @brief 非終端記号数
+  ymuint nonterm_num;
+
+  /// @brief 文法規則数 (nonterm_num 以上，空規則と演算子の規則は除く)
+  ymuint rule_num;
+
+  /// @brief 右辺の最大長
+  ymuint rhs_len;
+
+  /// @brief 優先順位の段数 (二項演算子の数)
+  ymuint prec_num;
+
+  /// @brief 空規則を持つ非終端記号の割合 (%)
+  ymuint nullable_pct;
+
+  /// @brief 乱数の種
+  ymuint seed;
+};
+
+
+/// @brief tests/Grammer_test.cc と同じテスト用の文法を作る．
+/// @param[in] test_id テスト番号 ( 1 <= test_id <= 3 )
+/// @param[in] g 文法を作る対象
+/// @return 開始記号を返す．
+///
+/// set_start() は呼ばない．
+Token*
+make_test_grammer(ymuint test_id,
+		  Grammer& g);
+
+/// @brief 人工的な文法を作る．
+/// @param[in] param パラメータ
+/// @param[in] g 文法を作る対象
+/// @return 開始記号を返す．
+///
+/// set_start() は呼ばない．
+/// 全ての非終端記号は開始記号から到達可能で，かつ有限の終端記号列を導出する．
+/// A =>+ A となる導出や隠れた左再帰 (A =>+ B A C で B =>* ε) は
+/// 持たないので，生成した文を LR 構文解析器で解析しても止まる．
+Token*
+make_synth_grammer(const SynthParam& param,
+		   Grammer& g);
+
+END_NAMESPACE_YM
+
+#endif // BENCHGRAMMER_H
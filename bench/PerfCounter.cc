@@ -0,0 +1,234 @@
+
+/// @file PerfCounter.cc
+/// @brief PerfCounter の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "PerfCounter.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#define PARSER_HAVE_PERF_EVENT 1
+#else
+#define PARSER_HAVE_PERF_EVENT 0
+#endif
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+#if PARSER_HAVE_PERF_EVENT
+
+// イベントに対応する perf_event_attr の type と config
+struct EventConfig
+{
+  ymuint32 mType;
+  ymuint64 mConfig;
+};
+
+const EventConfig kEventConfig[PerfCounter::kEventNum] = {
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+  { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+};
+
+// カウンタを開く．
+// group_fd が -1 の時はグループの先頭として停止した状態で開き，
+// それ以外の時は group_fd のグループに加える．
+// 失敗したら -1 を返す．
+int
+open_event(const EventConfig& config,
+	   int group_fd)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = config.mType;
+  attr.config = config.mConfig;
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.inherit = 0;
+  attr.read_format = PERF_FORMAT_GROUP
+    | PERF_FORMAT_TOTAL_TIME_ENABLED
+    | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  long fd = syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+  return static_cast<int>(fd);
+}
+
+#endif
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス PerfCounter
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+PerfCounter::Values::Values() :
+  mTimeEnabled(0),
+  mTimeRunning(0)
+{
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    mVal[i] = 0;
+  }
+}
+
+// @brief コンストラクタ
+//
+// 最初に開けたイベント (通常は cycles) をグループの先頭にする．
+PerfCounter::PerfCounter() :
+  mLeader(-1),
+  mGroupSize(0)
+{
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    mFd[i] = -1;
+    mSlot[i] = -1;
+#if PARSER_HAVE_PERF_EVENT
+    mFd[i] = open_event(kEventConfig[i], mLeader);
+    if ( mFd[i] >= 0 ) {
+      if ( mLeader < 0 ) {
+	mLeader = mFd[i];
+      }
+      mSlot[i] = mGroupSize;
+      ++ mGroupSize;
+    }
+#endif
+  }
+#if PARSER_HAVE_PERF_EVENT
+  if ( mLeader >= 0 ) {
+    ioctl(mLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(mLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+}
+
+// @brief デストラクタ
+PerfCounter::~PerfCounter()
+{
+#if PARSER_HAVE_PERF_EVENT
+  // グループの先頭は最後に閉じる．
+  for (ymuint i = kEventNum; i > 0; -- i) {
+    if ( mFd[i - 1] >= 0 ) {
+      close(mFd[i - 1]);
+    }
+  }
+#endif
+}
+
+// @brief いずれかのイベントが使用可能の時 true を返す．
+bool
+PerfCounter::is_available() const
+{
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    if ( mFd[i] >= 0 ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// @brief 指定されたイベントが使用可能の時 true を返す．
+// @param[in] event イベント
+bool
+PerfCounter::is_available(Event event) const
+{
+  ASSERT_COND( event < kEventNum );
+  return mFd[event] >= 0;
+}
+
+// @brief 現在の値を読み出す．
+// @param[out] values 値を格納する構造体
+//
+// PERF_FORMAT_GROUP の読み出し結果は
+// { nr, time_enabled, time_running, value[nr] } の順に並ぶ．
+void
+PerfCounter::read(Values& values) const
+{
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    values.mVal[i] = 0;
+  }
+  values.mTimeEnabled = 0;
+  values.mTimeRunning = 0;
+#if PARSER_HAVE_PERF_EVENT
+  if ( mLeader < 0 ) {
+    return;
+  }
+  ymuint64 buf[3 + kEventNum];
+  ssize_t size = (3 + mGroupSize) * sizeof(ymuint64);
+  if ( ::read(mLeader, buf, size) != size || buf[0] != mGroupSize ) {
+    return;
+  }
+  values.mTimeEnabled = buf[1];
+  values.mTimeRunning = buf[2];
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    if ( mSlot[i] >= 0 ) {
+      values.mVal[i] = buf[3 + mSlot[i]];
+    }
+  }
+#endif
+}
+
+// @brief 区間の値を足し込む．
+// @param[in] begin 区間の始めに read() で読んだ値
+// @param[in] end 区間の終わりに read() で読んだ値
+// @param[inout] total 補正した区間の値を足し込む構造体
+//
+// グループは全体がまとめて PMU に載るので，補正の比は全ての
+// イベントで共通である．
+void
+PerfCounter::add_interval(const Values& begin,
+			  const Values& end,
+			  Values& total)
+{
+  // 読み出しに失敗すると値は 0 になるので，減っていたら捨てる．
+  if ( end.mTimeEnabled < begin.mTimeEnabled ||
+       end.mTimeRunning < begin.mTimeRunning ) {
+    return;
+  }
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    if ( end.mVal[i] < begin.mVal[i] ) {
+      return;
+    }
+  }
+
+  ymuint64 enabled = end.mTimeEnabled - begin.mTimeEnabled;
+  ymuint64 running = end.mTimeRunning - begin.mTimeRunning;
+  total.mTimeEnabled += enabled;
+  total.mTimeRunning += running;
+  if ( running == 0 ) {
+    return;
+  }
+  double scale = static_cast<double>(enabled) / running;
+  for (ymuint i = 0; i < kEventNum; ++ i) {
+    ymuint64 diff = end.mVal[i] - begin.mVal[i];
+    total.mVal[i] += static_cast<ymuint64>(diff * scale + 0.5);
+  }
+}
+
+// @brief イベント名を返す．
+const char*
+PerfCounter::event_name(Event event)
+{
+  switch ( event ) {
+  case kCycles:       return "cycles";
+  case kInstructions: return "instructions";
+  case kCacheMisses:  return "cache_misses";
+  case kBranchMisses: return "branch_misses";
+  default: break;
+  }
+  ASSERT_NOT_REACHED;
+  return NULL;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,154 @@
+#ifndef PERFCOUNTER_H
+#define PERFCOUNTER_H
+
+/// @file PerfCounter.h
+/// @brief PerfCounter のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class PerfCounter PerfCounter.h "PerfCounter.h"
+/// @brief ハードウェア性能カウンタを読むクラス
+///
+/// Linux の perf_event_open(2) を用いる．
+/// 自プロセスのユーザーモードのみを数える．
+/// カーネルが許可しない場合やLinux以外の環境では is_available() が
+/// false となり，read() は全て 0 を返す．
+/// イベントは cycles を先頭とする一つのグループとして開くので，
+/// 全てのイベントは同時に計数され，read() は一回の読み出しで済む．
+/// read() は補正前の値を返す．区間の値は add_interval() で求める．
+/// PMU が多重化されてグループが一部の時間しか計数されなかった時は
+/// 区間の中で有効だった時間と実際に計数した時間の比で値を補正する．
+/// グループに加えられなかったイベントは使用不可となる．
+//////////////////////////////////////////////////////////////////////
+class PerfCounter
+{
+public:
+
+  /// @brief イベントを表す列挙型
+  enum Event {
+    /// @brief CPU サイクル数
+    kCycles,
+    /// @brief 実行命令数
+    kInstructions,
+    /// @brief キャッシュミス数 (最終レベルキャッシュ)
+    kCacheMisses,
+    /// @brief 分岐予測ミス数
+    kBranchMisses,
+    /// @brief 個数
+    kEventNum
+  };
+
+  /// @brief 読み出した値
+  struct Values
+  {
+    /// @brief コンストラクタ
+    ///
+    /// 全て 0 に初期化する．
+    Values();
+
+    /// @brief 各イベントの値
+    ///
+    /// read() の値は補正前，add_interval() の値は補正済みである．
+    ymuint64 mVal[kEventNum];
+
+    /// @brief グループが有効だった時間 (ナノ秒)
+    ymuint64 mTimeEnabled;
+
+    /// @brief グループが実際に計数していた時間 (ナノ秒)
+    ymuint64 mTimeRunning;
+  };
+
+
+public:
+
+  /// @brief コンストラクタ
+  ///
+  /// ここでカウンタを開いて計数を開始する．
+  PerfCounter();
+
+  /// @brief デストラクタ
+  ~PerfCounter();
+
+
+public:
+
+  /// @brief いずれかのイベントが使用可能の時 true を返す．
+  bool
+  is_available() const;
+
+  /// @brief 指定されたイベントが使用可能の時 true を返す．
+  /// @param[in] event イベント
+  bool
+  is_available(Event event) const;
+
+  /// @brief 現在の値を読み出す．
+  /// @param[out] values 値を格納する構造体
+  ///
+  /// 全てのイベントをグループの先頭から一度に読み出す．
+  /// 値は多重化の補正をしていない累積値である．
+  void
+  read(Values& values) const;
+
+  /// @brief 区間の値を足し込む．
+  /// @param[in] begin 区間の始めに read() で読んだ値
+  /// @param[in] end 区間の終わりに read() で読んだ値
+  /// @param[inout] total 補正した区間の値を足し込む構造体
+  ///
+  /// 補正前の値と時間の差を取ってから，区間で有効だった時間と
+  /// 計数した時間の比で補正する．累積値を補正してから差を取ると，
+  /// 多重化で比が変わった時に値が負になることがある．
+  /// 区間で一度も計数しなかった時は時間だけを足し込む．
+  static
+  void
+  add_interval(const Values& begin,
+	       const Values& end,
+	       Values& total);
+
+  /// @brief イベント名を返す．
+  static
+  const char*
+  event_name(Event event);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // コピーは禁止
+  //////////////////////////////////////////////////////////////////////
+
+  PerfCounter(const PerfCounter& src);
+
+  const PerfCounter&
+  operator=(const PerfCounter& src);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 各イベントのファイル記述子 (使用できない時は -1)
+  int mFd[kEventNum];
+
+  // グループの先頭のファイル記述子 (使用できない時は -1)
+  int mLeader;
+
+  // 各イベントのグループ内の位置 (使用できない時は -1)
+  int mSlot[kEventNum];
+
+  // グループ内のイベント数
+  ymuint mGroupSize;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // PERFCOUNTER_H
@@ -0,0 +1,1236 @@
+
+/// @file parser_bench.cc
+/// @brief 構文解析表生成のベンチマーク
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+///
+/// Google Benchmark を用いる．
+/// 各ケースについて以下のカウンタを出力する．
+/// - t_<phase>     フェーズごとの実行時間(秒/反復)
+/// - a_<phase>     フェーズごとのメモリ確保回数(回/反復)
+/// - allocs        全体のメモリ確保回数(回/反復)
+/// - alloc_bytes   全体のメモリ確保量(バイト/反復)
+/// - states, items, prop_edges, lookaheads, conflicts
+///
+/// perf_event_open(2) が使える場合には以下も出力する．
+/// - <event>_<phase> フェーズごとのハードウェアカウンタの値(回/反復)
+///                   closure は他のフェーズの内側で呼び出しごとに
+///                   計測されるので，その値は外側のフェーズにも含まれる．
+/// - <event>         計測区間全体のハードウェアカウンタの値(回/反復)
+/// - ipc             計測区間全体の instructions / cycles
+/// - perf_running    計測区間でカウンタが PMU に載っていた時間の割合
+///                   1 未満の時は多重化されており，値は補正されている．
+/// <event> は cycles, instructions, cache_misses, branch_misses のいずれか．
+/// カーネルの設定で使えない場合は /proc/sys/kernel/perf_event_paranoid
+/// の値を 2 以下にする必要がある．
+///
+/// 既定では数分以内に全てのケースが終わる大きさに限る．環境変数
+/// PARSER_BENCH_LARGE を設定すると BM_SynthRules の大きな文法
+/// (lr0 は 512 規則，lalr1 は 256 規則まで) も計測する．
+
+
+#include "BenchGrammer.h"
+#include "../src/Grammer.h"
+#include "../src/LR0Set.h"
+#include "../src/LALR1Set.h"
+#include "../src/BuildStats.h"
+#include "../src/SentenceGen.h"
+#include "../src/ParseTable.h"
+#include "../src/LRParser.h"
+#include "../src/PackedParser.h"
+#include "../src/GLRParser.h"
+#include "../src/IncrParser.h"
+#include "../src/ParseProfile.h"
+#include "../src/Token.h"
+#include "../src/Lexer.h"
+#include "../src/MappedFile.h"
+#include "PerfCounter.h"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+
+
+//////////////////////////////////////////////////////////////////////
+// メモリ確保の回数を数えるための operator new/delete
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// メモリ確保の回数
+unsigned long long gAllocNum = 0;
+
+// メモリ確保の量
+unsigned long long gAllocBytes = 0;
+
+// 確保した回数と量を記録して malloc() で確保する．
+// 失敗した時は NULL を返す．
+// 置き換えた operator delete から見えないようにインライン展開しない．
+__attribute__((noinline))
+void*
+count_alloc(std::size_t size)
+{
+  ++ gAllocNum;
+  gAllocBytes += size;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+// count_alloc() で確保した領域を解放する．
+__attribute__((noinline))
+void
+count_free(void* p)
+{
+  std::free(p);
+}
+
+// count_alloc() で確保し，失敗した時は std::bad_alloc を投げる．
+void*
+count_alloc_or_throw(std::size_t size)
+{
+  void* p = count_alloc(size);
+  if ( p == NULL ) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+}
+
+// 配列と std::nothrow の形も置き換えて同じように数える．
+// 解放は大きさつきの形も含めて全て count_free() で行う．
+
+void*
+operator new(std::size_t size)
+{
+  return count_alloc_or_throw(size);
+}
+
+void*
+operator new[](std::size_t size)
+{
+  return count_alloc_or_throw(size);
+}
+
+void*
+operator new(std::size_t size,
+	     const std::nothrow_t&) noexcept
+{
+  return count_alloc(size);
+}
+
+void*
+operator new[](std::size_t size,
+	       const std::nothrow_t&) noexcept
+{
+  return count_alloc(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+  count_free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+  count_free(p);
+}
+
+void
+operator delete(void* p,
+		std::size_t size) noexcept
+{
+  count_free(p);
+}
+
+void
+operator delete[](void* p,
+		  std::size_t size) noexcept
+{
+  count_free(p);
+}
+
+void
+operator delete(void* p,
+		const std::nothrow_t&) noexcept
+{
+  count_free(p);
+}
+
+void
+operator delete[](void* p,
+		  const std::nothrow_t&) noexcept
+{
+  count_free(p);
+}
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+// フェーズごとにメモリ確保の回数とハードウェアカウンタの値を
+// 集計する PhaseListener
+//////////////////////////////////////////////////////////////////////
+class PhaseRecorder :
+  public PhaseListener
+{
+public:
+
+  // コンストラクタ
+  // perf が NULL の時はハードウェアカウンタは集計しない．
+  PhaseRecorder(const PerfCounter* perf) :
+    mPerf(perf)
+  {
+    for (ymuint i = 0; i < BuildStats::kPhaseNum; ++ i) {
+      mBegin[i] = 0;
+      mTotal[i] = 0;
+    }
+  }
+
+  // フェーズの開始
+  //
+  // closure は他のフェーズの内側で closure() の呼び出しごとに
+  // 通知されるので，値は外側のフェーズにも含まれる．
+  // カウンタはユーザーモードだけを数えるので，読み出しのシステム
+  // コールは外側のフェーズの値にはほとんど加わらない．
+  virtual
+  void
+  phase_begin(BuildStats::Phase phase)
+  {
+    if ( mPerf != NULL ) {
+      mPerf->read(mPerfBegin[phase]);
+    }
+    mBegin[phase] = gAllocNum;
+  }
+
+  // フェーズの終了
+  virtual
+  void
+  phase_end(BuildStats::Phase phase)
+  {
+    mTotal[phase] += gAllocNum - mBegin[phase];
+    if ( mPerf != NULL ) {
+      PerfCounter::Values end;
+      mPerf->read(end);
+      PerfCounter::add_interval(mPerfBegin[phase], end, mPerfTotal[phase]);
+    }
+  }
+
+  // メモリ確保回数の累積値を返す．
+  ymuint64
+  total(BuildStats::Phase phase) const
+  {
+    return mTotal[phase];
+  }
+
+  // ハードウェアカウンタの累積値を返す．
+  ymuint64
+  perf_total(BuildStats::Phase phase,
+	     PerfCounter::Event event) const
+  {
+    return mPerfTotal[phase].mVal[event];
+  }
+
+private:
+
+  // ハードウェアカウンタ
+  const PerfCounter* mPerf;
+
+  // フェーズの開始時の値
+  ymuint64 mBegin[BuildStats::kPhaseNum];
+
+  // 累積値
+  ymuint64 mTotal[BuildStats::kPhaseNum];
+
+  // フェーズの開始時のハードウェアカウンタの値
+  PerfCounter::Values mPerfBegin[BuildStats::kPhaseNum];
+
+  // ハードウェアカウンタの累積値
+  PerfCounter::Values mPerfTotal[BuildStats::kPhaseNum];
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// スコープの間 cerr への出力を捨てるクラス
+//
+// 人工的な文法では衝突の警告が大量に出力されるため．
+//////////////////////////////////////////////////////////////////////
+class CerrSilencer
+{
+public:
+
+  // コンストラクタ
+  CerrSilencer() :
+    mOrig(cerr.rdbuf(NULL))
+  {
+  }
+
+  // デストラクタ
+  ~CerrSilencer()
+  {
+    cerr.rdbuf(mOrig);
+    cerr.clear();
+  }
+
+private:
+
+  // 元の streambuf
+  streambuf* mOrig;
+
+};
+
+
+// 計測の対象
+enum Stage {
+  // Grammer::analyze()
+  kStageAnalyze,
+  // LR0Set
+  kStageLR0,
+  // LALR1Set
+  kStageLALR1
+};
+
+// 文法の指定
+// test_id が 0 の時は param を用いる．
+struct GrammerSpec
+{
+  ymuint test_id;
+  SynthParam param;
+};
+
+// 文法を作る．
+Token*
+make_grammer(const GrammerSpec& spec,
+	     Grammer& g)
+{
+  if ( spec.test_id > 0 ) {
+    return make_test_grammer(spec.test_id, g);
+  }
+  return make_synth_grammer(spec.param, g);
+}
+
+// 結果をカウンタに記録する．
+void
+set_counters(benchmark::State& st,
+	     const BuildStats& stats,
+	     const PhaseRecorder& listener,
+	     ymuint64 alloc_num,
+	     ymuint64 alloc_bytes,
+	     const PerfCounter& perf,
+	     const PerfCounter::Values& perf_total)
+{
+  for (ymuint i = 0; i < BuildStats::kPhaseNum; ++ i) {
+    BuildStats::Phase phase = static_cast<BuildStats::Phase>(i);
+    string name = BuildStats::phase_name(phase);
+    st.counters["t_" + name] =
+      benchmark::Counter(stats.time(phase).real_time(),
+			 benchmark::Counter::kAvgIterations);
+    st.counters["a_" + name] =
+      benchmark::Counter(static_cast<double>(listener.total(phase)),
+			 benchmark::Counter::kAvgIterations);
+  }
+  st.counters["allocs"] =
+    benchmark::Counter(static_cast<double>(alloc_num),
+		       benchmark::Counter::kAvgIterations);
+  st.counters["alloc_bytes"] =
+    benchmark::Counter(static_cast<double>(alloc_bytes),
+		       benchmark::Counter::kAvgIterations);
+  st.counters["states"] = stats.count(BuildStats::kStateNum);
+  st.counters["items"] = stats.count(BuildStats::kItemNum);
+  st.counters["prop_edges"] = stats.count(BuildStats::kPropEdgeNum);
+  st.counters["lookaheads"] = stats.count(BuildStats::kLookaheadNum);
+  st.counters["conflicts"] =
+    benchmark::Counter(static_cast<double>(stats.count(BuildStats::kConflictNum)),
+		       benchmark::Counter::kAvgIterations);
+
+  if ( !perf.is_available() ) {
+    return;
+  }
+  for (ymuint j = 0; j < PerfCounter::kEventNum; ++ j) {
+    PerfCounter::Event event = static_cast<PerfCounter::Event>(j);
+    if ( !perf.is_available(event) ) {
+      continue;
+    }
+    string ename = PerfCounter::event_name(event);
+    for (ymuint i = 0; i < BuildStats::kPhaseNum; ++ i) {
+      BuildStats::Phase phase = static_cast<BuildStats::Phase>(i);
+      string name = ename + "_" + BuildStats::phase_name(phase);
+      st.counters[name] =
+	benchmark::Counter(static_cast<double>(listener.perf_total(phase, event)),
+			   benchmark::Counter::kAvgIterations);
+    }
+    st.counters[ename] =
+      benchmark::Counter(static_cast<double>(perf_total.mVal[event]),
+			 benchmark::Counter::kAvgIterations);
+  }
+  ymuint64 cycles = perf_total.mVal[PerfCounter::kCycles];
+  if ( perf.is_available(PerfCounter::kInstructions) && cycles > 0 ) {
+    st.counters["ipc"] =
+      static_cast<double>(perf_total.mVal[PerfCounter::kInstructions]) / cycles;
+  }
+  if ( perf_total.mTimeEnabled > 0 ) {
+    st.counters["perf_running"] =
+      static_cast<double>(perf_total.mTimeRunning) / perf_total.mTimeEnabled;
+  }
+}
+
+// 指定された段階の処理時間を計測する．
+void
+run_stage(benchmark::State& st,
+	  const GrammerSpec& spec,
+	  Stage stage)
+{
+  CerrSilencer silencer;
+
+  PerfCounter perf;
+  BuildStats stats;
+  PhaseRecorder listener(perf.is_available() ? &perf : NULL);
+  stats.set_listener(&listener);
+
+  ymuint64 alloc_num = 0;
+  ymuint64 alloc_bytes = 0;
+  PerfCounter::Values perf_total;
+  PerfCounter::Values perf0;
+  PerfCounter::Values perf1;
+
+  if ( stage == kStageAnalyze ) {
+    // analyze() は一度しか呼べないので毎回文法を作り直す．
+    while ( st.KeepRunning() ) {
+      st.PauseTiming();
+      Grammer* g = new Grammer;
+      Token* start = make_grammer(spec, *g);
+      st.ResumeTiming();
+
+      ymuint64 num0 = gAllocNum;
+      ymuint64 bytes0 = gAllocBytes;
+      perf.read(perf0);
+      g->set_start(start, &stats);
+      perf.read(perf1);
+      alloc_num += gAllocNum - num0;
+      alloc_bytes += gAllocBytes - bytes0;
+      PerfCounter::add_interval(perf0, perf1, perf_total);
+
+      st.PauseTiming();
+      delete g;
+      st.ResumeTiming();
+    }
+  }
+  else {
+    Grammer g;
+    Token* start = make_grammer(spec, g);
+    g.set_start(start);
+    while ( st.KeepRunning() ) {
+      ymuint64 num0 = gAllocNum;
+      ymuint64 bytes0 = gAllocBytes;
+      perf.read(perf0);
+      if ( stage == kStageLR0 ) {
+	LR0Set lr0set(&g, Tracer(), &stats);
+	benchmark::DoNotOptimize(lr0set.start_state());
+      }
+      else {
+	LALR1Set lalr1set(&g, Tracer(), &stats);
+	benchmark::DoNotOptimize(lalr1set.start_state());
+      }
+      perf.read(perf1);
+      alloc_num += gAllocNum - num0;
+      alloc_bytes += gAllocBytes - bytes0;
+      PerfCounter::add_interval(perf0, perf1, perf_total);
+    }
+  }
+
+  set_counters(st, stats, listener, alloc_num, alloc_bytes,
+	       perf, perf_total);
+}
+
+// テスト用の文法
+void
+BM_TestGrammer(benchmark::State& st,
+	       Stage stage)
+{
+  GrammerSpec spec;
+  spec.test_id = st.range(0);
+  run_stage(st, spec, stage);
+}
+
+// 文法規則数を変化させる．
+void
+BM_SynthRules(benchmark::State& st,
+	      Stage stage)
+{
+  GrammerSpec spec;
+  spec.test_id = 0;
+  spec.param.rule_num = st.range(0);
+  spec.param.nonterm_num = (spec.param.rule_num + 2) / 3;
+  run_stage(st, spec, stage);
+  st.SetComplexityN(st.range(0));
+}
+
+// 大きな文法も計測する時 true を返す．
+//
+// LALR(1) 集合の構築は規則数の 3 乗程度で増え，lalr1 の 128 規則で
+// 数秒，256 規則で数分かかる．そのため既定では小さい文法に限り，
+// 環境変数 PARSER_BENCH_LARGE が設定されている時だけ大きな文法も計測する．
+bool
+large_enabled()
+{
+  return getenv("PARSER_BENCH_LARGE") != NULL;
+}
+
+// BM_SynthRules/lr0 の規則数
+void
+synth_rules_lr0(benchmark::internal::Benchmark* b)
+{
+  b->RangeMultiplier(2)->Range(16, large_enabled() ? 512 : 256);
+}
+
+// BM_SynthRules/lalr1 の規則数
+void
+synth_rules_lalr1(benchmark::internal::Benchmark* b)
+{
+  b->RangeMultiplier(2)->Range(16, large_enabled() ? 256 : 64);
+}
+
+// 終端記号数を変化させる．
+void
+BM_SynthTokens(benchmark::State& st,
+	       Stage stage)
+{
+  GrammerSpec spec;
+  spec.test_id = 0;
+  spec.param.token_num = st.range(0);
+  run_stage(st, spec, stage);
+  st.SetComplexityN(st.range(0));
+}
+
+// 右辺の最大長を変化させる．
+void
+BM_SynthRhsLen(benchmark::State& st,
+	       Stage stage)
+{
+  GrammerSpec spec;
+  spec.test_id = 0;
+  spec.param.rhs_len = st.range(0);
+  run_stage(st, spec, stage);
+  st.SetComplexityN(st.range(0));
+}
+
+// 優先順位の段数を変化させる．
+void
+BM_SynthPrec(benchmark::State& st,
+	     Stage stage)
+{
+  GrammerSpec spec;
+  spec.test_id = 0;
+  spec.param.prec_num = st.range(0);
+  run_stage(st, spec, stage);
+  st.SetComplexityN(st.range(0));
+}
+
+// 空規則を持つ非終端記号の割合を変化させる．
+void
+BM_SynthNullable(benchmark::State& st,
+		 Stage stage)
+{
+  GrammerSpec spec;
+  spec.test_id = 0;
+  spec.param.nullable_pct = st.range(0);
+  run_stage(st, spec, stage);
+}
+
+// 生成された終端記号を数えるだけの SentenceSink
+class CountSink :
+  public SentenceSink
+{
+public:
+
+  // コンストラクタ
+  CountSink() :
+    mSum(0)
+  {
+  }
+
+  // 終端記号を受け取る．
+  virtual
+  void
+  put_token(const Token* token)
+  {
+    mSum += reinterpret_cast<ymuint64>(token);
+  }
+
+  // 最適化で消されないための値
+  ymuint64 mSum;
+
+};
+
+// 文の生成速度を計測する．
+// range(0) は文法(0 なら人工的な文法)，range(1) は文の長さ
+void
+BM_SentenceGen(benchmark::State& st)
+{
+  GrammerSpec spec;
+  spec.test_id = st.range(0);
+  Grammer g;
+  Token* start = make_grammer(spec, g);
+  g.set_start(start);
+
+  SentenceGen gen(g);
+  gen.set_growth(8.0);
+  CountSink sink;
+  ymuint64 n = 0;
+  while ( st.KeepRunning() ) {
+    n += gen.generate(st.range(1), sink);
+  }
+  benchmark::DoNotOptimize(sink.mSum);
+  st.SetItemsProcessed(n);
+  st.counters["tokens"] =
+    benchmark::Counter(static_cast<double>(n),
+		       benchmark::Counter::kAvgIterations);
+}
+
+// 生成された終端記号の番号を記録する SentenceSink
+class TokenListSink :
+  public SentenceSink
+{
+public:
+
+  // 終端記号を受け取る．
+  virtual
+  void
+  put_token(const Token* token)
+  {
+    mList.push_back(token->id());
+  }
+
+  // 終端記号の番号のリスト
+  vector<ymuint> mList;
+
+};
+
+// 構文解析表の出力時間と大きさを計測する．
+// range(0) は終端記号数
+void
+BM_TableEmit(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  GrammerSpec spec;
+  spec.test_id = 0;
+  spec.param.token_num = st.range(0);
+  Grammer g;
+  Token* start = make_grammer(spec, g);
+  g.set_start(start);
+  LALR1Set lalr1set(&g);
+
+  BuildStats stats;
+  while ( st.KeepRunning() ) {
+    ParseTable table(g, lalr1set, &stats);
+    benchmark::DoNotOptimize(table.class_num());
+  }
+
+  ParseTable table(g, lalr1set);
+  st.counters["states"] = table.state_num();
+  st.counters["terminals"] = g.terminal_num();
+  st.counters["classes"] = table.class_num();
+  st.counters["action_rows"] = table.action_row_num();
+  st.counters["dense_states"] = stats.count(BuildStats::kDenseRowNum);
+  st.counters["sparse_states"] = stats.count(BuildStats::kSparseRowNum);
+  st.counters["default_states"] = stats.count(BuildStats::kDefaultRowNum);
+  st.counters["goto_exceptions"] = table.goto_exception_num();
+  st.counters["table_bytes"] = static_cast<double>(table.table_bytes());
+  PackedParser* packed = PackedParser::new_obj(table);
+  st.counters["packed_bytes"] = static_cast<double>(packed->table_bytes());
+  delete packed;
+}
+
+// 構文解析の速度を計測する．
+// range(0) は文法，range(1) は 1 文の目標の長さ
+// range(2) が 1 の時は PackedParser を，2 の時は GLRParser を用いる．
+// range(3) が 1 の時は同じ入力で記録した使用回数で状態番号をつけ直す．
+void
+BM_Parse(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  GrammerSpec spec;
+  spec.test_id = st.range(0);
+  Grammer g;
+  Token* start = make_grammer(spec, g);
+  g.set_start(start);
+  LALR1Set lalr1set(&g);
+  ParseTable table(g, lalr1set, NULL, st.range(2) == 2);
+
+  // 入力を作っておく．
+  const ymuint kCorpusSize = 100000;
+  SentenceGen gen(g);
+  gen.set_growth(8.0);
+  vector<vector<ymuint> > corpus;
+  ymuint64 corpus_tokens = 0;
+  while ( corpus_tokens < kCorpusSize ) {
+    TokenListSink sink;
+    gen.generate(st.range(1), sink);
+    corpus_tokens += sink.mList.size();
+    corpus.push_back(sink.mList);
+  }
+
+  if ( st.range(3) ) {
+    ParseProfile profile(table.state_num());
+    LRParser profile_parser(table);
+    profile_parser.set_profile(&profile);
+    for (vector<vector<ymuint> >::const_iterator p = corpus.begin();
+	 p != corpus.end(); ++ p) {
+      profile_parser.parse(*p);
+    }
+    table.reorder(profile);
+  }
+
+  LRParser parser(table);
+  PackedParser* packed = NULL;
+  if ( st.range(2) == 1 ) {
+    packed = PackedParser::new_obj(table);
+  }
+  GLRParser* glr = NULL;
+  if ( st.range(2) == 2 ) {
+    glr = new GLRParser(table);
+  }
+  PerfCounter perf;
+  PerfCounter::Values perf0;
+  PerfCounter::Values perf1;
+  PerfCounter::Values perf_total;
+  ymuint64 accepted = 0;
+  ymuint64 reduces = 0;
+  ymuint64 tokens = 0;
+  while ( st.KeepRunning() ) {
+    perf.read(perf0);
+    for (vector<vector<ymuint> >::const_iterator p = corpus.begin();
+	 p != corpus.end(); ++ p) {
+      if ( packed != NULL ) {
+	if ( packed->parse(*p) ) {
+	  ++ accepted;
+	}
+	reduces += packed->reduce_num();
+      }
+      else if ( glr != NULL ) {
+	if ( glr->parse(*p) ) {
+	  ++ accepted;
+	}
+	reduces += glr->reduce_num();
+      }
+      else {
+	if ( parser.parse(*p) ) {
+	  ++ accepted;
+	}
+	reduces += parser.reduce_num();
+      }
+    }
+    perf.read(perf1);
+    PerfCounter::add_interval(perf0, perf1, perf_total);
+    tokens += corpus_tokens;
+  }
+
+  st.SetItemsProcessed(tokens);
+  st.counters["accept_ratio"] =
+    static_cast<double>(accepted) / (st.iterations() * corpus.size());
+  if ( tokens > 0 ) {
+    st.counters["reduces_per_token"] = static_cast<double>(reduces) / tokens;
+  }
+  if ( packed != NULL ) {
+    st.counters["table_bytes"] = static_cast<double>(packed->table_bytes());
+    delete packed;
+  }
+  else {
+    st.counters["table_bytes"] = static_cast<double>(table.table_bytes());
+  }
+  delete glr;
+  for (ymuint j = 0; j < PerfCounter::kEventNum; ++ j) {
+    PerfCounter::Event event = static_cast<PerfCounter::Event>(j);
+    if ( perf.is_available(event) && tokens > 0 ) {
+      string name = string(PerfCounter::event_name(event)) + "_per_token";
+      st.counters[name] = static_cast<double>(perf_total.mVal[event]) / tokens;
+    }
+  }
+}
+
+// 名前からトークン番号を求める．
+ymuint
+find_token(const Grammer& g,
+	   const string& str)
+{
+  for (ymuint i = 0; i < g.token_num(); ++ i) {
+    if ( g.token(i)->str() == str ) {
+      return i;
+    }
+  }
+  ASSERT_NOT_REACHED;
+  return 0;
+}
+
+// 一つのトークンを置き換えた後の再解析の速度を計測する．
+// range(0) は文法，range(1) は入力の目標の長さ
+// range(2) が 1 の時は IncrParser::reparse() で，0 の時は全体を
+// IncrParser::parse() で構文解析し直す．
+// range(3) は入力の形で
+// 0: 一つの文 (長い文を生成できるのは文法 1 だけで，括弧の入れ子が
+//    長さに比例して深くなるので再解析の手間も長さに比例する)
+// 1: 短い文を括弧でくくって + でつないだ平らなリスト (文法 1 のみ．
+//    木の高さは長さの対数なので再解析の時間はほぼ一定になる)
+// 置き換えるトークンは元と同じなので入力は常に受理される．
+void
+BM_Reparse(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  GrammerSpec spec;
+  spec.test_id = st.range(0);
+  Grammer g;
+  Token* start = make_grammer(spec, g);
+  g.set_start(start);
+  LALR1Set lalr1set(&g);
+  ParseTable table(g, lalr1set, NULL);
+
+  SentenceGen gen(g);
+  gen.set_growth(8.0);
+  TokenListSink sink;
+  vector<ymuint> input;
+  if ( st.range(3) == 0 ) {
+    gen.generate(st.range(1), sink);
+    input = sink.mList;
+  }
+  else {
+    ymuint plus = find_token(g, "+");
+    ymuint lpar = find_token(g, "(");
+    ymuint rpar = find_token(g, ")");
+    while ( input.size() < static_cast<ymuint>(st.range(1)) ) {
+      sink.mList.clear();
+      gen.generate(16, sink);
+      if ( !input.empty() ) {
+	input.push_back(plus);
+      }
+      input.push_back(lpar);
+      input.insert(input.end(), sink.mList.begin(), sink.mList.end());
+      input.push_back(rpar);
+    }
+  }
+  ymuint n = input.size();
+
+  IncrParser parser(table);
+  parser.parse(input);
+  ymuint64 edits = 0;
+  ymuint64 shifts = 0;
+  ymuint64 reuses = 0;
+  ymuint64 accepted = 0;
+  ymuint pos = 0;
+  while ( st.KeepRunning() ) {
+    bool stat;
+    if ( st.range(2) ) {
+      stat = parser.reparse(input, pos, 1, 1);
+    }
+    else {
+      stat = parser.parse(input);
+    }
+    if ( stat ) {
+      ++ accepted;
+    }
+    shifts += parser.shift_num();
+    reuses += parser.reuse_num();
+    ++ edits;
+    // 位置を素数の間隔でずらす．
+    pos = (pos + 7919) % n;
+  }
+
+  st.counters["input_tokens"] = n;
+  st.counters["accept_ratio"] = static_cast<double>(accepted) / edits;
+  st.counters["shifts_per_edit"] = static_cast<double>(shifts) / edits;
+  st.counters["reuses_per_edit"] = static_cast<double>(reuses) / edits;
+}
+
+// 字句解析の速度を計測する．
+// range(0) は入力の種類で
+// 0: 長い空白 (字下げと空行) が多い
+// 1: 長い識別子が多い
+// 2: 長い注釈が多い
+// range(1) は Lexer::SimdMode (CPU で使えない時はそれより遅いものになる)
+// 入力は約 4MB で，bytes_per_second を出力する．
+void
+BM_Lex(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  Grammer g;
+  Token* id = g.add_token("id");
+  Token* num = g.add_token("num");
+  Token* op = g.add_token("op");
+  g.set_pattern(id, "[A-Za-z_][A-Za-z_0-9]*");
+  g.set_pattern(num, "[0-9]+");
+  g.set_pattern(op, "[-+*/=;(),]");
+  g.add_skip_pattern("\\s+");
+  g.add_skip_pattern("//[^\\n]*");
+  Lexer lexer(g);
+  lexer.set_simd_mode(static_cast<Lexer::SimdMode>(st.range(1)));
+
+  // 擬似乱数で長さを変えながら入力を作る．
+  string text;
+  ymuint32 seed = 12345;
+  const ymuint size = 4 * 1024 * 1024;
+  while ( text.size() < size ) {
+    seed = seed * 1103515245U + 12345U;
+    ymuint r = (seed >> 8) & 0xFFFF;
+    switch ( st.range(0) ) {
+    case 0:
+      text += "\n" + string(8 + r % 120, ' ') + "x = 1;\n\n\t\n";
+      break;
+    case 1:
+      text += string(1, 'a' + r % 26) + string(8 + r % 56, 'q') + "_0 ";
+      break;
+    case 2:
+      text += "y; // " + string(16 + r % 240, 'c') + "\n";
+      break;
+    }
+  }
+
+  ymuint64 tokens = 0;
+  ymuint64 scanned = 0;
+  vector<ymuint> token_list;
+  token_list.reserve(size);
+  while ( st.KeepRunning() ) {
+    token_list.clear();
+    scanned += lexer.scan(text.c_str(), text.size(), token_list);
+    tokens += token_list.size();
+  }
+
+  st.SetBytesProcessed(scanned);
+  st.counters["simd_mode"] = lexer.simd_mode();
+  st.counters["run_states"] = lexer.run_state_num();
+  st.counters["tokens"] = benchmark::Counter(tokens, benchmark::Counter::kIsRate);
+}
+
+// キーワードの多い字句解析の速度を計測する．
+// range(0) が 1 の時はキーワードを DFA から除いて完全ハッシュで見分け，
+// 0 の時は DFA に含める．
+// 入力は約 4MB で，半分がキーワード，残りが識別子である．
+void
+BM_LexKeyword(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  const char* kw_list[] = {
+    "always", "and", "assign", "begin", "buf", "bufif0", "bufif1", "case",
+    "casex", "casez", "cmos", "deassign", "default", "defparam", "disable",
+    "edge", "else", "end", "endcase", "endfunction", "endmodule",
+    "endprimitive", "endspecify", "endtable", "endtask", "event", "for",
+    "force", "forever", "fork", "function", "highz0", "highz1", "if",
+    "ifnone", "initial", "inout", "input", "integer", "join", "large",
+    "macromodule", "medium", "module", "nand", "negedge", "nmos", "nor",
+    "not", "notif0", "notif1", "or", "output", "parameter", "pmos",
+    "posedge", "primitive", "pull0", "pull1", "pulldown", "pullup",
+    "rcmos", "real", "realtime", "reg", "release", "repeat", "rnmos",
+    "rpmos", "rtran", "rtranif0", "rtranif1", "scalared", "small",
+    "specify", "specparam", "strong0", "strong1", "supply0", "supply1",
+    "table", "task", "time", "tran", "tranif0", "tranif1", "tri", "tri0",
+    "tri1", "triand", "trior", "trireg", "vectored", "wait", "wand",
+    "weak0", "weak1", "while", "wire", "wor", "xnor", "xor", NULL
+  };
+  Grammer g;
+  ymuint kw_num = 0;
+  for ( ; kw_list[kw_num] != NULL; ++ kw_num) {
+    Token* kw = g.add_token(kw_list[kw_num]);
+    g.set_pattern(kw, kw_list[kw_num]);
+  }
+  Token* id = g.add_token("id");
+  g.set_pattern(id, "[A-Za-z_][A-Za-z_0-9]*");
+  g.add_skip_pattern("\\s+");
+  Lexer lexer(g, st.range(0) != 0);
+
+  string text;
+  ymuint32 seed = 12345;
+  while ( text.size() < 4 * 1024 * 1024 ) {
+    seed = seed * 1103515245U + 12345U;
+    ymuint r = (seed >> 8) & 0xFFFF;
+    text += kw_list[r % kw_num];
+    if ( r & 0x8000 ) {
+      text += "_q";
+    }
+    text += " ";
+  }
+
+  ymuint64 scanned = 0;
+  ymuint64 tokens = 0;
+  vector<ymuint> token_list;
+  while ( st.KeepRunning() ) {
+    token_list.clear();
+    scanned += lexer.scan(text.c_str(), text.size(), token_list);
+    tokens += token_list.size();
+  }
+
+  st.SetBytesProcessed(scanned);
+  st.counters["states"] = lexer.state_num();
+  st.counters["keywords"] = lexer.keyword_num();
+  st.counters["table_bytes"] = static_cast<double>(lexer.table_bytes());
+  st.counters["tokens"] = benchmark::Counter(tokens, benchmark::Counter::kIsRate);
+}
+
+// ファイルを読んで字句ごとの文字列を得るまでの速度を計測する．
+// range(0) は読み方で
+// 0: ifstream で string に読み込み，字句を string に複写する
+// 1: MappedFile で写像し，字句は StrView で指す
+// 2: 1 に kHugePage と kPopulate を加える
+// 入力は約 16MB の識別子と数字と空白の列である．
+void
+BM_LexFile(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  Grammer g;
+  Token* id = g.add_token("id");
+  Token* num = g.add_token("num");
+  g.set_pattern(id, "[A-Za-z_][A-Za-z_0-9]*");
+  g.set_pattern(num, "[0-9]+");
+  g.add_skip_pattern("\\s+");
+  Lexer lexer(g);
+
+  const char* filename = "parser_bench.lex";
+  {
+    ofstream out(filename, ios::binary);
+    ymuint32 seed = 12345;
+    ymuint64 size = 0;
+    while ( size < 16 * 1024 * 1024 ) {
+      seed = seed * 1103515245U + 12345U;
+      ymuint r = (seed >> 8) & 0xFFFF;
+      string word = r % 4 == 0 ? "42 " : string(1, 'a' + r % 26) + string(r % 12, 'x') + "\n";
+      out << word;
+      size += word.size();
+    }
+  }
+
+  ymuint64 bytes = 0;
+  ymuint64 tokens = 0;
+  ymuint64 alloc_begin = gAllocNum;
+  vector<ymuint> token_list;
+  vector<string> str_list;
+  vector<StrView> view_list;
+  while ( st.KeepRunning() ) {
+    token_list.clear();
+    if ( st.range(0) == 0 ) {
+      str_list.clear();
+      ifstream in(filename, ios::binary);
+      string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+      const char* pos = text.c_str();
+      const char* end = pos + text.size();
+      for ( ; ; ) {
+	const char* start;
+	ymuint token = lexer.next_token(pos, end, start);
+	if ( token == Grammer::kEnd || token == Lexer::kNoToken ) {
+	  break;
+	}
+	token_list.push_back(token);
+	str_list.push_back(string(start, pos - start));
+      }
+      bytes += text.size();
+    }
+    else {
+      view_list.clear();
+      ymuint flags = MappedFile::kSequential;
+      if ( st.range(0) == 2 ) {
+	flags |= MappedFile::kHugePage | MappedFile::kPopulate;
+      }
+      MappedFile file;
+      file.open(filename, flags);
+      lexer.scan(file.data(), file.size(), token_list, view_list);
+      bytes += file.size();
+    }
+    tokens += token_list.size();
+  }
+  ymuint64 allocs = gAllocNum - alloc_begin;
+  remove(filename);
+
+  st.SetBytesProcessed(bytes);
+  st.counters["allocs"] = static_cast<double>(allocs) / st.iterations();
+  st.counters["tokens"] = static_cast<double>(tokens) / st.iterations();
+}
+
+// 字句解析と構文解析をつないだ速度を計測する．
+// range(0) は読み方で
+// 0: 全体を字句解析してから構文解析する
+// 1: 構文解析器の状態で受け付けるトークンだけを読む
+// 文は "get id ;" か "id = id ;" で，入力は約 4MB である．
+// 0 では get と同じ綴りの識別子は get になるので，そういう識別子は
+// 入力に含めない．
+void
+BM_LexContext(benchmark::State& st)
+{
+  CerrSilencer silencer;
+
+  Grammer g;
+  Token* get = g.add_token("get");
+  Token* id = g.add_token("id");
+  Token* semi = g.add_token(";");
+  Token* eq = g.add_token("=");
+  g.set_pattern(get, "get");
+  g.set_pattern(id, "[a-z]+");
+  g.set_pattern(semi, ";");
+  g.set_pattern(eq, "=");
+  g.add_skip_pattern("\\s+");
+  Token* list = g.add_token("list");
+  Token* stmt = g.add_token("stmt");
+  {
+    vector<Token*> right;
+    right.push_back(list);
+    right.push_back(stmt);
+    g.add_rule(list, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(stmt);
+    g.add_rule(list, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(get);
+    right.push_back(id);
+    right.push_back(semi);
+    g.add_rule(stmt, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(id);
+    right.push_back(eq);
+    right.push_back(id);
+    right.push_back(semi);
+    g.add_rule(stmt, right);
+  }
+  g.set_start(list);
+  LALR1Set lalr1set(&g);
+  ParseTable table(g, lalr1set);
+  LRParser parser(table);
+  Lexer lexer(g);
+
+  string text;
+  ymuint32 seed = 12345;
+  while ( text.size() < 4 * 1024 * 1024 ) {
+    seed = seed * 1103515245U + 12345U;
+    ymuint r = (seed >> 8) & 0xFFFF;
+    string name = string(1, 'a' + r % 6) + string(r % 8, 'x');
+    if ( r & 0x8000 ) {
+      text += "get " + name + ";\n";
+    }
+    else {
+      text += name + " = " + name + "y;\n";
+    }
+  }
+
+  ymuint64 bytes = 0;
+  ymuint64 accepted = 0;
+  ymuint64 runs = 0;
+  vector<ymuint> token_list;
+  while ( st.KeepRunning() ) {
+    if ( st.range(0) == 0 ) {
+      token_list.clear();
+      if ( lexer.scan(text.c_str(), text.size(), token_list) == text.size() &&
+	   parser.parse(token_list) ) {
+	++ accepted;
+      }
+    }
+    else {
+      const char* pos = text.c_str();
+      const char* end = pos + text.size();
+      parser.start();
+      LRParser::PushResult result = LRParser::kNeedMore;
+      while ( result == LRParser::kNeedMore ) {
+	const char* start;
+	ymuint token = lexer.next_token(pos, end, start, parser.acceptable_tokens());
+	if ( token == Lexer::kNoToken ) {
+	  break;
+	}
+	result = parser.push(token);
+      }
+      if ( result == LRParser::kAccepted ) {
+	++ accepted;
+      }
+    }
+    bytes += text.size();
+    ++ runs;
+  }
+
+  st.SetBytesProcessed(bytes);
+  st.counters["accept_ratio"] = static_cast<double>(accepted) / runs;
+  st.counters["table_bytes"] = static_cast<double>(lexer.table_bytes() + table.table_bytes());
+}
+
+END_NONAMESPACE
+
+END_NAMESPACE_YM
+
+
+using YMTOOLS_NAMESPACE::kStageAnalyze;
+using YMTOOLS_NAMESPACE::kStageLR0;
+using YMTOOLS_NAMESPACE::kStageLALR1;
+using YMTOOLS_NAMESPACE::BM_TestGrammer;
+using YMTOOLS_NAMESPACE::BM_SynthRules;
+using YMTOOLS_NAMESPACE::synth_rules_lr0;
+using YMTOOLS_NAMESPACE::synth_rules_lalr1;
+using YMTOOLS_NAMESPACE::BM_SynthTokens;
+using YMTOOLS_NAMESPACE::BM_SynthRhsLen;
+using YMTOOLS_NAMESPACE::BM_SynthPrec;
+using YMTOOLS_NAMESPACE::BM_SynthNullable;
+using YMTOOLS_NAMESPACE::BM_SentenceGen;
+using YMTOOLS_NAMESPACE::BM_TableEmit;
+using YMTOOLS_NAMESPACE::BM_Parse;
+using YMTOOLS_NAMESPACE::BM_Reparse;
+using YMTOOLS_NAMESPACE::BM_Lex;
+using YMTOOLS_NAMESPACE::BM_LexKeyword;
+using YMTOOLS_NAMESPACE::BM_LexFile;
+using YMTOOLS_NAMESPACE::BM_LexContext;
+
+BENCHMARK_CAPTURE(BM_TestGrammer, analyze, kStageAnalyze)->DenseRange(1, 3);
+BENCHMARK_CAPTURE(BM_TestGrammer, lr0, kStageLR0)->DenseRange(1, 3);
+BENCHMARK_CAPTURE(BM_TestGrammer, lalr1, kStageLALR1)->DenseRange(1, 3);
+
+BENCHMARK_CAPTURE(BM_SynthRules, analyze, kStageAnalyze)
+->RangeMultiplier(2)->Range(16, 512)->Complexity();
+BENCHMARK_CAPTURE(BM_SynthRules, lr0, kStageLR0)
+->Apply(synth_rules_lr0)->Complexity();
+BENCHMARK_CAPTURE(BM_SynthRules, lalr1, kStageLALR1)
+->Apply(synth_rules_lalr1)->Complexity();
+
+BENCHMARK_CAPTURE(BM_SynthTokens, lalr1, kStageLALR1)
+->RangeMultiplier(2)->Range(8, 256)->Complexity();
+
+BENCHMARK_CAPTURE(BM_SynthRhsLen, lalr1, kStageLALR1)
+->DenseRange(1, 8)->Complexity();
+
+BENCHMARK_CAPTURE(BM_SynthPrec, lalr1, kStageLALR1)
+->DenseRange(0, 16, 4);
+
+BENCHMARK_CAPTURE(BM_SynthNullable, lalr1, kStageLALR1)
+->DenseRange(0, 50, 10);
+
+BENCHMARK(BM_SentenceGen)
+->ArgsProduct({{0, 1, 2, 3}, {1000, 100000}});
+
+BENCHMARK(BM_TableEmit)
+->RangeMultiplier(2)->Range(8, 256);
+
+BENCHMARK(BM_Parse)
+->ArgsProduct({{1, 2, 3}, {16, 1000}, {0, 1, 2}, {0, 1}});
+
+BENCHMARK(BM_Reparse)
+->ArgsProduct({{1}, {1000, 10000, 100000}, {0, 1}, {0, 1}});
+
+BENCHMARK(BM_Lex)
+->ArgsProduct({{0, 1, 2}, {0, 1, 2}});
+
+BENCHMARK(BM_LexKeyword)
+->DenseRange(0, 1);
+
+BENCHMARK(BM_LexFile)
+->DenseRange(0, 2);
+
+BENCHMARK(BM_LexContext)
+->DenseRange(0, 1);
+
+BENCHMARK_MAIN();
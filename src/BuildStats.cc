@@ -0,0 +1,286 @@
+
+/// @file BuildStats.cc
+/// @brief BuildStats の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "BuildStats.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// クラス BuildStats
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+BuildStats::BuildStats() :
+  mListener(NULL)
+{
+  clear();
+}
+
+// @brief デストラクタ
+BuildStats::~BuildStats()
+{
+}
+
+// @brief 内容をクリアする．
+void
+BuildStats::clear()
+{
+  for (ymuint i = 0; i < kPhaseNum; ++ i) {
+    mTimer[i].reset();
+  }
+  for (ymuint i = 0; i < kCountNum; ++ i) {
+    mCount[i] = 0;
+  }
+  for (ymuint i = 0; i < kMemNum; ++ i) {
+    mPeak[i] = 0;
+  }
+}
+
+// @brief フェーズの開始/終了を通知するリスナを設定する．
+// @param[in] listener リスナ (NULL で解除)
+void
+BuildStats::set_listener(PhaseListener* listener)
+{
+  mListener = listener;
+}
+
+// @brief フェーズの計時を開始する．
+// @param[in] phase フェーズ
+void
+BuildStats::start(Phase phase)
+{
+  ASSERT_COND( phase < kPhaseNum );
+  if ( mListener != NULL ) {
+    mListener->phase_begin(phase);
+  }
+  mTimer[phase].start();
+}
+
+// @brief フェーズの計時を終了する．
+// @param[in] phase フェーズ
+void
+BuildStats::stop(Phase phase)
+{
+  ASSERT_COND( phase < kPhaseNum );
+  mTimer[phase].stop();
+  if ( mListener != NULL ) {
+    mListener->phase_end(phase);
+  }
+}
+
+// @brief 個数を設定する．
+// @param[in] cnt 個数の種類
+// @param[in] val 値
+void
+BuildStats::set_count(Count cnt,
+		      ymuint64 val)
+{
+  ASSERT_COND( cnt < kCountNum );
+  mCount[cnt] = val;
+}
+
+// @brief 個数を足す．
+// @param[in] cnt 個数の種類
+// @param[in] val 値
+void
+BuildStats::add_count(Count cnt,
+		      ymuint64 val)
+{
+  ASSERT_COND( cnt < kCountNum );
+  mCount[cnt] += val;
+}
+
+// @brief データ構造の使用量を記録する．
+// @param[in] mem データ構造の種類
+// @param[in] bytes 現在の使用量(バイト)
+void
+BuildStats::update_peak(Mem mem,
+			ymuint64 bytes)
+{
+  ASSERT_COND( mem < kMemNum );
+  if ( mPeak[mem] < bytes ) {
+    mPeak[mem] = bytes;
+  }
+}
+
+// @brief フェーズの実行時間を返す．
+// @param[in] phase フェーズ
+USTime
+BuildStats::time(Phase phase) const
+{
+  ASSERT_COND( phase < kPhaseNum );
+  return mTimer[phase].time();
+}
+
+// @brief 個数を返す．
+// @param[in] cnt 個数の種類
+ymuint64
+BuildStats::count(Count cnt) const
+{
+  ASSERT_COND( cnt < kCountNum );
+  return mCount[cnt];
+}
+
+// @brief データ構造の最大使用量を返す．
+// @param[in] mem データ構造の種類
+ymuint64
+BuildStats::peak_bytes(Mem mem) const
+{
+  ASSERT_COND( mem < kMemNum );
+  return mPeak[mem];
+}
+
+// @brief 設定されているリスナを返す．
+PhaseListener*
+BuildStats::listener() const
+{
+  return mListener;
+}
+
+// @brief 内容を読みやすい形で出力する．
+// @param[in] s 出力先のストリーム
+void
+BuildStats::print(ostream& s) const
+{
+  s << "Phases (real / user / system sec)" << endl;
+  for (ymuint i = 0; i < kPhaseNum; ++ i) {
+    Phase phase = static_cast<Phase>(i);
+    USTime t = time(phase);
+    s << "  " << phase_name(phase) << ": "
+      << t.real_time() << " / "
+      << t.usr_time() << " / "
+      << t.sys_time() << endl;
+  }
+  s << "Counts" << endl;
+  for (ymuint i = 0; i < kCountNum; ++ i) {
+    Count cnt = static_cast<Count>(i);
+    s << "  " << count_name(cnt) << ": " << count(cnt) << endl;
+  }
+  s << "Peak bytes" << endl;
+  for (ymuint i = 0; i < kMemNum; ++ i) {
+    Mem mem = static_cast<Mem>(i);
+    s << "  " << mem_name(mem) << ": " << peak_bytes(mem) << endl;
+  }
+  s << endl;
+}
+
+// @brief 内容を JSON 形式で出力する．
+// @param[in] s 出力先のストリーム
+void
+BuildStats::dump_json(ostream& s) const
+{
+  s << "{" << endl;
+  s << "  \"phases\": {" << endl;
+  for (ymuint i = 0; i < kPhaseNum; ++ i) {
+    Phase phase = static_cast<Phase>(i);
+    USTime t = time(phase);
+    s << "    \"" << phase_name(phase) << "\": {"
+      << "\"real\": " << t.real_time() << ", "
+      << "\"user\": " << t.usr_time() << ", "
+      << "\"system\": " << t.sys_time() << "}";
+    if ( i < kPhaseNum - 1 ) {
+      s << ",";
+    }
+    s << endl;
+  }
+  s << "  }," << endl;
+  s << "  \"counts\": {" << endl;
+  for (ymuint i = 0; i < kCountNum; ++ i) {
+    Count cnt = static_cast<Count>(i);
+    s << "    \"" << count_name(cnt) << "\": " << count(cnt);
+    if ( i < kCountNum - 1 ) {
+      s << ",";
+    }
+    s << endl;
+  }
+  s << "  }," << endl;
+  s << "  \"peak_bytes\": {" << endl;
+  for (ymuint i = 0; i < kMemNum; ++ i) {
+    Mem mem = static_cast<Mem>(i);
+    s << "    \"" << mem_name(mem) << "\": " << peak_bytes(mem);
+    if ( i < kMemNum - 1 ) {
+      s << ",";
+    }
+    s << endl;
+  }
+  s << "  }" << endl;
+  s << "}" << endl;
+}
+
+// @brief フェーズ名を返す．
+const char*
+BuildStats::phase_name(Phase phase)
+{
+  switch ( phase ) {
+  case kAnalyze:     return "analyze";
+  case kLR0:         return "lr0";
+  case kClosure:     return "closure";
+  case kGeneration:  return "generation";
+  case kPropagation: return "propagation";
+  case kAction:      return "action";
+  case kEmit:        return "emit";
+  default: break;
+  }
+  ASSERT_NOT_REACHED;
+  return NULL;
+}
+
+// @brief 個数の名前を返す．
+const char*
+BuildStats::count_name(Count cnt)
+{
+  switch ( cnt ) {
+  case kTokenNum:      return "tokens";
+  case kRuleNum:       return "rules";
+  case kStateNum:      return "states";
+  case kItemNum:       return "items";
+  case kTransitionNum: return "transitions";
+  case kClosureNum:    return "closures";
+  case kPropEdgeNum:   return "propagation_edges";
+  case kLookaheadNum:  return "lookahead_pairs";
+  case kShiftNum:      return "shift_actions";
+  case kReduceNum:     return "reduce_actions";
+  case kConflictNum:   return "conflicts";
+  case kUnitBypassNum: return "unit_bypasses";
+  case kShiftReduceNum: return "shift_reduce_actions";
+  case kDroppedStateNum: return "dropped_states";
+  case kClassNum:      return "terminal_classes";
+  case kActionRowNum:  return "action_rows";
+  case kDenseRowNum:   return "dense_states";
+  case kSparseRowNum:  return "sparse_states";
+  case kDefaultRowNum: return "default_states";
+  case kGotoExcNum:    return "goto_exceptions";
+  default: break;
+  }
+  ASSERT_NOT_REACHED;
+  return NULL;
+}
+
+// @brief データ構造の名前を返す．
+const char*
+BuildStats::mem_name(Mem mem)
+{
+  switch ( mem ) {
+  case kMemFirstFollow: return "first_follow";
+  case kMemStates:      return "states";
+  case kMemTransitions: return "transitions";
+  case kMemStateHash:   return "state_hash";
+  case kMemGeneration:  return "generation_list";
+  case kMemPropagation: return "propagation_list";
+  case kMemLookahead:   return "lookahead_list";
+  case kMemAction:      return "action_table";
+  case kMemParseTable:  return "parse_table";
+  default: break;
+  }
+  ASSERT_NOT_REACHED;
+  return NULL;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,396 @@
+#ifndef BUILDSTATS_H
+#define BUILDSTATS_H
+
+/// @file BuildStats.h
+/// @brief BuildStats のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include "YmUtils/StopWatch.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class PhaseListener;
+
+//////////////////////////////////////////////////////////////////////
+/// @class BuildStats BuildStats.h "BuildStats.h"
+/// @brief 構文解析表の生成に関する統計情報を表すクラス
+///
+/// Grammer::analyze(), LR0Set, LALR1Set のコンストラクタに渡すと
+/// 各フェーズの実行時間，各種の個数，データ構造ごとの最大使用量
+/// が記録される．
+//////////////////////////////////////////////////////////////////////
+class BuildStats
+{
+public:
+
+  /// @brief フェーズを表す列挙型
+  enum Phase {
+    /// @brief FIRST/FOLLOW の計算 (Grammer::analyze)
+    kAnalyze,
+    /// @brief LR(0)正準集の生成
+    kLR0,
+    /// @brief 閉包の計算 (kLR0, kGeneration の内数)
+    kClosure,
+    /// @brief 先読みの生成
+    kGeneration,
+    /// @brief 先読みの伝搬
+    kPropagation,
+    /// @brief 動作表の生成
+    kAction,
+    /// @brief 構文解析表の出力 (ParseTable)
+    kEmit,
+    /// @brief 個数
+    kPhaseNum
+  };
+
+  /// @brief 個数の種類を表す列挙型
+  enum Count {
+    /// @brief トークン数
+    kTokenNum,
+    /// @brief 文法規則数
+    kRuleNum,
+    /// @brief 状態数
+    kStateNum,
+    /// @brief 項数
+    kItemNum,
+    /// @brief 遷移数
+    kTransitionNum,
+    /// @brief 閉包の計算回数
+    kClosureNum,
+    /// @brief 先読みの伝搬の枝数
+    kPropEdgeNum,
+    /// @brief (項, 先読み) の組の数
+    kLookaheadNum,
+    /// @brief shift/goto 動作の数
+    kShiftNum,
+    /// @brief reduce 動作の数
+    kReduceNum,
+    /// @brief 衝突の数
+    kConflictNum,
+    /// @brief 単位規則の除去で置き換えた goto の数
+    kUnitBypassNum,
+    /// @brief shift-reduce 動作の数
+    kShiftReduceNum,
+    /// @brief 取り除いた状態の数
+    kDroppedStateNum,
+    /// @brief 終端記号の同値類の数
+    kClassNum,
+    /// @brief 共有後の動作表の行数
+    kActionRowNum,
+    /// @brief 密な行で表した状態の数
+    kDenseRowNum,
+    /// @brief 疎な行で表した状態の数
+    kSparseRowNum,
+    /// @brief 既定の動作だけで表した状態の数
+    kDefaultRowNum,
+    /// @brief goto 表の例外の数
+    kGotoExcNum,
+    /// @brief 個数
+    kCountNum
+  };
+
+  /// @brief データ構造の種類を表す列挙型
+  enum Mem {
+    /// @brief FIRST/FOLLOW リスト
+    kMemFirstFollow,
+    /// @brief 状態(項集合)
+    kMemStates,
+    /// @brief 状態の遷移
+    kMemTransitions,
+    /// @brief 状態のシグネチャのハッシュ表
+    kMemStateHash,
+    /// @brief 先読みの生成リスト
+    kMemGeneration,
+    /// @brief 先読みの伝搬リスト
+    kMemPropagation,
+    /// @brief 項ごとの先読みリスト
+    kMemLookahead,
+    /// @brief 動作表
+    kMemAction,
+    /// @brief 出力された構文解析表
+    kMemParseTable,
+    /// @brief 個数
+    kMemNum
+  };
+
+
+public:
+
+  /// @brief コンストラクタ
+  BuildStats();
+
+  /// @brief デストラクタ
+  ~BuildStats();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 値を記録する関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 内容をクリアする．
+  ///
+  /// リスナの設定はクリアされない．
+  void
+  clear();
+
+  /// @brief フェーズの開始/終了を通知するリスナを設定する．
+  /// @param[in] listener リスナ (NULL で解除)
+  void
+  set_listener(PhaseListener* listener);
+
+  /// @brief フェーズの計時を開始する．
+  /// @param[in] phase フェーズ
+  ///
+  /// 同じフェーズを複数回計時した場合には累積される．
+  void
+  start(Phase phase);
+
+  /// @brief フェーズの計時を終了する．
+  /// @param[in] phase フェーズ
+  void
+  stop(Phase phase);
+
+  /// @brief 個数を設定する．
+  /// @param[in] cnt 個数の種類
+  /// @param[in] val 値
+  void
+  set_count(Count cnt,
+	    ymuint64 val);
+
+  /// @brief 個数を足す．
+  /// @param[in] cnt 個数の種類
+  /// @param[in] val 値
+  void
+  add_count(Count cnt,
+	    ymuint64 val = 1);
+
+  /// @brief データ構造の使用量を記録する．
+  /// @param[in] mem データ構造の種類
+  /// @param[in] bytes 現在の使用量(バイト)
+  ///
+  /// それまでの最大値よりも大きければ更新する．
+  void
+  update_peak(Mem mem,
+	      ymuint64 bytes);
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 値を取り出す関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief フェーズの実行時間を返す．
+  /// @param[in] phase フェーズ
+  USTime
+  time(Phase phase) const;
+
+  /// @brief 個数を返す．
+  /// @param[in] cnt 個数の種類
+  ymuint64
+  count(Count cnt) const;
+
+  /// @brief データ構造の最大使用量を返す．
+  /// @param[in] mem データ構造の種類
+  ymuint64
+  peak_bytes(Mem mem) const;
+
+  /// @brief 設定されているリスナを返す．
+  PhaseListener*
+  listener() const;
+
+  /// @brief 内容を読みやすい形で出力する．
+  /// @param[in] s 出力先のストリーム
+  void
+  print(ostream& s) const;
+
+  /// @brief 内容を JSON 形式で出力する．
+  /// @param[in] s 出力先のストリーム
+  void
+  dump_json(ostream& s) const;
+
+  /// @brief フェーズ名を返す．
+  static
+  const char*
+  phase_name(Phase phase);
+
+  /// @brief 個数の名前を返す．
+  static
+  const char*
+  count_name(Count cnt);
+
+  /// @brief データ構造の名前を返す．
+  static
+  const char*
+  mem_name(Mem mem);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // フェーズごとのストップウォッチ
+  StopWatch mTimer[kPhaseNum];
+
+  // 個数
+  ymuint64 mCount[kCountNum];
+
+  // データ構造ごとの最大使用量
+  ymuint64 mPeak[kMemNum];
+
+  // フェーズの開始/終了を通知するリスナ
+  PhaseListener* mListener;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class PhaseListener BuildStats.h "BuildStats.h"
+/// @brief BuildStats のフェーズの開始/終了を受け取るクラス
+///
+/// ベンチマークなどで外部のカウンタをフェーズごとに集計するのに用いる．
+/// kClosure は他のフェーズの内側で呼ばれる．
+//////////////////////////////////////////////////////////////////////
+class PhaseListener
+{
+public:
+
+  /// @brief デストラクタ
+  virtual
+  ~PhaseListener() { }
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief フェーズの開始
+  /// @param[in] phase フェーズ
+  virtual
+  void
+  phase_begin(BuildStats::Phase phase) = 0;
+
+  /// @brief フェーズの終了
+  /// @param[in] phase フェーズ
+  virtual
+  void
+  phase_end(BuildStats::Phase phase) = 0;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class PhaseTimer BuildStats.h "BuildStats.h"
+/// @brief スコープの間フェーズの計時を行うクラス
+///
+/// stats が NULL の時は何もしない．
+//////////////////////////////////////////////////////////////////////
+class PhaseTimer
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] stats 記録先
+  /// @param[in] phase フェーズ
+  PhaseTimer(BuildStats* stats,
+	     BuildStats::Phase phase);
+
+  /// @brief デストラクタ
+  ~PhaseTimer();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief スコープの終了を待たずに計時を終了する．
+  void
+  stop();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 記録先
+  BuildStats* mStats;
+
+  // フェーズ
+  BuildStats::Phase mPhase;
+
+};
+
+
+/// @brief vector の使用量(バイト)を見積もる．
+template<typename T>
+inline
+ymuint64
+vector_bytes(const vector<T>& v)
+{
+  return sizeof(v) + static_cast<ymuint64>(v.capacity()) * sizeof(T);
+}
+
+/// @brief vector の vector の使用量(バイト)を見積もる．
+template<typename T>
+inline
+ymuint64
+vector_bytes(const vector<vector<T> >& v)
+{
+  ymuint64 ans = sizeof(v) + static_cast<ymuint64>(v.capacity() - v.size()) * sizeof(vector<T>);
+  for (typename vector<vector<T> >::const_iterator p = v.begin();
+       p != v.end(); ++ p) {
+    ans += vector_bytes(*p);
+  }
+  return ans;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] stats 記録先
+// @param[in] phase フェーズ
+inline
+PhaseTimer::PhaseTimer(BuildStats* stats,
+		       BuildStats::Phase phase) :
+  mStats(stats),
+  mPhase(phase)
+{
+  if ( mStats != NULL ) {
+    mStats->start(mPhase);
+  }
+}
+
+// @brief デストラクタ
+inline
+PhaseTimer::~PhaseTimer()
+{
+  stop();
+}
+
+// @brief スコープの終了を待たずに計時を終了する．
+inline
+void
+PhaseTimer::stop()
+{
+  if ( mStats != NULL ) {
+    mStats->stop(mPhase);
+    mStats = NULL;
+  }
+}
+
+END_NAMESPACE_YM
+
+#endif // BUILDSTATS_H
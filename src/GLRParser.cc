@@ -0,0 +1,697 @@
+
+/// @file GLRParser.cc
+/// @brief GLRParser の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "GLRParser.h"
+#include "ParseTable.h"
+#include "Grammer.h"
+#include "Rule.h"
+#include "Token.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// クラス GLRParser
+//////////////////////////////////////////////////////////////////////
+
+// 定数の定義
+const ymuint GLRParser::kNoNode;
+
+// @brief コンストラクタ
+// @param[in] table 構文解析表
+GLRParser::GLRParser(const ParseTable& table) :
+  mTable(table),
+  mStateNode(table.state_num(), kNoNode),
+  mSymbolHead(table.token_num(), kNoNode),
+  mLevel(0),
+  mToken(0),
+  mReduceNum(0),
+  mErrorPos(0),
+  mMaxWidth(0),
+  mRoot(kNoNode)
+{
+}
+
+// @brief デストラクタ
+GLRParser::~GLRParser()
+{
+}
+
+// @brief 構文解析を行う．
+// @param[in] input 入力のトークン番号の列
+// @param[in] entry 入口番号
+// @return 受理した時 true を返す．
+bool
+GLRParser::parse(const vector<ymuint>& input,
+		 ymuint entry)
+{
+  ASSERT_COND( entry < mTable.start_num() );
+
+  // 前回の索引を消す．
+  for (vector<ymuint>::iterator p = mFrontier.begin();
+       p != mFrontier.end(); ++ p) {
+    mStateNode[mNodeList[*p].mState] = kNoNode;
+  }
+  clear_symbol_head();
+  mNodeList.clear();
+  mLinkList.clear();
+  mForestList.clear();
+  mFamilyList.clear();
+  mChildList.clear();
+  mFrontier.clear();
+  mNextFrontier.clear();
+  mReduceNum = 0;
+  mMaxWidth = 1;
+  mRoot = kNoNode;
+
+  mLevel = 0;
+  mStack.clear();
+  StackEntry start;
+  start.mState = mTable.start_state(entry);
+  start.mLevel = 0;
+  start.mForest = kNoNode;
+  start.mNode = kNoNode;
+  mStack.push_back(start);
+
+  ymuint n = input.size();
+  for ( ; ; ) {
+    mToken = mLevel < n ? input[mLevel] : Grammer::kEnd;
+
+    // 枝が一つの間は線形のスタックで解析する．
+    bool shifted = false;
+    ymuint first = 0;
+    while ( !mStack.empty() && !shifted ) {
+      if ( has_conflict() ) {
+	// 写した直後は先頭の節点から reduce を始める．
+	stack_to_gss();
+	first = mFrontier.size() - 1;
+	break;
+      }
+      ymuint32 code = mTable.action(mStack.back().mState, mToken);
+      switch ( ParseTable::action_type(code) ) {
+      case ParseTable::kShift:
+	{
+	  clear_symbol_head();
+	  StackEntry entry;
+	  entry.mState = ParseTable::action_arg(code);
+	  entry.mLevel = mLevel + 1;
+	  entry.mForest = forest_node(mToken, mLevel, mLevel + 1);
+	  entry.mNode = kNoNode;
+	  mStack.push_back(entry);
+	  shifted = true;
+	}
+	break;
+
+      case ParseTable::kReduce:
+	stack_reduce(ParseTable::action_arg(code), kNoNode, mLevel);
+	break;
+
+      case ParseTable::kShiftReduce:
+	{
+	  clear_symbol_head();
+	  ymuint leaf = forest_node(mToken, mLevel, mLevel + 1);
+	  stack_reduce(ParseTable::action_arg(code), leaf, mLevel + 1);
+	  shifted = true;
+	}
+	break;
+
+      case ParseTable::kAccept:
+	mRoot = mStack.back().mForest;
+	mErrorPos = n;
+	return true;
+
+      case ParseTable::kError:
+	mErrorPos = mLevel;
+	return false;
+      }
+    }
+    if ( shifted ) {
+      ++ mLevel;
+      continue;
+    }
+
+    reduce_all(first);
+
+    if ( mToken == Grammer::kEnd ) {
+      mErrorPos = n;
+      for (vector<ymuint>::iterator p = mFrontier.begin();
+	   p != mFrontier.end(); ++ p) {
+	const Node& node = mNodeList[*p];
+	ymuint32 code = mTable.action(node.mState, Grammer::kEnd);
+	if ( ParseTable::action_type(code) == ParseTable::kAccept ) {
+	  mRoot = mLinkList[node.mLink].mForest;
+	  return true;
+	}
+      }
+      return false;
+    }
+
+    shift_all();
+    mFrontier.swap(mNextFrontier);
+    ++ mLevel;
+    if ( mFrontier.empty() ) {
+      mErrorPos = mLevel - 1;
+      return false;
+    }
+    if ( mMaxWidth < mFrontier.size() ) {
+      mMaxWidth = mFrontier.size();
+    }
+    if ( mFrontier.size() == 1 ) {
+      gss_to_stack();
+    }
+  }
+}
+
+// @brief 根から到達できる森の節点を出力する．
+// @param[in] s 出力先のストリーム
+// @param[in] grammer 構文解析表の元となった文法
+void
+GLRParser::print_forest(ostream& s,
+			const Grammer& grammer) const
+{
+  if ( mRoot == kNoNode ) {
+    return;
+  }
+
+  vector<bool> mark(mForestList.size(), false);
+  vector<ymuint> queue;
+  queue.push_back(mRoot);
+  mark[mRoot] = true;
+  for (ymuint rpos = 0; rpos < queue.size(); ++ rpos) {
+    ymuint id = queue[rpos];
+    for (ymuint fam = forest_family(id); fam != kNoNode; fam = family_next(fam)) {
+      for (ymuint i = 0; i < family_child_num(fam); ++ i) {
+	ymuint child = family_child(fam, i);
+	if ( !mark[child] ) {
+	  mark[child] = true;
+	  queue.push_back(child);
+	}
+      }
+    }
+  }
+
+  for (ymuint id = 0; id < mForestList.size(); ++ id) {
+    if ( !mark[id] ) {
+      continue;
+    }
+    s << "F#" << id << ": " << grammer.token(forest_symbol(id))->str()
+      << " [" << forest_start(id) << ", " << forest_end(id) << ")" << endl;
+    for (ymuint fam = forest_family(id); fam != kNoNode; fam = family_next(fam)) {
+      s << "  ";
+      grammer.rule(family_rule(fam))->print(s);
+      s << " :";
+      for (ymuint i = 0; i < family_child_num(fam); ++ i) {
+	s << " F#" << family_child(fam, i);
+      }
+      s << endl;
+    }
+  }
+  s << endl;
+}
+
+// @brief 線形のスタックの先頭の状態が現在の先読みで衝突を持つ時 true を返す．
+bool
+GLRParser::has_conflict() const
+{
+  ymuint state = mStack.back().mState;
+  ymuint nc = mTable.conflict_num(state);
+  for (ymuint i = 0; i < nc; ++ i) {
+    ymuint token = mTable.conflict_token(state, i);
+    if ( token >= mToken ) {
+      return token == mToken;
+    }
+  }
+  return false;
+}
+
+// @brief 線形のスタックで reduce を行う．
+// @param[in] rule 規則番号
+// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+// @param[in] end 森の節点の終了位置
+void
+GLRParser::stack_reduce(ymuint rule,
+			ymuint leaf,
+			ymuint end)
+{
+  ymuint size = mTable.rule_size(rule);
+  if ( leaf != kNoNode ) {
+    -- size;
+  }
+  ymuint sp = mStack.size() - size;
+  ymuint left = mTable.rule_left(rule);
+  const StackEntry& bottom = mStack[sp - 1];
+  ymuint next = mTable.goto_state(bottom.mState, left);
+  ASSERT_COND( next != ParseTable::kNoState );
+
+  ymuint forest = forest_node(left, bottom.mLevel, end);
+  mPathChild.clear();
+  for (ymuint i = mStack.size(); i > sp; -- i) {
+    mPathChild.push_back(mStack[i - 1].mForest);
+  }
+  add_family(forest, rule, leaf);
+  mPathChild.clear();
+  ++ mReduceNum;
+
+  mStack.resize(sp);
+  StackEntry entry;
+  entry.mState = next;
+  entry.mLevel = end;
+  entry.mForest = forest;
+  entry.mNode = kNoNode;
+  mStack.push_back(entry);
+}
+
+// @brief 線形のスタックを GSS に写す．
+//
+// GSS から戻した要素は既に節点を持つので，新しい要素だけ節点を作る．
+// 現在の位置の節点は全て mFrontier に入れ，先頭の節点を最後に置く．
+void
+GLRParser::stack_to_gss()
+{
+  ymuint n = mStack.size();
+  ymuint pos = n;
+  while ( pos > 0 && mStack[pos - 1].mNode == kNoNode ) {
+    -- pos;
+  }
+  for (ymuint i = pos; i < n; ++ i) {
+    StackEntry& entry = mStack[i];
+    ymuint id = mNodeList.size();
+    Node node;
+    node.mState = entry.mState;
+    node.mLevel = entry.mLevel;
+    node.mLink = kNoNode;
+    mNodeList.push_back(node);
+    if ( i > 0 ) {
+      add_link(id, mStack[i - 1].mNode, entry.mForest);
+    }
+    entry.mNode = id;
+  }
+
+  mFrontier.clear();
+  ymuint top = n;
+  while ( top > 0 && mStack[top - 1].mLevel == mLevel ) {
+    -- top;
+  }
+  for (ymuint i = top; i < n; ++ i) {
+    ymuint id = mStack[i].mNode;
+    mStateNode[mStack[i].mState] = id;
+    mFrontier.push_back(id);
+  }
+  mStack.clear();
+}
+
+// @brief GSS の経路が一つしかない時は線形のスタックに戻す．
+void
+GLRParser::gss_to_stack()
+{
+  ASSERT_COND( mFrontier.size() == 1 );
+
+  mStack.clear();
+  ymuint id = mFrontier[0];
+  for ( ; ; ) {
+    const Node& node = mNodeList[id];
+    StackEntry entry;
+    entry.mState = node.mState;
+    entry.mLevel = node.mLevel;
+    entry.mNode = id;
+    if ( node.mLink == kNoNode ) {
+      entry.mForest = kNoNode;
+      mStack.push_back(entry);
+      break;
+    }
+    const Link& link = mLinkList[node.mLink];
+    if ( link.mNext != kNoNode ) {
+      // 経路が複数ある．
+      mStack.clear();
+      return;
+    }
+    entry.mForest = link.mForest;
+    mStack.push_back(entry);
+    id = link.mTo;
+  }
+  reverse(mStack.begin(), mStack.end());
+
+  mStateNode[mNodeList[mFrontier[0]].mState] = kNoNode;
+  mFrontier.clear();
+}
+
+// @brief 現在の位置の reduce を全て行う．
+// @param[in] first reduce を積む最初の mFrontier 中の位置
+//
+// 新しくできた節点の reduce は new_node() を呼んだ reduce_path() で，
+// 既存の節点への新しい枝を通る reduce は redo_reductions() で積まれる．
+void
+GLRParser::reduce_all(ymuint first)
+{
+  mQueue.clear();
+  for (ymuint i = first; i < mFrontier.size(); ++ i) {
+    put_reductions(mFrontier[i], kNoNode);
+  }
+  for (ymuint rpos = 0; rpos < mQueue.size(); ++ rpos) {
+    Reduction r = mQueue[rpos];
+    walk(r.mNode, mTable.rule_size(r.mRule), r.mRule, r.mLink, kNoNode, mLevel);
+  }
+}
+
+// @brief 現在の位置の shift を全て行う．
+//
+// 衝突で捨てた動作は reduce だけなので shift は一つの節点に高々一つである．
+void
+GLRParser::shift_all()
+{
+  // mStateNode と mSymbolHead を次の位置のものにする．
+  for (vector<ymuint>::iterator p = mFrontier.begin();
+       p != mFrontier.end(); ++ p) {
+    mStateNode[mNodeList[*p].mState] = kNoNode;
+  }
+  clear_symbol_head();
+
+  mNextFrontier.clear();
+  ymuint leaf = kNoNode;
+  for (ymuint i = 0; i < mFrontier.size(); ++ i) {
+    ymuint node = mFrontier[i];
+    ymuint32 code = mTable.action(mNodeList[node].mState, mToken);
+    switch ( ParseTable::action_type(code) ) {
+    case ParseTable::kShift:
+      {
+	if ( leaf == kNoNode ) {
+	  leaf = forest_node(mToken, mLevel, mLevel + 1);
+	}
+	ymuint next = ParseTable::action_arg(code);
+	ymuint next_node = mStateNode[next];
+	if ( next_node == kNoNode ) {
+	  next_node = new_node(next, mLevel + 1);
+	}
+	add_link(next_node, node, leaf);
+      }
+      break;
+
+    case ParseTable::kShiftReduce:
+      {
+	if ( leaf == kNoNode ) {
+	  leaf = forest_node(mToken, mLevel, mLevel + 1);
+	}
+	// shift した状態は作らないので右辺の長さより一つ少なくたどる．
+	ymuint rule = ParseTable::action_arg(code);
+	walk(node, mTable.rule_size(rule) - 1, rule, kNoNode, leaf, mLevel + 1);
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+}
+
+// @brief 節点の reduce を待ち行列に積む．
+// @param[in] node 節点番号
+// @param[in] link 必ず通る枝の番号 (kNoNode なら制約なし)
+void
+GLRParser::put_reductions(ymuint node,
+			  ymuint link)
+{
+  ymuint state = mNodeList[node].mState;
+  ymuint32 code = mTable.action(state, mToken);
+  if ( ParseTable::action_type(code) == ParseTable::kReduce ) {
+    put_reduction(node, ParseTable::action_arg(code), link);
+  }
+  ymuint nc = mTable.conflict_num(state);
+  for (ymuint i = 0; i < nc; ++ i) {
+    ymuint token = mTable.conflict_token(state, i);
+    if ( token > mToken ) {
+      break;
+    }
+    if ( token == mToken ) {
+      put_reduction(node, ParseTable::action_arg(mTable.conflict_action(state, i)), link);
+    }
+  }
+}
+
+// @brief reduce を一つ待ち行列に積む．
+// @param[in] node 節点番号
+// @param[in] rule 規則番号
+// @param[in] link 必ず通る枝の番号 (kNoNode なら制約なし)
+void
+GLRParser::put_reduction(ymuint node,
+			 ymuint rule,
+			 ymuint link)
+{
+  // 空規則の reduce は枝によらないのでやり直さない．
+  if ( link != kNoNode && mTable.rule_size(rule) == 0 ) {
+    return;
+  }
+  Reduction r;
+  r.mNode = node;
+  r.mRule = rule;
+  r.mLink = link;
+  mQueue.push_back(r);
+}
+
+// @brief 新しい枝を通る reduce を現在の位置の全ての節点で積み直す．
+// @param[in] node 枝の始点の節点番号
+// @param[in] link 新しい枝の番号
+//
+// node 以外の節点からその枝に至るには現在の位置の節点への枝を
+// 通らなければならないので，そのような枝を持たない節点は除く．
+void
+GLRParser::redo_reductions(ymuint node,
+			   ymuint link)
+{
+  for (ymuint i = 0; i < mFrontier.size(); ++ i) {
+    ymuint node1 = mFrontier[i];
+    if ( node1 != node ) {
+      bool found = false;
+      for (ymuint l = mNodeList[node1].mLink; l != kNoNode; l = mLinkList[l].mNext) {
+	if ( mNodeList[mLinkList[l].mTo].mLevel == mLevel ) {
+	  found = true;
+	  break;
+	}
+      }
+      if ( !found ) {
+	continue;
+      }
+    }
+    put_reductions(node1, link);
+  }
+}
+
+// @brief 経路をたどって reduce を行う．
+// @param[in] node 現在の節点番号
+// @param[in] rest 残りの長さ
+// @param[in] rule 規則番号
+// @param[in] link 必ず通る枝の番号 (kNoNode なら制約なし)
+// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+// @param[in] end 森の節点の終了位置
+//
+// reduce_path() で節点や枝が追加されるので参照は保持しない．
+// 新しい枝は先頭に加えられるので，たどっている途中の枝のリストは
+// 変わらない．
+void
+GLRParser::walk(ymuint node,
+		ymuint rest,
+		ymuint rule,
+		ymuint link,
+		ymuint leaf,
+		ymuint end)
+{
+  if ( rest == 0 ) {
+    if ( link == kNoNode ) {
+      reduce_path(node, rule, leaf, end);
+    }
+    return;
+  }
+
+  // link は現在の位置の節点から出ているので，それより前の位置に
+  // 達するまでに通らなければならない．
+  if ( link != kNoNode && mNodeList[node].mLevel < mLevel ) {
+    return;
+  }
+
+  for (ymuint l = mNodeList[node].mLink; l != kNoNode; l = mLinkList[l].mNext) {
+    mPathChild.push_back(mLinkList[l].mForest);
+    walk(mLinkList[l].mTo, rest - 1, rule, l == link ? kNoNode : link, leaf, end);
+    mPathChild.pop_back();
+  }
+}
+
+// @brief 一つの経路に対する reduce を行う．
+// @param[in] bottom 経路の終点の節点番号
+// @param[in] rule 規則番号
+// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+// @param[in] end 森の節点の終了位置
+void
+GLRParser::reduce_path(ymuint bottom,
+		       ymuint rule,
+		       ymuint leaf,
+		       ymuint end)
+{
+  ymuint left = mTable.rule_left(rule);
+  ymuint next = mTable.goto_state(mNodeList[bottom].mState, left);
+  ASSERT_COND( next != ParseTable::kNoState );
+
+  ymuint forest = forest_node(left, mNodeList[bottom].mLevel, end);
+  add_family(forest, rule, leaf);
+  ++ mReduceNum;
+
+  // 次の位置への reduce (shift-reduce) の節点の reduce は次の位置で積まれる．
+  ymuint next_node = mStateNode[next];
+  if ( next_node == kNoNode ) {
+    next_node = new_node(next, end);
+    add_link(next_node, bottom, forest);
+    if ( end == mLevel ) {
+      put_reductions(next_node, kNoNode);
+    }
+  }
+  else {
+    ymuint new_link = add_link(next_node, bottom, forest);
+    if ( new_link != kNoNode && end == mLevel ) {
+      redo_reductions(next_node, new_link);
+    }
+  }
+}
+
+// @brief 節点を作る．
+// @param[in] state 状態番号
+// @param[in] level 入力の位置
+ymuint
+GLRParser::new_node(ymuint state,
+		    ymuint level)
+{
+  ymuint id = mNodeList.size();
+  Node node;
+  node.mState = state;
+  node.mLevel = level;
+  node.mLink = kNoNode;
+  mNodeList.push_back(node);
+  mStateNode[state] = id;
+  if ( level == mLevel ) {
+    mFrontier.push_back(id);
+  }
+  else {
+    mNextFrontier.push_back(id);
+  }
+  return id;
+}
+
+// @brief 枝を加える．
+// @param[in] from 始点の節点番号
+// @param[in] to 行き先の節点番号
+// @param[in] forest 森の節点番号
+// @return 新しい枝の番号を返す．既にあった時は kNoNode を返す．
+ymuint
+GLRParser::add_link(ymuint from,
+		    ymuint to,
+		    ymuint forest)
+{
+  for (ymuint l = mNodeList[from].mLink; l != kNoNode; l = mLinkList[l].mNext) {
+    if ( mLinkList[l].mTo == to && mLinkList[l].mForest == forest ) {
+      return kNoNode;
+    }
+  }
+  ymuint id = mLinkList.size();
+  Link link;
+  link.mTo = to;
+  link.mForest = forest;
+  link.mNext = mNodeList[from].mLink;
+  mLinkList.push_back(link);
+  mNodeList[from].mLink = id;
+  return id;
+}
+
+// @brief 現在の終了位置で終わる森の節点を返す．
+// @param[in] symbol 記号のトークン番号
+// @param[in] start 開始位置
+// @param[in] end 終了位置
+ymuint
+GLRParser::forest_node(ymuint symbol,
+		       ymuint start,
+		       ymuint end)
+{
+  ymuint head = mSymbolHead[symbol];
+  for (ymuint f = head; f != kNoNode; f = mForestList[f].mNextSame) {
+    if ( mForestList[f].mStart == start ) {
+      ASSERT_COND( mForestList[f].mEnd == end );
+      return f;
+    }
+  }
+  if ( head == kNoNode ) {
+    mSymbolTouched.push_back(symbol);
+  }
+  ymuint id = mForestList.size();
+  ForestNode node;
+  node.mSymbol = symbol;
+  node.mStart = start;
+  node.mEnd = end;
+  node.mFamily = kNoNode;
+  node.mNextSame = head;
+  mForestList.push_back(node);
+  mSymbolHead[symbol] = id;
+  return id;
+}
+
+// @brief 森の節点に族を加える．
+// @param[in] forest 森の節点番号
+// @param[in] rule 規則番号
+// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+void
+GLRParser::add_family(ymuint forest,
+		      ymuint rule,
+		      ymuint leaf)
+{
+  ymuint np = mPathChild.size();
+  ymuint nc = leaf != kNoNode ? np + 1 : np;
+  for (ymuint fam = mForestList[forest].mFamily; fam != kNoNode;
+       fam = mFamilyList[fam].mNext) {
+    const Family& family = mFamilyList[fam];
+    if ( family.mRule != rule || family.mChildNum != nc ) {
+      continue;
+    }
+    bool same = true;
+    for (ymuint i = 0; i < np && same; ++ i) {
+      if ( mChildList[family.mChildTop + i] != mPathChild[np - 1 - i] ) {
+	same = false;
+      }
+    }
+    if ( same && leaf != kNoNode && mChildList[family.mChildTop + np] != leaf ) {
+      same = false;
+    }
+    if ( same ) {
+      return;
+    }
+  }
+
+  Family family;
+  family.mRule = rule;
+  family.mChildTop = mChildList.size();
+  family.mChildNum = nc;
+  family.mNext = mForestList[forest].mFamily;
+  for (ymuint i = 0; i < np; ++ i) {
+    mChildList.push_back(mPathChild[np - 1 - i]);
+  }
+  if ( leaf != kNoNode ) {
+    mChildList.push_back(leaf);
+  }
+  ymuint id = mFamilyList.size();
+  mFamilyList.push_back(family);
+  mForestList[forest].mFamily = id;
+}
+
+// @brief 新しい終了位置のために森の節点の索引をクリアする．
+void
+GLRParser::clear_symbol_head()
+{
+  for (vector<ymuint>::iterator p = mSymbolTouched.begin();
+       p != mSymbolTouched.end(); ++ p) {
+    mSymbolHead[*p] = kNoNode;
+  }
+  mSymbolTouched.clear();
+}
+
+END_NAMESPACE_YM
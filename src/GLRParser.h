@@ -0,0 +1,570 @@
+#ifndef GLRPARSER_H
+#define GLRPARSER_H
+
+/// @file GLRParser.h
+/// @brief GLRParser のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class ParseTable;
+class Grammer;
+
+//////////////////////////////////////////////////////////////////////
+/// @class GLRParser GLRParser.h "GLRParser.h"
+/// @brief 衝突した動作で分岐する GLR 構文解析器
+///
+/// keep_conflict を指定して作った ParseTable を用いる．
+/// 状態スタックはグラフ構造 (GSS) で持ち，同じ位置で同じ状態に
+/// なった枝は一つの節点にまとめる．分岐は衝突した要素でだけ起こるので，
+/// 衝突のない入力では枝は常に一つである．
+///
+/// reduce の結果は共有された構文森 (SPPF) として記録する．
+/// 森の節点は (記号, 開始位置, 終了位置) ごとに一つだけ作り，
+/// 異なる導出は同じ節点の別の族 (family) として持つ．
+/// 葉はトークンの節点で族を持たない．
+/// ParseTable の単位規則の除去で省略された A -> B の reduce は
+/// 森に現れず，B の節点が直接 A の位置に現れる．
+///
+/// 新しい枝が既存の節点につながった時は，その枝を通る reduce を
+/// 同じ位置の全ての節点でやり直す (Nozohoor-Farshi の方法)．
+/// これで空規則を含む文法でも reduce が漏れない．
+///
+/// 枝が一つの間は LRParserT と同様に線形のスタックで解析し，
+/// 衝突した要素に出会った時にスタックを GSS に写す．
+/// shift の後に枝が一つになり，その下の経路も一つしかない時は
+/// 線形のスタックに戻す．
+//////////////////////////////////////////////////////////////////////
+class GLRParser
+{
+public:
+
+  /// @brief 節点や族がないことを表す番号
+  static
+  const ymuint kNoNode = 0xFFFFFFFFU;
+
+
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] table 構文解析表
+  GLRParser(const ParseTable& table);
+
+  /// @brief デストラクタ
+  ~GLRParser();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 構文解析を行う．
+  /// @param[in] input 入力のトークン番号の列
+  /// @param[in] entry 入口番号
+  /// @return 受理した時 true を返す．
+  bool
+  parse(const vector<ymuint>& input,
+	ymuint entry = 0);
+
+  /// @brief 直前の parse() で行った reduce の回数を返す．
+  ymuint64
+  reduce_num() const;
+
+  /// @brief 直前の parse() でエラーになった入力の位置を返す．
+  ///
+  /// 受理した時は入力の長さを返す．
+  ymuint
+  error_pos() const;
+
+  /// @brief 直前の parse() で同時に存在した枝の数の最大値を返す．
+  ///
+  /// shift した直後の GSS の先端の節点数の最大値である．
+  ymuint
+  max_width() const;
+
+  /// @brief 直前の parse() で作った森の根を返す．
+  ///
+  /// 受理しなかった時は kNoNode を返す．
+  ymuint
+  forest_root() const;
+
+  /// @brief 森の節点数を返す．
+  ymuint
+  forest_node_num() const;
+
+  /// @brief 森の節点の記号のトークン番号を返す．
+  /// @param[in] id 節点番号 ( 0 <= id < forest_node_num() )
+  ymuint
+  forest_symbol(ymuint id) const;
+
+  /// @brief 森の節点の開始位置を返す．
+  /// @param[in] id 節点番号 ( 0 <= id < forest_node_num() )
+  ymuint
+  forest_start(ymuint id) const;
+
+  /// @brief 森の節点の終了位置を返す．
+  /// @param[in] id 節点番号 ( 0 <= id < forest_node_num() )
+  ymuint
+  forest_end(ymuint id) const;
+
+  /// @brief 森の節点の最初の族を返す．
+  /// @param[in] id 節点番号 ( 0 <= id < forest_node_num() )
+  ///
+  /// 族を持たない時は kNoNode を返す．
+  ymuint
+  forest_family(ymuint id) const;
+
+  /// @brief 同じ節点の次の族を返す．
+  /// @param[in] fam 族番号
+  ///
+  /// 最後の族の時は kNoNode を返す．
+  ymuint
+  family_next(ymuint fam) const;
+
+  /// @brief 族の規則番号を返す．
+  /// @param[in] fam 族番号
+  ymuint
+  family_rule(ymuint fam) const;
+
+  /// @brief 族の子の数を返す．
+  /// @param[in] fam 族番号
+  ymuint
+  family_child_num(ymuint fam) const;
+
+  /// @brief 族の子の節点番号を返す．
+  /// @param[in] fam 族番号
+  /// @param[in] pos 位置番号 ( 0 <= pos < family_child_num(fam) )
+  ymuint
+  family_child(ymuint fam,
+	       ymuint pos) const;
+
+  /// @brief 根から到達できる森の節点を出力する．
+  /// @param[in] s 出力先のストリーム
+  /// @param[in] grammer 構文解析表の元となった文法
+  void
+  print_forest(ostream& s,
+	       const Grammer& grammer) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // GSS の節点
+  struct Node
+  {
+    // 状態番号
+    ymuint mState;
+
+    // 入力の位置
+    ymuint mLevel;
+
+    // 最初の枝の番号
+    ymuint mLink;
+  };
+
+  // GSS の枝
+  struct Link
+  {
+    // 行き先の節点番号
+    ymuint mTo;
+
+    // 森の節点番号
+    ymuint mForest;
+
+    // 同じ節点から出る次の枝の番号
+    ymuint mNext;
+  };
+
+  // 森の節点
+  struct ForestNode
+  {
+    // 記号のトークン番号
+    ymuint mSymbol;
+
+    // 開始位置
+    ymuint mStart;
+
+    // 終了位置
+    ymuint mEnd;
+
+    // 最初の族の番号
+    ymuint mFamily;
+
+    // 同じ記号で同じ位置で終わる次の節点の番号
+    ymuint mNextSame;
+  };
+
+  // 森の族
+  struct Family
+  {
+    // 規則番号
+    ymuint mRule;
+
+    // mChildList 中の先頭位置
+    ymuint mChildTop;
+
+    // 子の数
+    ymuint mChildNum;
+
+    // 同じ節点の次の族の番号
+    ymuint mNext;
+  };
+
+  // 線形のスタックの要素
+  struct StackEntry
+  {
+    // 状態番号
+    ymuint mState;
+
+    // 入力の位置
+    ymuint mLevel;
+
+    // 一つ下の要素からの森の節点番号
+    ymuint mForest;
+
+    // 対応する GSS の節点番号 (なければ kNoNode)
+    ymuint mNode;
+  };
+
+  // 未処理の reduce
+  struct Reduction
+  {
+    // 始点の節点番号
+    ymuint mNode;
+
+    // 規則番号
+    ymuint mRule;
+
+    // 必ず通る枝の番号 (kNoNode なら制約なし)
+    ymuint mLink;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 線形のスタックの先頭の状態が現在の先読みで衝突を持つ時 true を返す．
+  bool
+  has_conflict() const;
+
+  /// @brief 線形のスタックで reduce を行う．
+  /// @param[in] rule 規則番号
+  /// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+  /// @param[in] end 森の節点の終了位置
+  void
+  stack_reduce(ymuint rule,
+	       ymuint leaf,
+	       ymuint end);
+
+  /// @brief 線形のスタックを GSS に写す．
+  void
+  stack_to_gss();
+
+  /// @brief GSS の経路が一つしかない時は線形のスタックに戻す．
+  void
+  gss_to_stack();
+
+  /// @brief 現在の位置の reduce を全て行う．
+  /// @param[in] first reduce を積む最初の mFrontier 中の位置
+  void
+  reduce_all(ymuint first);
+
+  /// @brief 現在の位置の shift を全て行う．
+  void
+  shift_all();
+
+  /// @brief 節点の reduce を待ち行列に積む．
+  /// @param[in] node 節点番号
+  /// @param[in] link 必ず通る枝の番号 (kNoNode なら制約なし)
+  void
+  put_reductions(ymuint node,
+		 ymuint link);
+
+  /// @brief reduce を一つ待ち行列に積む．
+  /// @param[in] node 節点番号
+  /// @param[in] rule 規則番号
+  /// @param[in] link 必ず通る枝の番号 (kNoNode なら制約なし)
+  void
+  put_reduction(ymuint node,
+		ymuint rule,
+		ymuint link);
+
+  /// @brief 新しい枝を通る reduce を現在の位置の全ての節点で積み直す．
+  /// @param[in] node 枝の始点の節点番号
+  /// @param[in] link 新しい枝の番号
+  void
+  redo_reductions(ymuint node,
+		  ymuint link);
+
+  /// @brief 経路をたどって reduce を行う．
+  /// @param[in] node 現在の節点番号
+  /// @param[in] rest 残りの長さ
+  /// @param[in] rule 規則番号
+  /// @param[in] link 必ず通る枝の番号 (kNoNode なら制約なし)
+  /// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+  /// @param[in] end 森の節点の終了位置
+  void
+  walk(ymuint node,
+       ymuint rest,
+       ymuint rule,
+       ymuint link,
+       ymuint leaf,
+       ymuint end);
+
+  /// @brief 一つの経路に対する reduce を行う．
+  /// @param[in] bottom 経路の終点の節点番号
+  /// @param[in] rule 規則番号
+  /// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+  /// @param[in] end 森の節点の終了位置
+  void
+  reduce_path(ymuint bottom,
+	      ymuint rule,
+	      ymuint leaf,
+	      ymuint end);
+
+  /// @brief 節点を作る．
+  /// @param[in] state 状態番号
+  /// @param[in] level 入力の位置
+  ymuint
+  new_node(ymuint state,
+	   ymuint level);
+
+  /// @brief 枝を加える．
+  /// @param[in] from 始点の節点番号
+  /// @param[in] to 行き先の節点番号
+  /// @param[in] forest 森の節点番号
+  /// @return 新しい枝の番号を返す．既にあった時は kNoNode を返す．
+  ymuint
+  add_link(ymuint from,
+	   ymuint to,
+	   ymuint forest);
+
+  /// @brief 現在の終了位置で終わる森の節点を返す．
+  /// @param[in] symbol 記号のトークン番号
+  /// @param[in] start 開始位置
+  /// @param[in] end 終了位置
+  ///
+  /// なければ作る．
+  ymuint
+  forest_node(ymuint symbol,
+	      ymuint start,
+	      ymuint end);
+
+  /// @brief 森の節点に族を加える．
+  /// @param[in] forest 森の節点番号
+  /// @param[in] rule 規則番号
+  /// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+  ///
+  /// 子は mPathChild の逆順と leaf である．同じ族があれば加えない．
+  void
+  add_family(ymuint forest,
+	     ymuint rule,
+	     ymuint leaf);
+
+  /// @brief 新しい終了位置のために森の節点の索引をクリアする．
+  void
+  clear_symbol_head();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 構文解析表
+  const ParseTable& mTable;
+
+  // 線形のスタック
+  // GSS を用いている間は空である．
+  vector<StackEntry> mStack;
+
+  // GSS の節点の配列
+  vector<Node> mNodeList;
+
+  // GSS の枝の配列
+  vector<Link> mLinkList;
+
+  // 森の節点の配列
+  vector<ForestNode> mForestList;
+
+  // 森の族の配列
+  vector<Family> mFamilyList;
+
+  // 族の子の配列
+  vector<ymuint> mChildList;
+
+  // 現在の位置の節点番号のリスト
+  vector<ymuint> mFrontier;
+
+  // 次の位置の節点番号のリスト
+  vector<ymuint> mNextFrontier;
+
+  // 状態番号をキーにした現在作っている位置の節点番号の配列
+  vector<ymuint> mStateNode;
+
+  // トークン番号をキーにした現在の終了位置で終わる森の節点のリストの先頭
+  vector<ymuint> mSymbolHead;
+
+  // mSymbolHead に値を入れたトークン番号のリスト
+  vector<ymuint> mSymbolTouched;
+
+  // 未処理の reduce の待ち行列
+  vector<Reduction> mQueue;
+
+  // 経路をたどる間の森の節点のスタック
+  vector<ymuint> mPathChild;
+
+  // 現在の入力の位置
+  ymuint mLevel;
+
+  // 現在の先読みのトークン番号
+  ymuint mToken;
+
+  // reduce の回数
+  ymuint64 mReduceNum;
+
+  // エラーになった位置
+  ymuint mErrorPos;
+
+  // 同時に存在した枝の数の最大値
+  ymuint mMaxWidth;
+
+  // 森の根
+  ymuint mRoot;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 直前の parse() で行った reduce の回数を返す．
+inline
+ymuint64
+GLRParser::reduce_num() const
+{
+  return mReduceNum;
+}
+
+// @brief 直前の parse() でエラーになった入力の位置を返す．
+inline
+ymuint
+GLRParser::error_pos() const
+{
+  return mErrorPos;
+}
+
+// @brief 直前の parse() で同時に存在した枝の数の最大値を返す．
+inline
+ymuint
+GLRParser::max_width() const
+{
+  return mMaxWidth;
+}
+
+// @brief 直前の parse() で作った森の根を返す．
+inline
+ymuint
+GLRParser::forest_root() const
+{
+  return mRoot;
+}
+
+// @brief 森の節点数を返す．
+inline
+ymuint
+GLRParser::forest_node_num() const
+{
+  return mForestList.size();
+}
+
+// @brief 森の節点の記号のトークン番号を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+GLRParser::forest_symbol(ymuint id) const
+{
+  return mForestList[id].mSymbol;
+}
+
+// @brief 森の節点の開始位置を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+GLRParser::forest_start(ymuint id) const
+{
+  return mForestList[id].mStart;
+}
+
+// @brief 森の節点の終了位置を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+GLRParser::forest_end(ymuint id) const
+{
+  return mForestList[id].mEnd;
+}
+
+// @brief 森の節点の最初の族を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+GLRParser::forest_family(ymuint id) const
+{
+  return mForestList[id].mFamily;
+}
+
+// @brief 同じ節点の次の族を返す．
+// @param[in] fam 族番号
+inline
+ymuint
+GLRParser::family_next(ymuint fam) const
+{
+  return mFamilyList[fam].mNext;
+}
+
+// @brief 族の規則番号を返す．
+// @param[in] fam 族番号
+inline
+ymuint
+GLRParser::family_rule(ymuint fam) const
+{
+  return mFamilyList[fam].mRule;
+}
+
+// @brief 族の子の数を返す．
+// @param[in] fam 族番号
+inline
+ymuint
+GLRParser::family_child_num(ymuint fam) const
+{
+  return mFamilyList[fam].mChildNum;
+}
+
+// @brief 族の子の節点番号を返す．
+// @param[in] fam 族番号
+// @param[in] pos 位置番号
+inline
+ymuint
+GLRParser::family_child(ymuint fam,
+			ymuint pos) const
+{
+  return mChildList[mFamilyList[fam].mChildTop + pos];
+}
+
+END_NAMESPACE_YM
+
+#endif // GLRPARSER_H
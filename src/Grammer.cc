@@ -10,6 +10,8 @@
 #include "Grammer.h"
 #include "Rule.h"
 #include "Token.h"
+#include "BuildStats.h"
+#include "PhaseProfiler.h"
 
 
 BEGIN_NAMESPACE_YM
@@ -49,8 +51,15 @@ bool
 add_to_tokenlist(vector<const Token*>& token_list,
 		 const vector<const Token*>& src_token_list)
 {
-  vector<const Token*>::iterator p = token_list.begin();
-  vector<const Token*>::iterator p_end = token_list.end();
+  if ( &token_list == &src_token_list ) {
+    return false;
+  }
+
+  // 挿入で反復子が無効にならないように別の配列にマージする．
+  vector<const Token*> tmp_list;
+  tmp_list.reserve(token_list.size() + src_token_list.size());
+  vector<const Token*>::const_iterator p = token_list.begin();
+  vector<const Token*>::const_iterator p_end = token_list.end();
   vector<const Token*>::const_iterator q = src_token_list.begin();
   vector<const Token*>::const_iterator q_end = src_token_list.end();
   bool update = false;
@@ -58,22 +67,30 @@ add_to_tokenlist(vector<const Token*>& token_list,
     const Token* token1 = *p;
     const Token* src_token = *q;
     if ( src_token->id() == token1->id() ) {
+      tmp_list.push_back(token1);
       ++ p;
       ++ q;
     }
     else if ( src_token->id() < token1->id() ) {
-      token_list.insert(p, src_token);
+      tmp_list.push_back(src_token);
       ++ q;
       update = true;
     }
     else {
+      tmp_list.push_back(token1);
       ++ p;
     }
   }
+  for ( ; p != p_end; ++ p) {
+    tmp_list.push_back(*p);
+  }
   for ( ; q != q_end; ++ q) {
-    token_list.push_back(*q);
+    tmp_list.push_back(*q);
     update = true;
   }
+  if ( update ) {
+    token_list.swap(tmp_list);
+  }
   return update;
 }
 
@@ -116,9 +133,9 @@ Grammer::Grammer()
   mNotExist = add_token("_not_exist_");
   ASSERT_COND( mNotExist->id() == kNotExist );
 
-  mStartRule = NULL;
-
   mNextTermId = 0;
+
+  mTermNum = 0;
 }
 
 // @brief デストラクタ
@@ -147,6 +164,8 @@ Grammer::add_token(string str,
 		   ymuint pri,
 		   AssocType assoc)
 {
+  ASSERT_COND( mDenseList.empty() );
+
   ymuint id = mTokenList.size();
   Token* token = new Token(id, str, pri, assoc);
   mTokenList.push_back(token);
@@ -161,6 +180,8 @@ Rule*
 Grammer::add_rule(Token* left,
 		  const vector<Token*>& right)
 {
+  ASSERT_COND( mDenseList.empty() );
+
   ymuint id = mRuleList.size();
   Rule* rule = new Rule(id, left, right);
   mRuleList.push_back(rule);
@@ -171,46 +192,118 @@ Grammer::add_rule(Token* left,
   return rule;
 }
 
+// @brief 終端記号に字句のパターンを設定する．
+// @param[in] token 対象のトークン
+// @param[in] pattern 正規表現
+void
+Grammer::set_pattern(Token* token,
+		     const string& pattern)
+{
+  ASSERT_COND( token != NULL );
+  token->mPattern = pattern;
+}
+
+// @brief 読み飛ばす字句のパターンを追加する．
+// @param[in] pattern 正規表現
+void
+Grammer::add_skip_pattern(const string& pattern)
+{
+  mSkipPatternList.push_back(pattern);
+}
+
 // @brief 開始記号を設定する．
 // @param[in] start 開始記号
+// @param[in] stats 統計情報の記録先
+void
+Grammer::set_start(Token* start,
+		   BuildStats* stats)
+{
+  ASSERT_COND( mStartRuleList.empty() );
+  add_start(start);
+  analyze(stats);
+}
+
+// @brief 開始記号(入口)を追加する．
+// @param[in] start 開始記号
+// @return 入口番号を返す．
+ymuint
+Grammer::add_start(Token* start)
+{
+  ymuint pos = mStartRuleList.size();
+  mStartRuleList.push_back(add_rule(mStart, vector<Token*>(1, start)));
+  return pos;
+}
+
+// @brief トークンに終端記号と非終端記号で分けた通し番号をつける．
 void
-Grammer::set_start(Token* start)
+Grammer::freeze()
 {
-  ASSERT_COND( mStartRule == NULL );
-  mStartRule = add_rule(mStart, vector<Token*>(1, start));
-  analyze();
+  if ( !mDenseList.empty() ) {
+    return;
+  }
+
+  // それぞれの中ではトークン番号の順に並べる．
+  ymuint nt = mTokenList.size();
+  mDenseList.reserve(nt);
+  for (ymuint i = 0; i < nt; ++ i) {
+    if ( mTokenList[i]->is_terminal() ) {
+      mDenseList.push_back(mTokenList[i]);
+    }
+  }
+  mTermNum = mDenseList.size();
+  for (ymuint i = 0; i < nt; ++ i) {
+    if ( !mTokenList[i]->is_terminal() ) {
+      mDenseList.push_back(mTokenList[i]);
+    }
+  }
+  for (ymuint i = 0; i < nt; ++ i) {
+    // mDenseList の要素は const なので mTokenList から書き換える．
+    mTokenList[mDenseList[i]->id()]->mDenseId = i;
+  }
 }
 
 // @brief 種々の解析を行う．
+// @param[in] stats 統計情報の記録先
 //
-// 各トークンの FIRST/FOLLOW を計算しておく．
+// freeze() を行ってから各トークンの FIRST/FOLLOW を計算しておく．
 void
-Grammer::analyze()
+Grammer::analyze(BuildStats* stats)
 {
+  PhaseProfiler profiler(stats);
+  stats = profiler.stats();
+  PhaseTimer timer(stats, BuildStats::kAnalyze);
+
+  freeze();
+
   // FIRST の計算
 
   // 終端節点は自分自身
   for (vector<Token*>::iterator p = mTokenList.begin();
        p != mTokenList.end(); ++ p) {
     Token* token = *p;
-    if ( token->rule_list().empty() ) {
+    if ( token->is_terminal() ) {
       token->mFirst.push_back(token);
     }
   }
 
   // 変更があるかぎり以下の処理を繰り返す．
+  // 左辺の FIRST に右辺のトークン列の FIRST を加える．
+  // 右辺が空の規則の場合には空記号が加わる．
   for (bool update = true; update; ) {
     update = false;
     for (vector<Rule*>::const_iterator p = mRuleList.begin();
 	 p != mRuleList.end(); ++ p) {
       Rule* rule = *p;
+      vector<const Token*> right_list;
       for (ymuint i = 0; i < rule->right_size(); ++ i) {
-	const Token* token = rule->right(i);
-	// const を外すための hack
-	Token* left = mTokenList[rule->left()->id()];
-	if ( add_to_tokenlist(left->mFirst, token) ) {
-	  update = true;
-	}
+	right_list.push_back(rule->right(i));
+      }
+      vector<const Token*> flist;
+      first_of(right_list, flist);
+      // const を外すための hack
+      Token* left = mTokenList[rule->left()->id()];
+      if ( add_to_tokenlist(left->mFirst, flist) ) {
+	update = true;
       }
     }
   }
@@ -234,29 +327,36 @@ Grammer::analyze()
 	 p != mRuleList.end(); ++ p) {
       Rule* rule = *p;
       ymuint n = rule->right_size();
-      for (ymuint i = 0; i < n - 1; ++ i) {
-	bool has_epsilon = false;
-	const Token* token = rule->right(i + 1);
-	if ( token == mEpsilon ) {
-	  has_epsilon = true;
+      for (ymuint i = 0; i < n; ++ i) {
+	// right(i) の FOLLOW に right(i + 1) 以降の FIRST を加える．
+	// right(i + 1) 以降が空記号を導出する場合には左辺の FOLLOW も加える．
+	vector<const Token*> rest;
+	for (ymuint j = i + 1; j < n; ++ j) {
+	  rest.push_back(rule->right(j));
 	}
-	else {
-	  Token* right = mTokenList[rule->right(i)->id()];
-	  if ( add_to_tokenlist(right->mFollow, token) ) {
-	    update = true;
+	vector<const Token*> flist;
+	first_of(rest, flist);
+	bool has_epsilon = false;
+	vector<const Token*> flist1;
+	for (vector<const Token*>::iterator q = flist.begin();
+	     q != flist.end(); ++ q) {
+	  if ( *q == mEpsilon ) {
+	    has_epsilon = true;
+	  }
+	  else {
+	    flist1.push_back(*q);
 	  }
 	}
+	Token* right = mTokenList[rule->right(i)->id()];
+	if ( add_to_tokenlist(right->mFollow, flist1) ) {
+	  update = true;
+	}
 	if ( has_epsilon ) {
-	  Token* right = mTokenList[rule->right(i)->id()];
 	  if ( add_to_tokenlist(right->mFollow, rule->left()->mFollow) ) {
 	    update = true;
 	  }
 	}
       }
-      Token* right = mTokenList[rule->right(n - 1)->id()];
-      if ( add_to_tokenlist(right->mFollow, rule->left()->mFollow) ) {
-	update = true;
-      }
     }
   }
 
@@ -267,6 +367,18 @@ Grammer::analyze()
     sort_tokenlist(token->mFollow);
   }
 
+  if ( stats != NULL ) {
+    ymuint64 bytes = 0;
+    for (vector<Token*>::iterator p = mTokenList.begin();
+	 p != mTokenList.end(); ++ p) {
+      Token* token = *p;
+      bytes += vector_bytes(token->mFirst);
+      bytes += vector_bytes(token->mFollow);
+    }
+    stats->set_count(BuildStats::kTokenNum, mTokenList.size());
+    stats->set_count(BuildStats::kRuleNum, mRuleList.size());
+    stats->update_peak(BuildStats::kMemFirstFollow, bytes);
+  }
 }
 
 // @brief トークン数
@@ -286,6 +398,36 @@ Grammer::token(ymuint id) const
   return mTokenList[id];
 }
 
+// @brief 終端記号の数を返す．
+ymuint
+Grammer::terminal_num() const
+{
+  return mTermNum;
+}
+
+// @brief 非終端記号の数を返す．
+ymuint
+Grammer::nonterminal_num() const
+{
+  return mDenseList.size() - mTermNum;
+}
+
+// @brief 通し番号からトークンを返す．
+// @param[in] dense_id 通し番号
+const Token*
+Grammer::dense_token(ymuint dense_id) const
+{
+  ASSERT_COND( dense_id < mDenseList.size() );
+  return mDenseList[dense_id];
+}
+
+// @brief 読み飛ばす字句のパターンのリストを返す．
+const vector<string>&
+Grammer::skip_pattern_list() const
+{
+  return mSkipPatternList;
+}
+
 // @brief 文法規則の数
 ymuint
 Grammer::rule_num() const
@@ -303,11 +445,20 @@ Grammer::rule(ymuint id) const
   return mRuleList[id];
 }
 
+// @brief 入口の数を返す．
+ymuint
+Grammer::start_num() const
+{
+  return mStartRuleList.size();
+}
+
 // @brief 開始規則を返す．
+// @param[in] pos 入口番号
 const Rule*
-Grammer::start_rule() const
+Grammer::start_rule(ymuint pos) const
 {
-  return mStartRule;
+  ASSERT_COND( pos < mStartRuleList.size() );
+  return mStartRuleList[pos];
 }
 
 // @brief 項番号を返す．
@@ -352,11 +503,8 @@ Grammer::print_rules(ostream& s) const
   for (vector<Rule*>::const_iterator p = mRuleList.begin();
        p != mRuleList.end(); ++ p) {
     Rule* rule = *p;
-    s << rule->id() << ": " << rule->left()->str() << " ::=";
-    for (ymuint i = 0; i < rule->right_size(); ++ i) {
-      const Token* token = rule->right(i);
-      s << " " << token->str();
-    }
+    s << rule->id() << ": ";
+    rule->print(s);
     s << endl;
   }
   s << endl;
@@ -390,7 +538,7 @@ Grammer::first_of(const vector<const Token*>& token_list,
     }
   }
   if ( all_epsilon ) {
-    first_list.push_back(mEpsilon);
+    add_to_tokenlist(first_list, mEpsilon);
   }
 }
 
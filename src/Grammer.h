@@ -16,6 +16,7 @@ BEGIN_NAMESPACE_YM
 
 class Token;
 class Rule;
+class BuildStats;
 
 //////////////////////////////////////////////////////////////////////
 /// @brief 結合性を表す列挙型
@@ -42,10 +43,17 @@ enum AssocType {
 ///
 /// 通常のトークン以外に特殊記号がある．
 /// - ダミーの開始記号 kStart, S': S' -> S という規則も追加する．
+///   開始記号を複数持つ場合は入口ごとに S' -> S_i という規則を追加する．
 /// - 文末を表す記号   kEnd, $
 /// - 空記号           kEpsilon, ε
 /// - 実際の文法規則
 ///   に現れない記号   kNotExist, #
+///
+/// 全ての規則と入口を追加した後で freeze() を呼ぶと，終端記号が
+/// [0, T)，非終端記号が [T, T + N) を占める通し番号(Token::dense_id())
+/// がつけられる．トークン番号(Token::id())はそのまま残るので，
+/// dense_token() が通し番号からトークンへの対応表となる．
+/// freeze() の後はトークンや規則を追加できない．
 //////////////////////////////////////////////////////////////////////
 class Grammer
 {
@@ -105,16 +113,53 @@ public:
   add_rule(Token* left,
 	   const vector<Token*>& right);
 
+  /// @brief 終端記号に字句のパターンを設定する．
+  /// @param[in] token 対象のトークン
+  /// @param[in] pattern 正規表現
+  ///
+  /// 正規表現の書き方は Lexer を参照のこと．
+  /// 複数のパターンに一致する時はトークン番号の小さい方になる．
+  void
+  set_pattern(Token* token,
+	      const string& pattern);
+
+  /// @brief 読み飛ばす字句のパターンを追加する．
+  /// @param[in] pattern 正規表現
+  ///
+  /// 空白や注釈を表す．どのトークンのパターンよりも優先順位が低い．
+  void
+  add_skip_pattern(const string& pattern);
+
   /// @brief 開始記号を設定する．
   /// @param[in] start 開始記号
+  /// @param[in] stats 統計情報の記録先
+  ///
+  /// add_start() と analyze() をまとめて行う．
+  void
+  set_start(Token* start,
+	    BuildStats* stats = NULL);
+
+  /// @brief 開始記号(入口)を追加する．
+  /// @param[in] start 開始記号
+  /// @return 入口番号を返す．
+  ///
+  /// 全ての入口を追加した後で analyze() を一度だけ呼ぶこと．
+  /// 入口は一つの LR0Set の中で状態を共有する．
+  ymuint
+  add_start(Token* start);
+
+  /// @brief トークンに終端記号と非終端記号で分けた通し番号をつける．
+  ///
+  /// analyze() からも呼ばれる．二度目以降の呼び出しは何もしない．
   void
-  set_start(Token* start);
+  freeze();
 
   /// @brief 種々の解析を行う．
+  /// @param[in] stats 統計情報の記録先
   ///
-  /// 各トークンの FIRST/FOLLOW を計算しておく．
+  /// freeze() を行ってから各トークンの FIRST/FOLLOW を計算しておく．
   void
-  analyze();
+  analyze(BuildStats* stats = NULL);
 
   /// @brief トークン数
   ymuint
@@ -126,6 +171,29 @@ public:
   const Token*
   token(ymuint id) const;
 
+  /// @brief 終端記号の数を返す．
+  ///
+  /// freeze() の後でのみ意味を持つ．
+  ymuint
+  terminal_num() const;
+
+  /// @brief 非終端記号の数を返す．
+  ///
+  /// freeze() の後でのみ意味を持つ．
+  ymuint
+  nonterminal_num() const;
+
+  /// @brief 通し番号からトークンを返す．
+  /// @param[in] dense_id 通し番号 ( 0 <= dense_id < token_num() )
+  ///
+  /// freeze() の後でのみ意味を持つ．
+  const Token*
+  dense_token(ymuint dense_id) const;
+
+  /// @brief 読み飛ばす字句のパターンのリストを返す．
+  const vector<string>&
+  skip_pattern_list() const;
+
   /// @brief 文法規則の数
   ymuint
   rule_num() const;
@@ -136,9 +204,14 @@ public:
   const Rule*
   rule(ymuint id) const;
 
+  /// @brief 入口の数を返す．
+  ymuint
+  start_num() const;
+
   /// @brief 開始規則を返す．
+  /// @param[in] pos 入口番号 ( 0 <= pos < start_num() )
   const Rule*
-  start_rule() const;
+  start_rule(ymuint pos = 0) const;
 
   /// @brief 項番号を返す．
   /// @param[in] rule_id 文法規則ID
@@ -176,6 +249,13 @@ private:
   // Token::mIdをキーにした配列
   vector<Token*> mTokenList;
 
+  // Token::mDenseId をキーにしたトークンの配列
+  // freeze() で作られる．
+  vector<const Token*> mDenseList;
+
+  // 終端記号の数
+  ymuint mTermNum;
+
   // 文法規則のリスト
   // Rule::mId をキーにした配列
   vector<Rule*> mRuleList;
@@ -198,8 +278,12 @@ private:
   // ダミーの終端記号
   Token* mNotExist;
 
-  // ダミーの開始規則
-  Rule* mStartRule;
+  // ダミーの開始規則のリスト
+  // 入口番号をキーにした配列
+  vector<Rule*> mStartRuleList;
+
+  // 読み飛ばす字句のパターンのリスト
+  vector<string> mSkipPatternList;
 
 };
 
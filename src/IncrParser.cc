@@ -0,0 +1,668 @@
+
+/// @file IncrParser.cc
+/// @brief IncrParser の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "IncrParser.h"
+#include "ParseTable.h"
+#include "Grammer.h"
+#include "Token.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// クラス IncrParser
+//////////////////////////////////////////////////////////////////////
+
+// 定数の定義
+const ymuint IncrParser::kNoNode;
+const ymuint IncrParser::kListRule;
+
+// @brief コンストラクタ
+// @param[in] table 構文解析表
+IncrParser::IncrParser(const ParseTable& table) :
+  mTable(table),
+  mEntry(0),
+  mInputLen(0),
+  mEditPos(0),
+  mOldLen(0),
+  mNewLen(0),
+  mLiveNum(0),
+  mErrorPos(0),
+  mShiftNum(0),
+  mReuseNum(0),
+  mRoot(kNoNode)
+{
+}
+
+// @brief デストラクタ
+IncrParser::~IncrParser()
+{
+}
+
+// @brief 入力全体を構文解析する．
+// @param[in] input 入力のトークン番号の列
+// @param[in] entry 入口番号
+// @return 受理した時 true を返す．
+bool
+IncrParser::parse(const vector<ymuint>& input,
+		  ymuint entry)
+{
+  ASSERT_COND( entry < mTable.start_num() );
+
+  mEntry = entry;
+  mNodeList.clear();
+  mChildList.clear();
+  bool stat = run(input, kNoNode);
+  mInputLen = input.size();
+  mLiveNum = mNodeList.size();
+  return stat;
+}
+
+// @brief 変更された入力を再解析する．
+// @param[in] input 変更後の入力のトークン番号の列
+// @param[in] edit_pos 変更された範囲の先頭位置
+// @param[in] old_len 変更前の範囲の長さ
+// @param[in] new_len 変更後の範囲の長さ
+// @return 受理した時 true を返す．
+bool
+IncrParser::reparse(const vector<ymuint>& input,
+		    ymuint edit_pos,
+		    ymuint old_len,
+		    ymuint new_len)
+{
+  ASSERT_COND( edit_pos + old_len <= mInputLen );
+  ASSERT_COND( input.size() + old_len == mInputLen + new_len );
+
+  if ( mRoot == kNoNode ) {
+    return parse(input, mEntry);
+  }
+
+  mEditPos = edit_pos;
+  mOldLen = old_len;
+  mNewLen = new_len;
+  bool stat = run(input, mRoot);
+  mInputLen = input.size();
+
+  // 作った節点数が生きている節点数を超えたら詰め直す．
+  if ( stat && mNodeList.size() > mLiveNum * 2 ) {
+    compact();
+  }
+  return stat;
+}
+
+// @brief 節点の子を返す．
+// @param[in] id 節点番号
+// @param[in] pos 位置番号 ( 0 <= pos < node_child_num(id) )
+//
+// リストの時は列の節点を要素数でたどる．
+ymuint
+IncrParser::node_child(ymuint id,
+		       ymuint pos) const
+{
+  ASSERT_COND( pos < node_child_num(id) );
+  if ( mNodeList[id].mRule != kListRule ) {
+    return mChildList[mNodeList[id].mChildTop + pos];
+  }
+  // 要素はリストではないので，列の節点でなくなるまでたどる．
+  while ( mNodeList[id].mRule == kListRule ) {
+    const Node& node = mNodeList[id];
+    ymuint left = mChildList[node.mChildTop];
+    ymuint left_num = mNodeList[left].mItemNum;
+    if ( pos < left_num ) {
+      id = left;
+    }
+    else {
+      id = mChildList[node.mChildTop + 1];
+      pos -= left_num;
+    }
+  }
+  return id;
+}
+
+// @brief 構文木を括弧つきの形で出力する．
+// @param[in] s 出力先のストリーム
+// @param[in] grammer 構文解析表の元となった文法
+void
+IncrParser::print_tree(ostream& s,
+		       const Grammer& grammer) const
+{
+  if ( mRoot != kNoNode ) {
+    print_node(s, grammer, mRoot);
+  }
+  s << endl;
+}
+
+// @brief 構文解析を行う．
+// @param[in] input 入力のトークン番号の列
+// @param[in] old_root 再利用する木の根 (kNoNode なら再利用しない)
+bool
+IncrParser::run(const vector<ymuint>& input,
+		ymuint old_root)
+{
+  mShiftNum = 0;
+  mReuseNum = 0;
+  mRoot = kNoNode;
+
+  mStack.clear();
+  StackEntry start;
+  start.mState = mTable.start_state(mEntry);
+  start.mNode = kNoNode;
+  start.mPendTop = kNoNode;
+  mStack.push_back(start);
+  mPendList.clear();
+
+  mCandList.clear();
+  if ( old_root != kNoNode ) {
+    Candidate cand;
+    cand.mNode = old_root;
+    cand.mStart = 0;
+    cand.mHead = true;
+    mCandList.push_back(cand);
+  }
+
+  ymuint n = input.size();
+  ymuint pos = 0;
+  for ( ; ; ) {
+    ymuint state = mStack.back().mState;
+
+    // 変更された範囲の外では古い部分木を再利用する．
+    if ( !mCandList.empty() && pos < n &&
+	 (pos < mEditPos || pos >= mEditPos + mNewLen) ) {
+      ymuint old_pos = pos < mEditPos ? pos : pos - mNewLen + mOldLen;
+      ymuint node;
+      bool append = false;
+      while ( (node = candidate(old_pos)) != kNoNode ) {
+	const Node& cand = mNodeList[node];
+	if ( cand.mRule == kNoNode ) {
+	  // 葉は普通に shift する．
+	  node = kNoNode;
+	  break;
+	}
+	ymuint old_end = old_pos + cand.mLength;
+	if ( old_end >= mEditPos && old_pos < mEditPos + mOldLen ) {
+	  // 範囲か先読みが変更されている．
+	  split_candidate();
+	  continue;
+	}
+	if ( cand.mStep ||
+	     (cand.mRule == kListRule && !mCandList.back().mHead) ) {
+	  // リストの途中から始まる部分はリストの末尾に加える．
+	  // 加えられない時は reduce か shift をしてから調べ直す．
+	  append = true;
+	  if ( !can_append(node) ) {
+	    node = kNoNode;
+	  }
+	}
+	else if ( cand.mState != state ) {
+	  // 左の部分木も左端の状態は同じなので，分けても一致しない．
+	  node = kNoNode;
+	}
+	break;
+      }
+      if ( node != kNoNode ) {
+	if ( append ) {
+	  StackEntry& top = mStack.back();
+	  if ( top.mPendTop == kNoNode ) {
+	    top.mPendTop = mPendList.size();
+	  }
+	  mPendList.push_back(node);
+	}
+	else {
+	  ymuint next = mTable.goto_state(state, mNodeList[node].mSymbol);
+	  ASSERT_COND( next != ParseTable::kNoState );
+	  StackEntry entry;
+	  entry.mState = next;
+	  entry.mNode = node;
+	  entry.mPendTop = kNoNode;
+	  mStack.push_back(entry);
+	}
+	pos += mNodeList[node].mLength;
+	++ mReuseNum;
+	continue;
+      }
+    }
+
+    ymuint token = pos < n ? input[pos] : Grammer::kEnd;
+    ymuint32 code = mTable.action(state, token);
+    switch ( ParseTable::action_type(code) ) {
+    case ParseTable::kShift:
+      {
+	StackEntry entry;
+	entry.mState = ParseTable::action_arg(code);
+	entry.mNode = new_node(token, kNoNode, state);
+	entry.mPendTop = kNoNode;
+	mStack.push_back(entry);
+	++ pos;
+	++ mShiftNum;
+      }
+      break;
+
+    case ParseTable::kReduce:
+      reduce(ParseTable::action_arg(code), kNoNode);
+      break;
+
+    case ParseTable::kShiftReduce:
+      {
+	ymuint leaf = new_node(token, kNoNode, state);
+	++ pos;
+	++ mShiftNum;
+	reduce(ParseTable::action_arg(code), leaf);
+      }
+      break;
+
+    case ParseTable::kAccept:
+      close_list(mStack.size() - 1);
+      mRoot = mStack.back().mNode;
+      mErrorPos = n;
+      return true;
+
+    case ParseTable::kError:
+      mErrorPos = pos;
+      return false;
+    }
+  }
+}
+
+// @brief 変更前の位置 old_pos から始まる再利用の候補を返す．
+//
+// old_pos より前で終わる候補は捨て，old_pos をまたぐ候補は子に分ける．
+ymuint
+IncrParser::candidate(ymuint old_pos)
+{
+  while ( !mCandList.empty() ) {
+    const Candidate& cand = mCandList.back();
+    ymuint start = cand.mStart;
+    ymuint end = start + mNodeList[cand.mNode].mLength;
+    if ( end <= old_pos ) {
+      mCandList.pop_back();
+    }
+    else if ( start == old_pos ) {
+      return cand.mNode;
+    }
+    else if ( start > old_pos ) {
+      return kNoNode;
+    }
+    else {
+      split_candidate();
+    }
+  }
+  return kNoNode;
+}
+
+// @brief 先頭の候補を子に置き換える．
+//
+// 列の節点の右の子はリストの途中から始まる．
+void
+IncrParser::split_candidate()
+{
+  Candidate cand = mCandList.back();
+  mCandList.pop_back();
+  const Node& node = mNodeList[cand.mNode];
+  bool seq = node.mRule == kListRule;
+  ymuint end = cand.mStart + node.mLength;
+  for (ymuint i = node.mChildNum; i > 0; -- i) {
+    ymuint child = mChildList[node.mChildTop + i - 1];
+    end -= mNodeList[child].mLength;
+    Candidate child_cand;
+    child_cand.mNode = child;
+    child_cand.mStart = end;
+    child_cand.mHead = !seq || (i == 1 && cand.mHead);
+    mCandList.push_back(child_cand);
+  }
+}
+
+// @brief 部分列の節点を状態スタックの先頭のリストの末尾に加えられる時 true を返す．
+// @param[in] id 段の節点か途中から始まる列の節点
+//
+// 古い構文解析では部分列の各段は，リストの左端の状態の上に A を積んだ
+// 状態から解析されて A -> A β で reduce されている．β の中の reduce は
+// A より下を見ないので，状態スタックの先頭が同じ状態の上の A なら
+// 同じ段ができる．先頭の記号が A でない (単位規則の除去で省略された) 時は
+// 最初の段が段の節点にならないので加えない．
+bool
+IncrParser::can_append(ymuint id) const
+{
+  ymuint n = mStack.size();
+  if ( n < 2 ) {
+    return false;
+  }
+  const Node& node = mNodeList[id];
+  return mStack[n - 2].mState == node.mState &&
+    mNodeList[mStack[n - 1].mNode].mSymbol == node.mSymbol;
+}
+
+// @brief reduce を行う．
+// @param[in] rule 規則番号
+// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+//
+// 先頭の子の記号が規則の左辺と等しい (左再帰の) 時は先頭の子をリストとし，
+// 残りの子を持つ段の節点をその末尾に加える．
+void
+IncrParser::reduce(ymuint rule,
+		   ymuint leaf)
+{
+  ymuint size = mTable.rule_size(rule);
+  bool step = size >= 2;
+  if ( leaf != kNoNode ) {
+    -- size;
+  }
+  ymuint sp = mStack.size() - size;
+  ymuint state = mStack[sp - 1].mState;
+  ymuint left = mTable.rule_left(rule);
+  step = step && size > 0 && mNodeList[mStack[sp].mNode].mSymbol == left;
+  if ( !mPendList.empty() ) {
+    for (ymuint i = mStack.size(); i > sp; -- i) {
+      if ( i > sp + 1 || !step ) {
+	close_list(i - 1);
+      }
+    }
+  }
+
+  ymuint top = step ? sp + 1 : sp;
+  ymuint id = new_node(left, rule, state);
+  ymuint length = 0;
+  for (ymuint i = top; i < mStack.size(); ++ i) {
+    ymuint child = mStack[i].mNode;
+    mChildList.push_back(child);
+    length += mNodeList[child].mLength;
+  }
+  if ( leaf != kNoNode ) {
+    mChildList.push_back(leaf);
+    length += 1;
+  }
+  Node& node = mNodeList[id];
+  node.mLength = length;
+  node.mChildNum = mChildList.size() - node.mChildTop;
+
+  if ( step ) {
+    node.mStep = true;
+    StackEntry& list = mStack[sp];
+    if ( list.mPendTop == kNoNode ) {
+      list.mPendTop = mPendList.size();
+    }
+    mPendList.push_back(id);
+    mStack.resize(sp + 1);
+    return;
+  }
+
+  ymuint next = mTable.goto_state(state, left);
+  ASSERT_COND( next != ParseTable::kNoState );
+  mStack.resize(sp);
+  StackEntry entry;
+  entry.mState = next;
+  entry.mNode = id;
+  entry.mPendTop = kNoNode;
+  mStack.push_back(entry);
+}
+
+// @brief 状態スタックの要素の伸びているリストを平衡木にまとめる．
+// @param[in] sp 状態スタック中の位置
+//
+// 新しく作った段は続いているのでまとめて平衡木にしてからつなげる．
+// 再解析で加えた部分列は変更の左では低くなり，右では高くなる順に並ぶので，
+// 低いものどうしから先につなげると join_list() の手間の合計が
+// 高さ程度になる．
+// 伸びているリストは状態スタックの上の要素のものほど mPendList の
+// 後ろにあるので，上から順にまとめる．
+void
+IncrParser::close_list(ymuint sp)
+{
+  StackEntry& entry = mStack[sp];
+  ymuint begin = entry.mPendTop;
+  if ( begin == kNoNode ) {
+    return;
+  }
+  ymuint end = mPendList.size();
+  // 高さが真に減る木のスタック
+  vector<ymuint> tree_list;
+  tree_list.push_back(entry.mNode);
+  for (ymuint i = begin; i < end; ) {
+    ymuint tree;
+    ymuint j = i;
+    while ( j < end && mNodeList[mPendList[j]].mHeight == 0 ) {
+      ++ j;
+    }
+    if ( j > i ) {
+      tree = build_list(i, j);
+      i = j;
+    }
+    else {
+      tree = mPendList[i];
+      ++ i;
+    }
+    while ( !tree_list.empty() &&
+	    mNodeList[tree_list.back()].mHeight <= mNodeList[tree].mHeight ) {
+      tree = join_list(tree_list.back(), tree);
+      tree_list.pop_back();
+    }
+    tree_list.push_back(tree);
+  }
+  ymuint list = tree_list.back();
+  for (ymuint i = tree_list.size() - 1; i > 0; -- i) {
+    list = join_list(tree_list[i - 1], list);
+  }
+  mPendList.resize(begin);
+  entry.mNode = list;
+  entry.mPendTop = kNoNode;
+}
+
+// @brief 要素の列から平衡木を作る．
+// @param[in] begin, end mPendList 中の範囲
+ymuint
+IncrParser::build_list(ymuint begin,
+		       ymuint end)
+{
+  if ( end - begin == 1 ) {
+    return mPendList[begin];
+  }
+  ymuint mid = (begin + end) / 2;
+  ymuint left = build_list(begin, mid);
+  ymuint right = build_list(mid, end);
+  return new_seq(left, right);
+}
+
+// @brief 二つの平衡木をつなげる．
+// @param[in] left, right 木の根 (要素の節点でもよい)
+//
+// 高い方の木の端をたどって高さの差が 1 以下の部分木とつなげ，
+// 戻りながら回転で平衡を直す (AVL 木の join)．
+// 古い木の節点は書き換えずに新しい節点を作る．
+ymuint
+IncrParser::join_list(ymuint left,
+		      ymuint right)
+{
+  ymuint lh = mNodeList[left].mHeight;
+  ymuint rh = mNodeList[right].mHeight;
+  if ( lh > rh + 1 ) {
+    // left の右端をたどる．
+    ymuint a = mChildList[mNodeList[left].mChildTop];
+    ymuint c = mChildList[mNodeList[left].mChildTop + 1];
+    ymuint ah = mNodeList[a].mHeight;
+    ymuint ch = mNodeList[c].mHeight;
+    if ( ch <= rh + 1 ) {
+      if ( ch <= ah && rh <= ah ) {
+	return new_seq(a, new_seq(c, right));
+      }
+      // ch == ah + 1 なので c を分けて二重回転する．
+      ymuint c1 = mChildList[mNodeList[c].mChildTop];
+      ymuint c2 = mChildList[mNodeList[c].mChildTop + 1];
+      ymuint t1 = new_seq(a, c1);
+      ymuint t2 = new_seq(c2, right);
+      return new_seq(t1, t2);
+    }
+    ymuint t = join_list(c, right);
+    if ( mNodeList[t].mHeight <= ah + 1 ) {
+      return new_seq(a, t);
+    }
+    ymuint t1 = mChildList[mNodeList[t].mChildTop];
+    ymuint t2 = mChildList[mNodeList[t].mChildTop + 1];
+    return new_seq(new_seq(a, t1), t2);
+  }
+  if ( rh > lh + 1 ) {
+    // right の左端をたどる．
+    ymuint c = mChildList[mNodeList[right].mChildTop];
+    ymuint b = mChildList[mNodeList[right].mChildTop + 1];
+    ymuint bh = mNodeList[b].mHeight;
+    ymuint ch = mNodeList[c].mHeight;
+    if ( ch <= lh + 1 ) {
+      if ( ch <= bh && lh <= bh ) {
+	return new_seq(new_seq(left, c), b);
+      }
+      ymuint c1 = mChildList[mNodeList[c].mChildTop];
+      ymuint c2 = mChildList[mNodeList[c].mChildTop + 1];
+      ymuint t1 = new_seq(left, c1);
+      ymuint t2 = new_seq(c2, b);
+      return new_seq(t1, t2);
+    }
+    ymuint t = join_list(left, c);
+    if ( mNodeList[t].mHeight <= bh + 1 ) {
+      return new_seq(t, b);
+    }
+    ymuint t1 = mChildList[mNodeList[t].mChildTop];
+    ymuint t2 = mChildList[mNodeList[t].mChildTop + 1];
+    return new_seq(t1, new_seq(t2, b));
+  }
+  return new_seq(left, right);
+}
+
+// @brief 列の節点を作る．
+// @param[in] left, right 子の節点
+ymuint
+IncrParser::new_seq(ymuint left,
+		    ymuint right)
+{
+  const Node& left_node = mNodeList[left];
+  const Node& right_node = mNodeList[right];
+  ASSERT_COND( left_node.mHeight <= right_node.mHeight + 1 );
+  ASSERT_COND( right_node.mHeight <= left_node.mHeight + 1 );
+
+  Node node;
+  node.mSymbol = left_node.mSymbol;
+  node.mRule = kListRule;
+  node.mState = left_node.mState;
+  node.mLength = left_node.mLength + right_node.mLength;
+  node.mChildTop = mChildList.size();
+  node.mChildNum = 2;
+  node.mItemNum = left_node.mItemNum + right_node.mItemNum;
+  node.mHeight = std::max(left_node.mHeight, right_node.mHeight) + 1;
+  node.mStep = false;
+  ymuint id = mNodeList.size();
+  mNodeList.push_back(node);
+  mChildList.push_back(left);
+  mChildList.push_back(right);
+  return id;
+}
+
+// @brief 節点を作る．
+// @param[in] symbol 記号のトークン番号
+// @param[in] rule 規則番号 (葉の時は kNoNode)
+// @param[in] state 左端の状態番号
+ymuint
+IncrParser::new_node(ymuint symbol,
+		     ymuint rule,
+		     ymuint state)
+{
+  ymuint id = mNodeList.size();
+  Node node;
+  node.mSymbol = symbol;
+  node.mRule = rule;
+  node.mState = state;
+  node.mLength = rule == kNoNode ? 1 : 0;
+  node.mChildTop = mChildList.size();
+  node.mChildNum = 0;
+  node.mItemNum = 1;
+  node.mHeight = 0;
+  node.mStep = false;
+  mNodeList.push_back(node);
+  return id;
+}
+
+// @brief 根から到達できる節点だけを残して詰め直す．
+//
+// 根から幅優先でたどって写すので，各節点の子は連続した番号になる．
+void
+IncrParser::compact()
+{
+  vector<Node> node_list;
+  vector<ymuint> child_list;
+  node_list.reserve(mLiveNum * 2);
+  child_list.reserve(mLiveNum * 2);
+  node_list.push_back(mNodeList[mRoot]);
+  for (ymuint rpos = 0; rpos < node_list.size(); ++ rpos) {
+    ymuint top = node_list[rpos].mChildTop;
+    ymuint num = node_list[rpos].mChildNum;
+    node_list[rpos].mChildTop = child_list.size();
+    for (ymuint i = 0; i < num; ++ i) {
+      child_list.push_back(node_list.size());
+      node_list.push_back(mNodeList[mChildList[top + i]]);
+    }
+  }
+  mNodeList.swap(node_list);
+  mChildList.swap(child_list);
+  mRoot = 0;
+  mLiveNum = mNodeList.size();
+}
+
+// @brief 部分木を出力する．
+// @param[in] s 出力先のストリーム
+// @param[in] grammer 構文解析表の元となった文法
+// @param[in] id 節点番号
+void
+IncrParser::print_node(ostream& s,
+		       const Grammer& grammer,
+		       ymuint id) const
+{
+  const Node& node = mNodeList[id];
+  if ( node.mRule == kNoNode ) {
+    s << grammer.token(node.mSymbol)->str();
+    return;
+  }
+  if ( node.mRule == kListRule ) {
+    // 左再帰の規則で作った入れ子の形で出力する．
+    vector<ymuint> item_list;
+    get_items(id, item_list);
+    for (ymuint i = 1; i < item_list.size(); ++ i) {
+      s << "(" << grammer.token(node.mSymbol)->str() << " ";
+    }
+    print_node(s, grammer, item_list[0]);
+    for (ymuint i = 1; i < item_list.size(); ++ i) {
+      const Node& step = mNodeList[item_list[i]];
+      for (ymuint j = 0; j < step.mChildNum; ++ j) {
+	s << " ";
+	print_node(s, grammer, mChildList[step.mChildTop + j]);
+      }
+      s << ")";
+    }
+    return;
+  }
+  s << "(" << grammer.token(node.mSymbol)->str();
+  for (ymuint i = 0; i < node.mChildNum; ++ i) {
+    s << " ";
+    print_node(s, grammer, mChildList[node.mChildTop + i]);
+  }
+  s << ")";
+}
+
+// @brief 列の節点の要素を順に集める．
+// @param[in] id 節点番号
+// @param[out] item_list 要素を追加するリスト
+void
+IncrParser::get_items(ymuint id,
+		      vector<ymuint>& item_list) const
+{
+  const Node& node = mNodeList[id];
+  if ( node.mRule != kListRule ) {
+    item_list.push_back(id);
+    return;
+  }
+  get_items(mChildList[node.mChildTop], item_list);
+  get_items(mChildList[node.mChildTop + 1], item_list);
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,460 @@
+#ifndef INCRPARSER_H
+#define INCRPARSER_H
+
+/// @file IncrParser.h
+/// @brief IncrParser のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class ParseTable;
+class Grammer;
+
+//////////////////////////////////////////////////////////////////////
+/// @class IncrParser IncrParser.h "IncrParser.h"
+/// @brief 構文木を作り，入力の局所的な変更の後に再解析する構文解析器
+///
+/// parse() で入力全体を構文解析して構文木を作る．その後の入力の
+/// 変更は reparse() に新しい入力と変更された範囲で渡す．
+///
+/// 各節点は自分を積んだ時の状態 (左端の状態) と長さ (葉の数) を持つ．
+/// 再解析では変更前の木を左から順にたどり，現在の位置から始まる節点を
+/// 大きいものから順に再利用の候補とする．次の条件を満たす節点は
+/// 中を解析せずに goto で積む．
+/// - 左端の状態が現在の状態スタックの先頭と等しい．
+/// - 節点の範囲と直後のトークン (先読み) が変更された範囲に含まれない．
+/// LR 構文解析は決定的なので，同じ状態から同じトークン列と同じ先読みで
+/// 解析すると同じ部分木ができる．そのため結果の木は入力全体を
+/// 構文解析し直したものと同じになる．
+///
+/// 変更を含む節点 (変更箇所の祖先) は作り直すので，再解析の手間は木の
+/// 高さで決まる．そこで左再帰の規則 A -> A β で作るリストは，要素を
+/// 葉とする平衡二分木 (AVL 木) の列の節点で持つ．要素は先頭の A の節点と，
+/// 各 A -> A β の β だけを子に持つ節点 (段の節点) である．段の節点の左端の
+/// 状態はリストの左端の状態で，リストの途中から始まる部分列も，状態スタックの
+/// 先頭がその状態の上の A の時は中を解析せずにリストの末尾に加えられる．
+/// そのため変更より左と右のリストの部分は高さ程度の数の部分木として
+/// 再利用され，長いリストの要素の変更も木の高さに比例する手間で済む．
+/// 構文解析中に伸びるリストの段は一旦 mPendList に積み，リストが他の節点の
+/// 子になる時にまとめて平衡木にする．
+/// 右再帰の規則で作るリストは平衡させないので，長さに比例する手間がかかる．
+///
+/// 位置は節点に持たせず長さから求めるので，再利用した部分木を
+/// 書き換える必要はない．古い木の節点は残るが，作った節点数が
+/// 生きている節点数を超えた時に詰め直す．
+///
+/// 子の並びは ParseTable の reduce のものなので，単位規則の除去で
+/// 省略された A -> B の節点は現れない．
+/// 受理しなかった時は木を捨て，次の reparse() は parse() と同じになる．
+//////////////////////////////////////////////////////////////////////
+class IncrParser
+{
+public:
+
+  /// @brief 節点や規則がないことを表す番号
+  static
+  const ymuint kNoNode = 0xFFFFFFFFU;
+
+  /// @brief 左再帰のリストの節点の規則番号
+  static
+  const ymuint kListRule = 0xFFFFFFFEU;
+
+
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] table 構文解析表
+  IncrParser(const ParseTable& table);
+
+  /// @brief デストラクタ
+  ~IncrParser();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 入力全体を構文解析する．
+  /// @param[in] input 入力のトークン番号の列
+  /// @param[in] entry 入口番号
+  /// @return 受理した時 true を返す．
+  bool
+  parse(const vector<ymuint>& input,
+	ymuint entry = 0);
+
+  /// @brief 変更された入力を再解析する．
+  /// @param[in] input 変更後の入力のトークン番号の列
+  /// @param[in] edit_pos 変更された範囲の先頭位置
+  /// @param[in] old_len 変更前の範囲の長さ
+  /// @param[in] new_len 変更後の範囲の長さ
+  /// @return 受理した時 true を返す．
+  ///
+  /// 直前の構文解析の入力の [edit_pos, edit_pos + old_len) が
+  /// 長さ new_len のトークン列に置き換わったものが input である．
+  /// 入口番号は直前の構文解析と同じものを用いる．
+  bool
+  reparse(const vector<ymuint>& input,
+	  ymuint edit_pos,
+	  ymuint old_len,
+	  ymuint new_len);
+
+  /// @brief 直前の構文解析でエラーになった入力の位置を返す．
+  ///
+  /// 受理した時は入力の長さを返す．
+  ymuint
+  error_pos() const;
+
+  /// @brief 直前の構文解析で shift したトークン数を返す．
+  ///
+  /// 再利用した部分木の中のトークンは含まない．
+  ymuint
+  shift_num() const;
+
+  /// @brief 直前の構文解析で再利用した部分木の数を返す．
+  ymuint
+  reuse_num() const;
+
+  /// @brief 構文木の根を返す．
+  ///
+  /// 受理しなかった時は kNoNode を返す．
+  ymuint
+  root() const;
+
+  /// @brief 節点の記号のトークン番号を返す．
+  /// @param[in] id 節点番号
+  ymuint
+  node_symbol(ymuint id) const;
+
+  /// @brief 節点の規則番号を返す．
+  /// @param[in] id 節点番号
+  ///
+  /// 葉の時は kNoNode を，左再帰のリストの時は kListRule を返す．
+  /// リストの子は要素の並びで，先頭以外の要素は規則 A -> A β の
+  /// β だけを子に持つ．
+  ymuint
+  node_rule(ymuint id) const;
+
+  /// @brief 節点の長さ (葉の数) を返す．
+  /// @param[in] id 節点番号
+  ymuint
+  node_length(ymuint id) const;
+
+  /// @brief 節点の子の数を返す．
+  /// @param[in] id 節点番号
+  ymuint
+  node_child_num(ymuint id) const;
+
+  /// @brief 節点の子を返す．
+  /// @param[in] id 節点番号
+  /// @param[in] pos 位置番号 ( 0 <= pos < node_child_num(id) )
+  ymuint
+  node_child(ymuint id,
+	     ymuint pos) const;
+
+  /// @brief 構文木を括弧つきの形で出力する．
+  /// @param[in] s 出力先のストリーム
+  /// @param[in] grammer 構文解析表の元となった文法
+  ///
+  /// リストは左再帰の規則で作った入れ子の形で出力するので，
+  /// 平衡木の形によらない．
+  void
+  print_tree(ostream& s,
+	     const Grammer& grammer) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // 構文木の節点
+  struct Node
+  {
+    // 記号のトークン番号
+    ymuint mSymbol;
+
+    // 規則番号 (葉の時は kNoNode，列の節点の時は kListRule)
+    ymuint mRule;
+
+    // 左端の状態番号
+    ymuint mState;
+
+    // 長さ
+    ymuint mLength;
+
+    // mChildList 中の先頭位置
+    ymuint mChildTop;
+
+    // 子の数
+    ymuint mChildNum;
+
+    // 列の節点の時は要素数，それ以外は 1
+    ymuint mItemNum;
+
+    // 列の節点の時は高さ，それ以外は 0
+    // (要素数が 32 ビットに収まる AVL 木の高さは 46 以下)
+    ymuint8 mHeight;
+
+    // 段の節点 (A -> A β の β だけを子に持つ) の時 true
+    bool mStep;
+  };
+
+  // 状態スタックの要素
+  struct StackEntry
+  {
+    // 状態番号
+    ymuint mState;
+
+    // 一つ下の要素からの節点番号
+    ymuint mNode;
+
+    // 伸びているリストの時は末尾に加える段の mPendList 中の先頭位置
+    // (それ以外は kNoNode)
+    ymuint mPendTop;
+  };
+
+  // 再利用の候補
+  struct Candidate
+  {
+    // 節点番号
+    ymuint mNode;
+
+    // 変更前の開始位置
+    ymuint mStart;
+
+    // 列の節点がリストの先頭から始まる時 true
+    bool mHead;
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 構文解析を行う．
+  /// @param[in] input 入力のトークン番号の列
+  /// @param[in] old_root 再利用する木の根 (kNoNode なら再利用しない)
+  bool
+  run(const vector<ymuint>& input,
+      ymuint old_root);
+
+  /// @brief 変更前の位置 old_pos から始まる再利用の候補を返す．
+  ///
+  /// なければ kNoNode を返す．
+  ymuint
+  candidate(ymuint old_pos);
+
+  /// @brief 部分列の節点を状態スタックの先頭のリストの末尾に加えられる時 true を返す．
+  /// @param[in] id 段の節点か途中から始まる列の節点
+  bool
+  can_append(ymuint id) const;
+
+  /// @brief 状態スタックの要素の伸びているリストを平衡木にまとめる．
+  /// @param[in] sp 状態スタック中の位置
+  void
+  close_list(ymuint sp);
+
+  /// @brief 要素の列から平衡木を作る．
+  /// @param[in] begin, end mPendList 中の範囲
+  ymuint
+  build_list(ymuint begin,
+	     ymuint end);
+
+  /// @brief 二つの平衡木をつなげる．
+  /// @param[in] left, right 木の根 (要素の節点でもよい)
+  ymuint
+  join_list(ymuint left,
+	    ymuint right);
+
+  /// @brief 列の節点を作る．
+  /// @param[in] left, right 子の節点
+  ///
+  /// left と right の高さの差は 1 以下でなければならない．
+  ymuint
+  new_seq(ymuint left,
+	  ymuint right);
+
+  /// @brief 先頭の候補を子に置き換える．
+  void
+  split_candidate();
+
+  /// @brief reduce を行う．
+  /// @param[in] rule 規則番号
+  /// @param[in] leaf 最後の子に加える葉 (kNoNode なら加えない)
+  void
+  reduce(ymuint rule,
+	 ymuint leaf);
+
+  /// @brief 節点を作る．
+  /// @param[in] symbol 記号のトークン番号
+  /// @param[in] rule 規則番号 (葉の時は kNoNode)
+  /// @param[in] state 左端の状態番号
+  ymuint
+  new_node(ymuint symbol,
+	   ymuint rule,
+	   ymuint state);
+
+  /// @brief 根から到達できる節点だけを残して詰め直す．
+  void
+  compact();
+
+  /// @brief 部分木を出力する．
+  /// @param[in] s 出力先のストリーム
+  /// @param[in] grammer 構文解析表の元となった文法
+  /// @param[in] id 節点番号
+  void
+  print_node(ostream& s,
+	     const Grammer& grammer,
+	     ymuint id) const;
+
+  /// @brief 列の節点の要素を順に集める．
+  /// @param[in] id 節点番号
+  /// @param[out] item_list 要素を追加するリスト
+  void
+  get_items(ymuint id,
+	    vector<ymuint>& item_list) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 構文解析表
+  const ParseTable& mTable;
+
+  // 節点の配列
+  vector<Node> mNodeList;
+
+  // 子の節点番号の配列
+  vector<ymuint> mChildList;
+
+  // 状態スタック
+  vector<StackEntry> mStack;
+
+  // 再利用の候補のスタック
+  // 先頭が変更前の位置で最も左の候補である．
+  vector<Candidate> mCandList;
+
+  // 伸びているリストの末尾に加える段や部分列の節点のスタック
+  // 状態スタックの上の要素のものほど後ろにある．
+  vector<ymuint> mPendList;
+
+  // 入口番号
+  ymuint mEntry;
+
+  // 直前の入力の長さ
+  ymuint mInputLen;
+
+  // 変更された範囲の先頭位置
+  ymuint mEditPos;
+
+  // 変更前の範囲の長さ
+  ymuint mOldLen;
+
+  // 変更後の範囲の長さ
+  ymuint mNewLen;
+
+  // 直前に詰め直した時の節点数
+  ymuint mLiveNum;
+
+  // エラーになった位置
+  ymuint mErrorPos;
+
+  // shift したトークン数
+  ymuint mShiftNum;
+
+  // 再利用した部分木の数
+  ymuint mReuseNum;
+
+  // 構文木の根
+  ymuint mRoot;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 直前の構文解析でエラーになった入力の位置を返す．
+inline
+ymuint
+IncrParser::error_pos() const
+{
+  return mErrorPos;
+}
+
+// @brief 直前の構文解析で shift したトークン数を返す．
+inline
+ymuint
+IncrParser::shift_num() const
+{
+  return mShiftNum;
+}
+
+// @brief 直前の構文解析で再利用した部分木の数を返す．
+inline
+ymuint
+IncrParser::reuse_num() const
+{
+  return mReuseNum;
+}
+
+// @brief 構文木の根を返す．
+inline
+ymuint
+IncrParser::root() const
+{
+  return mRoot;
+}
+
+// @brief 節点の記号のトークン番号を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+IncrParser::node_symbol(ymuint id) const
+{
+  return mNodeList[id].mSymbol;
+}
+
+// @brief 節点の規則番号を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+IncrParser::node_rule(ymuint id) const
+{
+  return mNodeList[id].mRule;
+}
+
+// @brief 節点の長さ (葉の数) を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+IncrParser::node_length(ymuint id) const
+{
+  return mNodeList[id].mLength;
+}
+
+// @brief 節点の子の数を返す．
+// @param[in] id 節点番号
+inline
+ymuint
+IncrParser::node_child_num(ymuint id) const
+{
+  const Node& node = mNodeList[id];
+  return node.mRule == kListRule ? node.mItemNum : node.mChildNum;
+}
+
+END_NAMESPACE_YM
+
+#endif // INCRPARSER_H
@@ -14,14 +14,14 @@
 #include "LR1Term.h"
 #include "Rule.h"
 #include "Token.h"
+#include "BuildStats.h"
+#include "PhaseProfiler.h"
 
 
 BEGIN_NAMESPACE_YM
 
 BEGIN_NONAMESPACE
 
-const int debug = 1;
-
 struct Action
 {
   Action(LR0State* state = NULL) :
@@ -36,19 +36,22 @@ struct Action
   vector<const Rule*> reduce_list;
 };
 
+// @brief LR(1)項集合の閉包を求める．
+// @param[in] grammer 元となる文法
+// @param[in] input 入力の項集合
+// @param[out] output 閉包集合
+// @param[in] tracer トレースの出力先
+// @param[in] stats 統計情報の記録先
 void
 LR1_closure(Grammer* grammer,
 	    const vector<LR1Term>& input,
-	    vector<LR1Term>& output)
+	    vector<LR1Term>& output,
+	    const Tracer& tracer,
+	    BuildStats* stats)
 {
-  if ( debug ) {
-    cout << "LR1_closure" << endl;
-    for (vector<LR1Term>::const_iterator p = input.begin();
-	 p != input.end(); ++ p) {
-      const LR1Term& term = *p;
-      cout << term << endl;
-    }
-    cout << endl;
+  PhaseTimer timer(stats, BuildStats::kClosure);
+  if ( stats != NULL ) {
+    stats->add_count(BuildStats::kClosureNum);
   }
 
   for (vector<LR1Term>::const_iterator p = input.begin();
@@ -92,15 +95,7 @@ LR1_closure(Grammer* grammer,
     }
   }
 
-  if ( debug ) {
-    cout << "LR1_closure end" << endl;
-    for (vector<LR1Term>::const_iterator p = output.begin();
-	 p != output.end(); ++ p) {
-      const LR1Term& term = *p;
-      cout << term << endl;
-    }
-    cout << endl;
-  }
+  PARSER_TRACE(tracer, kTraceClosure, lr1_closure(input, output));
 }
 
 END_NONAMESPACE
@@ -111,9 +106,16 @@ END_NONAMESPACE
 
 // @brief コンストラクタ
 // @param[in] grammer 元となる文法
-LALR1Set::LALR1Set(Grammer* grammer) :
-  LR0Set(grammer)
+// @param[in] tracer トレースの出力先
+// @param[in] stats 統計情報の記録先
+LALR1Set::LALR1Set(Grammer* grammer,
+		   const Tracer& tracer,
+		   BuildStats* stats) :
+  LR0Set(grammer, tracer, stats)
 {
+  PhaseProfiler profiler(stats);
+  stats = profiler.stats();
+
   mTermNum = 0;
   for (vector<LR0State*>::const_iterator p = state_list().begin();
        p != state_list().end(); ++ p) {
@@ -127,28 +129,25 @@ LALR1Set::LALR1Set(Grammer* grammer) :
   }
 
   // 先読みの計算をする．
+  PhaseTimer gen_timer(stats, BuildStats::kGeneration);
   vector<pair<ymuint, const Token*> > gen_list;
   vector<vector<ymuint> > prop_list(mTermNum, vector<ymuint>(0));
-  const Rule* start_rule = grammer->start_rule();
   const Token* dummy = grammer->token(Grammer::kNotExist);
   for (vector<LR0State*>::const_iterator p = state_list().begin();
        p != state_list().end(); ++ p) {
     LR0State* state = *p;
-    if ( debug ) {
-      cout << "State#" << state->id() << endl;
-    }
     const vector<LR0Term>& term_list = state->term_list();
     ymuint n = term_list.size();
     for (ymuint i = 0; i < n; ++ i) {
       const LR0Term& term = term_list[i];
       const Rule* rule = term.rule();
       ymuint pos = term.dot_pos();
-      if ( rule != start_rule && pos == 0 ) {
+      if ( rule->left()->id() != Grammer::kStart && pos == 0 ) {
 	// 非カーネル項は除外する．
 	continue;
       }
       vector<LR1Term> tmp_list;
-      LR1_closure(grammer, vector<LR1Term>(1, LR1Term(rule, pos, dummy)), tmp_list);
+      LR1_closure(grammer, vector<LR1Term>(1, LR1Term(rule, pos, dummy)), tmp_list, tracer, stats);
       for (vector<LR1Term>::iterator q = tmp_list.begin();
 	   q != tmp_list.end(); ++ q) {
 	const Rule* rule1 = q->rule();
@@ -156,6 +155,28 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	const Token* token1 = q->token();
 	const Token* next_token = q->next_token();
 	if ( next_token == NULL ) {
+	  if ( rule1->right_size() == 0 ) {
+	    // 右辺が空の規則の項は非カーネル項だが reduce 動作の
+	    // ために同じ状態内で先読みを求めておく必要がある．
+	    for (ymuint i2 = 0; i2 < n; ++ i2) {
+	      const LR0Term& term2 = term_list[i2];
+	      if ( term2.rule() == rule1 ) {
+		ymuint dst_id = calc_term_id(state->id(), i2);
+		if ( token1 == dummy ) {
+		  ymuint src_id = calc_term_id(state->id(), i);
+		  prop_list[src_id].push_back(dst_id);
+		  PARSER_TRACE(tracer, kTracePropagation,
+			       propagation(state, i, state, i2));
+		}
+		else {
+		  gen_list.push_back(make_pair(dst_id, token1));
+		  PARSER_TRACE(tracer, kTraceGeneration,
+			       generation(state, i2, token1));
+		}
+		break;
+	      }
+	    }
+	  }
 	  continue;
 	}
 	LR0State* state2 = state->next_state(next_token);
@@ -171,10 +192,8 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	      ymuint dst_id = calc_term_id(state2->id(), i2);
 	      prop_list[src_id].push_back(dst_id);
 
-	      if ( debug ) {
-		cout << "Propagation: " << endl
-		     << (*q) << endl;
-	      }
+	      PARSER_TRACE(tracer, kTracePropagation,
+			   propagation(state, i, state2, i2));
 	      break;
 	    }
 	  }
@@ -187,38 +206,43 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	      ymuint dst_id = calc_term_id(state2->id(), i2);
 	      gen_list.push_back(make_pair(dst_id, token1));
 
-	      if ( debug ) {
-		cout << "Generation: " << token1->str() << endl
-		     << term2 << endl;
-	      }
+	      PARSER_TRACE(tracer, kTraceGeneration,
+			   generation(state2, i2, token1));
 	      break;
 	    }
 	  }
 	}
       }
-      if ( debug ) {
-	cout << endl;
-      }
     }
   }
 
-  // S' -> . S, $ という先読みを追加する．
-  ymuint start_id;
-  {
-    LR0State* state0 = start_state();
+  // 入口ごとに S' -> . S, $ という先読みを追加する．
+  const Token* end = grammer->token(Grammer::kEnd);
+  for (ymuint k = 0; k < start_num(); ++ k) {
+    LR0State* state0 = start_state(k);
     const vector<LR0Term>& term_list = state0->term_list();
     ymuint n = term_list.size();
     for (ymuint i = 0; i < n; ++ i) {
-      if ( term_list[i].rule() == grammer->start_rule() ) {
-	start_id = calc_term_id(state0->id(), i);
+      if ( term_list[i].rule() == grammer->start_rule(k) ) {
+	gen_list.push_back(make_pair(calc_term_id(state0->id(), i), end));
 	break;
       }
     }
   }
-  const Token* end = grammer->token(Grammer::kEnd);
-  gen_list.push_back(make_pair(start_id, end));
+  gen_timer.stop();
+
+  if ( stats != NULL ) {
+    ymuint64 edge_num = 0;
+    for (vector<vector<ymuint> >::const_iterator p = prop_list.begin();
+	 p != prop_list.end(); ++ p) {
+      edge_num += p->size();
+    }
+    stats->set_count(BuildStats::kPropEdgeNum, edge_num);
+    stats->update_peak(BuildStats::kMemPropagation, vector_bytes(prop_list));
+  }
 
   // 処理するトークンがなくなるまで以下の処理を繰り返す．
+  PhaseTimer prop_timer(stats, BuildStats::kPropagation);
   for (ymuint rpos = 0; rpos < gen_list.size(); ++ rpos) {
     ymuint term_id = gen_list[rpos].first;
     const Token* token = gen_list[rpos].second;
@@ -259,30 +283,33 @@ LALR1Set::LALR1Set(Grammer* grammer) :
       token_list.push_back(token);
     }
   }
+  prop_timer.stop();
+
+  if ( stats != NULL ) {
+    stats->set_count(BuildStats::kLookaheadNum, gen_list.size());
+    stats->update_peak(BuildStats::kMemGeneration, vector_bytes(gen_list));
+    stats->update_peak(BuildStats::kMemLookahead, vector_bytes(mTokenList));
+  }
 
-  if ( debug ) {
+#if PARSER_ENABLE_TRACE
+  if ( tracer.enabled(kTraceLookahead) ) {
     for (vector<LR0State*>::const_iterator p = state_list().begin();
 	 p != state_list().end(); ++ p) {
       LR0State* state = *p;
-      cout << "State#" << state->id() << endl;
-      const vector<LR0Term>& term_list = state->term_list();
-      ymuint n = term_list.size();
+      ymuint n = state->term_list().size();
       for (ymuint i = 0; i < n; ++ i) {
-	const LR0Term& term = term_list[i];
-	cout << term << ", ";
-	const vector<const Token*>& token_list1 = token_list(state->id(), i);
-	for (vector<const Token*>::const_iterator p = token_list1.begin();
-	     p != token_list1.end(); ++ p) {
-	  cout << " " << (*p)->str();
-	}
-	cout << endl;
+	tracer.sink()->lookahead(state, i, token_list(state->id(), i));
       }
-      cout << endl;
     }
   }
+#endif
+
+  PhaseTimer action_timer(stats, BuildStats::kAction);
 
   mShiftList.resize(state_list().size());
   mReduceList.resize(state_list().size());
+  mConflictList.resize(state_list().size());
+  mAcceptStateList.resize(start_num(), 0);
 
   // 動作表を作る．
   for (vector<LR0State*>::const_iterator p = state_list().begin();
@@ -302,6 +329,7 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 
     // reduce 動作の生成
     HashMap<ymuint, pair<const Rule*, LR0State*> > reduce_map;
+    ymuint accept_pos = 0;
     const vector<LR0Term>& term_list = state->term_list();
     ymuint n = term_list.size();
     for (ymuint i = 0; i < n; ++ i) {
@@ -310,10 +338,13 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	continue;
       }
       const Rule* rule = term.rule();
-      if ( rule == grammer->start_rule() ) {
+      if ( rule->left()->id() == Grammer::kStart ) {
 	// $ -> accept を記録
 	ymuint end_id = Grammer::kEnd;
 	action_map.add(end_id, new Action());
+	while ( grammer->start_rule(accept_pos) != rule ) {
+	  ++ accept_pos;
+	}
       }
       else {
 	const vector<const Token*>& token_list1 = token_list(state->id(), i);
@@ -366,6 +397,7 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 
     vector<pair<const Token*, ymuint> >& shift_list = mShiftList[state->id()];
     vector<pair<const Token*, const Rule*> >& reduce_list = mReduceList[state->id()];
+    vector<pair<const Token*, const Rule*> >& conflict_list = mConflictList[state->id()];
     for (HashMapIterator<ymuint, Action*> q = action_map.begin();
 	 q != action_map.end(); ++ q) {
       ymuint token_id = q.key();
@@ -377,6 +409,12 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	    const Rule* rule = *r;
 	    // shift/reduce conflict
 	    cerr << "warning: shift/reduce conflict" << endl;
+	    if ( stats != NULL ) {
+	      stats->add_count(BuildStats::kConflictNum);
+	    }
+	    PARSER_TRACE(tracer, kTraceConflict,
+			 shift_reduce_conflict(state, grammer->token(token_id), rule));
+	    conflict_list.push_back(make_pair(grammer->token(token_id), rule));
 	  }
 	}
 	// shift token_id, action->shift_next を記録
@@ -386,7 +424,7 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	ymuint n = action->reduce_list.size();
 	if ( n == 0 ) {
 	  ASSERT_COND( token_id == Grammer::kEnd );
-	  mAcceptState = state->id();
+	  mAcceptStateList[accept_pos] = state->id();
 	}
 	else {
 	  ASSERT_COND( n > 0 );
@@ -395,6 +433,14 @@ LALR1Set::LALR1Set(Grammer* grammer) :
 	    // reduce/reduce conflict
 	    for (ymuint i = 1; i < n; ++ i) {
 	      cerr << "warning: reduce/reduce conflict" << endl;
+	      if ( stats != NULL ) {
+		stats->add_count(BuildStats::kConflictNum);
+	      }
+	      PARSER_TRACE(tracer, kTraceConflict,
+			   reduce_reduce_conflict(state, grammer->token(token_id),
+						  rule0, action->reduce_list[i]));
+	      conflict_list.push_back(make_pair(grammer->token(token_id),
+						action->reduce_list[i]));
 	    }
 	  }
 	  // reduce token_id, rule0 を記録
@@ -405,6 +451,20 @@ LALR1Set::LALR1Set(Grammer* grammer) :
       delete action;
     }
   }
+
+  if ( stats != NULL ) {
+    ymuint64 shift_num = 0;
+    ymuint64 reduce_num = 0;
+    for (ymuint i = 0; i < mShiftList.size(); ++ i) {
+      shift_num += mShiftList[i].size();
+      reduce_num += mReduceList[i].size();
+    }
+    stats->set_count(BuildStats::kShiftNum, shift_num);
+    stats->set_count(BuildStats::kReduceNum, reduce_num);
+    stats->update_peak(BuildStats::kMemAction,
+		       vector_bytes(mShiftList) + vector_bytes(mReduceList)
+		       + vector_bytes(mConflictList));
+  }
 }
 
 // @brief デストラクタ
@@ -423,6 +483,42 @@ LALR1Set::token_list(ymuint state_id,
   return mTokenList[term_id];
 }
 
+// @brief shift 動作のリストを返す．
+// @param[in] state_id 状態番号
+const vector<pair<const Token*, ymuint> >&
+LALR1Set::shift_list(ymuint state_id) const
+{
+  ASSERT_COND( state_id < mShiftList.size() );
+  return mShiftList[state_id];
+}
+
+// @brief reduce 動作のリストを返す．
+// @param[in] state_id 状態番号
+const vector<pair<const Token*, const Rule*> >&
+LALR1Set::reduce_list(ymuint state_id) const
+{
+  ASSERT_COND( state_id < mReduceList.size() );
+  return mReduceList[state_id];
+}
+
+// @brief 衝突で捨てた reduce 動作のリストを返す．
+// @param[in] state_id 状態番号
+const vector<pair<const Token*, const Rule*> >&
+LALR1Set::conflict_list(ymuint state_id) const
+{
+  ASSERT_COND( state_id < mConflictList.size() );
+  return mConflictList[state_id];
+}
+
+// @brief 受理する直前の状態番号を返す．
+// @param[in] pos 入口番号
+ymuint
+LALR1Set::accept_state(ymuint pos) const
+{
+  ASSERT_COND( pos < mAcceptStateList.size() );
+  return mAcceptStateList[pos];
+}
+
 // @brief 内容を出力する．
 // @param[in] s 出力先のストリーム
 void
@@ -445,7 +541,7 @@ LALR1Set::print(ostream& s) const
       const Token* token = p->first;
 
       ymuint next_id = p->second;
-      if ( token->rule_list().empty() ) {
+      if ( token->is_terminal() ) {
 	s << token->str() << ": shift State#" << next_id << endl;
       }
       else {
@@ -461,8 +557,10 @@ LALR1Set::print(ostream& s) const
       s << token->str() << ": reduce Rule#" << rule->id() << endl;
     }
 
-    if ( mAcceptState == state->id() ) {
-      s << "_end_: accept" << endl;
+    for (ymuint k = 0; k < mAcceptStateList.size(); ++ k) {
+      if ( mAcceptStateList[k] == state->id() ) {
+	s << "_end_: accept" << endl;
+      }
     }
 
     s << endl;
@@ -17,6 +17,7 @@ BEGIN_NAMESPACE_YM
 
 class Token;
 class Rule;
+class BuildStats;
 
 //////////////////////////////////////////////////////////////////////
 /// @class LALR1Set LALR1Set.h "LALR1Set.h"
@@ -28,7 +29,11 @@ public:
 
   /// @brief コンストラクタ
   /// @param[in] grammer 元となる文法
-  LALR1Set(Grammer* grammer);
+  /// @param[in] tracer トレースの出力先
+  /// @param[in] stats 統計情報の記録先
+  LALR1Set(Grammer* grammer,
+	   const Tracer& tracer = Tracer(),
+	   BuildStats* stats = NULL);
 
   /// @brief デストラクタ
   ~LALR1Set();
@@ -46,6 +51,34 @@ public:
   token_list(ymuint state_id,
 	     ymuint local_term_id) const;
 
+  /// @brief shift 動作のリストを返す．
+  /// @param[in] state_id 状態番号
+  ///
+  /// 非終端記号に対する要素は goto 動作を表す．
+  const vector<pair<const Token*, ymuint> >&
+  shift_list(ymuint state_id) const;
+
+  /// @brief reduce 動作のリストを返す．
+  /// @param[in] state_id 状態番号
+  const vector<pair<const Token*, const Rule*> >&
+  reduce_list(ymuint state_id) const;
+
+  /// @brief 衝突で捨てた reduce 動作のリストを返す．
+  /// @param[in] state_id 状態番号
+  ///
+  /// shift/reduce 衝突では shift を残して全ての reduce を，
+  /// reduce/reduce 衝突では最初の規則を残して残りの reduce を捨てる．
+  /// 優先順位と結合性で解消したものは含まない．
+  const vector<pair<const Token*, const Rule*> >&
+  conflict_list(ymuint state_id) const;
+
+  /// @brief 受理する直前の状態番号を返す．
+  /// @param[in] pos 入口番号 ( 0 <= pos < start_num() )
+  ///
+  /// この状態で文末記号を読んだら受理する．
+  ymuint
+  accept_state(ymuint pos = 0) const;
+
   /// @brief 内容を出力する．
   /// @param[in] s 出力先のストリーム
   void
@@ -85,8 +118,11 @@ private:
   // 各状態ごとの reduce 動作リスト
   vector<vector<pair<const Token*, const Rule*> > > mReduceList;
 
-  // 受理する直前の状態番号
-  ymuint mAcceptState;
+  // 各状態ごとの衝突で捨てた reduce 動作リスト
+  vector<vector<pair<const Token*, const Rule*> > > mConflictList;
+
+  // 入口番号をキーにした受理する直前の状態番号の配列
+  vector<ymuint> mAcceptStateList;
 
 };
 
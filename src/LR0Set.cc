@@ -13,6 +13,8 @@
 #include "LR0Term.h"
 #include "Rule.h"
 #include "Token.h"
+#include "BuildStats.h"
+#include "PhaseProfiler.h"
 #include "YmUtils/HashSet.h"
 
 
@@ -20,8 +22,6 @@ BEGIN_NAMESPACE_YM
 
 BEGIN_NONAMESPACE
 
-const int debug = 0;
-
 // LR0Term の比較関数
 struct LR0TermLt
 {
@@ -51,17 +51,17 @@ struct LR0TermLt
 // @brief 項集合の閉包を求める．
 // @param[in] input 入力の項集合
 // @param[out] output 閉包集合
+// @param[in] tracer トレースの出力先
+// @param[in] stats 統計情報の記録先
 void
 closure(const vector<LR0Term>& input,
-	vector<LR0Term>& output)
+	vector<LR0Term>& output,
+	const Tracer& tracer,
+	BuildStats* stats)
 {
-  if ( debug ) {
-    cout << "LR(0) closure:" << endl;
-    for (vector<LR0Term>::const_iterator p = input.begin();
-	 p != input.end(); ++ p) {
-      cout << *p << endl;
-    }
-    cout << endl;
+  PhaseTimer timer(stats, BuildStats::kClosure);
+  if ( stats != NULL ) {
+    stats->add_count(BuildStats::kClosureNum);
   }
 
   // 入力をコピーする．
@@ -100,24 +100,21 @@ closure(const vector<LR0Term>& input,
   // ソートしておく．
   sort(output.begin(), output.end(), LR0TermLt());
 
-  if ( debug ) {
-    cout << "LR(0) closure end:" << endl;
-    for (vector<LR0Term>::const_iterator p = output.begin();
-	 p != output.end(); ++ p) {
-      cout << *p << endl;
-    }
-    cout << endl;
-  }
+  PARSER_TRACE(tracer, kTraceClosure, lr0_closure(input, output));
 }
 
 // @brief 遷移先の項集合を求める．
 // @param[in] cur_state 現在の状態
 // @param[in] token 次のトークン
 // @param[out] next_terms 遷移先の状態を表す項集合
+// @param[in] tracer トレースの出力先
+// @param[in] stats 統計情報の記録先
 void
 next_state(LR0State* cur_state,
 	   const Token* token,
-	   vector<LR0Term>& next_terms)
+	   vector<LR0Term>& next_terms,
+	   const Tracer& tracer,
+	   BuildStats* stats)
 {
   // 次のトークンが token に等しい項の dot を進めた項を tmp_terms に入れる．
   vector<LR0Term> tmp_terms;
@@ -132,7 +129,7 @@ next_state(LR0State* cur_state,
     }
   }
   // その閉包を求める．
-  closure(tmp_terms, next_terms);
+  closure(tmp_terms, next_terms, tracer, stats);
 }
 
 END_NONAMESPACE
@@ -164,27 +161,32 @@ HashFunc<vector<ymuint64> >
 
 // @brief コンストラクタ
 // @param[in] grammer 元となる文法
-LR0Set::LR0Set(Grammer* grammer)
+// @param[in] tracer トレースの出力先
+// @param[in] stats 統計情報の記録先
+LR0Set::LR0Set(Grammer* grammer,
+	       const Tracer& tracer,
+	       BuildStats* stats)
 {
-  // 初期状態は明示的に作る．
-  // start_state = closure( {S'-> . S} )
-  vector<LR0Term> start_terms;
-  const vector<const Rule*>& rule_list = grammer->token(0)->rule_list();
-  ASSERT_COND ( rule_list.size() == 1 );
-  start_terms.push_back(LR0Term(rule_list[0], 0));
-  vector<LR0Term> tmp_terms;
-  closure(start_terms, tmp_terms);
+  PhaseProfiler profiler(stats);
+  stats = profiler.stats();
+  PhaseTimer timer(stats, BuildStats::kLR0);
 
+  // 初期状態は入口ごとに明示的に作る．
+  // start_state = closure( {S'-> . S} )
   HashMap<vector<ymuint64>, LR0State*> state_hash;
-  mStartState = new_state(grammer, state_hash, tmp_terms);
+  ymuint ns = grammer->start_num();
+  ASSERT_COND( ns > 0 );
+  for (ymuint i = 0; i < ns; ++ i) {
+    vector<LR0Term> start_terms;
+    start_terms.push_back(LR0Term(grammer->start_rule(i), 0));
+    vector<LR0Term> tmp_terms;
+    closure(start_terms, tmp_terms, tracer, stats);
+    mStartStateList.push_back(new_state(grammer, state_hash, tmp_terms, tracer));
+  }
 
   // mStateList に未処理の状態が残っている限り以下の処理を繰り返す．
   for (ymuint rpos = 0; rpos < mStateList.size(); ++ rpos) {
     LR0State* cur_state = mStateList[rpos];
-    if ( debug ) {
-      cur_state->print(cout);
-      cout << endl;
-    }
     // cur_state に関係するトークンを取り出す．
     const vector<const Token*>& token_list = cur_state->token_list();
     for (vector<const Token*>::const_iterator p = token_list.begin();
@@ -192,14 +194,40 @@ LR0Set::LR0Set(Grammer* grammer)
       const Token* token = *p;
       // token に対する次状態を求める．
       vector<LR0Term> tmp_terms;
-      next_state(cur_state, token, tmp_terms);
+      next_state(cur_state, token, tmp_terms, tracer, stats);
       // tmp_terms に対応する状態を作る．
       // 場合によっては既存の状態を再利用する．
-      LR0State* state1 = new_state(grammer, state_hash, tmp_terms);
+      LR0State* state1 = new_state(grammer, state_hash, tmp_terms, tracer);
       // それを cur_state の遷移先に設定する．
       cur_state->add_next_state(token, state1);
     }
   }
+
+  if ( stats != NULL ) {
+    ymuint64 item_num = 0;
+    ymuint64 trans_num = 0;
+    ymuint64 state_bytes = vector_bytes(mStateList);
+    for (vector<LR0State*>::const_iterator p = mStateList.begin();
+	 p != mStateList.end(); ++ p) {
+      LR0State* state = *p;
+      item_num += state->term_list().size();
+      trans_num += state->token_list().size();
+      state_bytes += sizeof(LR0State) + vector_bytes(state->term_list());
+    }
+    // 遷移はトークンのリストとハッシュ表の要素(キー，値，リンク)からなる．
+    ymuint64 trans_bytes = trans_num * (sizeof(const Token*) + sizeof(ymuint)
+					+ sizeof(LR0State*) + sizeof(void*));
+    // シグネチャのハッシュ表の要素(キー，値，リンク)
+    ymuint64 ns = (grammer->term_size() + 63) / 64;
+    ymuint64 hash_bytes = mStateList.size() * (sizeof(vector<ymuint64>) + ns * sizeof(ymuint64)
+					       + sizeof(LR0State*) + sizeof(void*));
+    stats->set_count(BuildStats::kStateNum, mStateList.size());
+    stats->set_count(BuildStats::kItemNum, item_num);
+    stats->set_count(BuildStats::kTransitionNum, trans_num);
+    stats->update_peak(BuildStats::kMemStates, state_bytes);
+    stats->update_peak(BuildStats::kMemTransitions, trans_bytes);
+    stats->update_peak(BuildStats::kMemStateHash, hash_bytes);
+  }
 }
 
 // @brief デストラクタ
@@ -218,23 +246,34 @@ LR0Set::state_list() const
   return mStateList;
 }
 
+// @brief 入口の数を返す．
+ymuint
+LR0Set::start_num() const
+{
+  return mStartStateList.size();
+}
+
 // @brief 初期状態を返す．
+// @param[in] pos 入口番号
 LR0State*
-LR0Set::start_state() const
+LR0Set::start_state(ymuint pos) const
 {
-  return mStartState;
+  ASSERT_COND( pos < mStartStateList.size() );
+  return mStartStateList[pos];
 }
 
 // @brief 状態を追加する．
 // @param[in] grammer 元となる文法
 // @param[in] terms 状態を表す項集合
+// @param[in] tracer トレースの出力先
 // @return 対応する状態を返す．
 //
 // すでに等価は状態が存在したらその状態を返す．
 LR0State*
 LR0Set::new_state(Grammer* grammer,
 		  HashMap<vector<ymuint64>, LR0State*>& state_map,
-		  const vector<LR0Term>& terms)
+		  const vector<LR0Term>& terms,
+		  const Tracer& tracer)
 {
   // シグネチャを作る．
   ymuint n = grammer->term_size();
@@ -260,6 +299,9 @@ LR0Set::new_state(Grammer* grammer,
   state = new LR0State(id, terms);
   mStateList.push_back(state);
   state_map.add(sig, state);
+
+  PARSER_TRACE(tracer, kTraceState, new_state(state));
+
   return state;
 }
 
@@ -11,17 +11,21 @@
 
 #include "YmTools.h"
 #include "YmUtils/HashMap.h"
+#include "Trace.h"
 
 
 BEGIN_NAMESPACE_YM
 
 class Grammer;
+class BuildStats;
 class LR0State;
 class LR0Term;
 
 //////////////////////////////////////////////////////////////////////
 /// @class LR0Set LR0Set.h "LR0Set.h"
 /// @brief LR(0)正準集を表すクラス
+///
+/// 文法の入口ごとに初期状態を持ち，それ以外の状態は共有する．
 //////////////////////////////////////////////////////////////////////
 class LR0Set
 {
@@ -29,7 +33,11 @@ public:
 
   /// @brief コンストラクタ
   /// @param[in] grammer 元となる文法
-  LR0Set(Grammer* grammer);
+  /// @param[in] tracer トレースの出力先
+  /// @param[in] stats 統計情報の記録先
+  LR0Set(Grammer* grammer,
+	 const Tracer& tracer = Tracer(),
+	 BuildStats* stats = NULL);
 
   /// @brief デストラクタ
   ~LR0Set();
@@ -44,9 +52,14 @@ public:
   const vector<LR0State*>&
   state_list() const;
 
+  /// @brief 入口の数を返す．
+  ymuint
+  start_num() const;
+
   /// @brief 初期状態を返す．
+  /// @param[in] pos 入口番号 ( 0 <= pos < start_num() )
   LR0State*
-  start_state() const;
+  start_state(ymuint pos = 0) const;
 
   /// @brief 内容を出力する．
   /// @param[in] s 出力先のストリーム
@@ -63,13 +76,15 @@ private:
   /// @param[in] grammer 元となる文法
   /// @param[in] state_map シグネチャをキーにして状態を収めたハッシュ表
   /// @param[in] terms 状態を表す項集合
+  /// @param[in] tracer トレースの出力先
   /// @return 対応する状態を返す．
   ///
   /// すでに等価は状態が存在したらその状態を返す．
   LR0State*
   new_state(Grammer* grammer,
 	    HashMap<vector<ymuint64>, LR0State*>& state_map,
-	    const vector<LR0Term>& terms);
+	    const vector<LR0Term>& terms,
+	    const Tracer& tracer);
 
 
 private:
@@ -80,8 +95,8 @@ private:
   // 状態のリスト
   vector<LR0State*> mStateList;
 
-  // 初期状態
-  LR0State* mStartState;
+  // 入口番号をキーにした初期状態の配列
+  vector<LR0State*> mStartStateList;
 
 };
 
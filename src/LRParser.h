@@ -0,0 +1,383 @@
+#ifndef LRPARSER_H
+#define LRPARSER_H
+
+/// @file LRParser.h
+/// @brief LRParserT のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include "ParseTable.h"
+#include "Grammer.h"
+#include "ParseProfile.h"
+#include "ParseCounter.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class LRParserT LRParser.h "LRParser.h"
+/// @brief 構文解析表を用いて構文解析を行うクラステンプレート
+///
+/// TableType は ParseTable と同じ名前の start_num(), start_state(),
+/// token_num(), rule_num(), action(), default_action(), goto_state(),
+/// rule_left(), rule_size() を持ち (set_profile() を用いる時は
+/// state_num() も持ち)，動作のコードが ParseTable と同じ形式の型である．
+/// CounterType は計数方針で，ParseCounter と同じ名前の clear() と
+/// count_xxx() を持つ．既定の NullParseCounter では計数の処理は
+/// コンパイル時に取り除かれる．
+/// ParseTable の他に PackedTable を用いることができる．
+///
+/// 入力はトークン番号の列で，文末記号は含まない．
+/// 意味動作は持たず，受理するかどうかだけを判定する．
+/// 状態スタックは呼び出しの間で再利用される．
+///
+/// 入力を少しずつ受け取る場合は start() の後に push() でトークンを
+/// 一つずつ渡し，最後に Grammer::kEnd を渡す．push() の間で保持するのは
+/// 状態スタックだけなので，入力の長さによらず文法の入れ子の深さ分の
+/// 記憶量で解析できる．parse() も start() と push() で実装されている．
+/// set_profile() で ParseProfile を設定すると状態と遷移の使用回数を記録する．
+/// push() の間に acceptable_tokens() で次に受け付ける終端記号の集合を
+/// 得られるので，文脈に応じた字句解析 (Lexer::next_token()) に渡せる．
+//////////////////////////////////////////////////////////////////////
+template<typename TableType,
+	 typename CounterType = NullParseCounter>
+class LRParserT
+{
+public:
+
+  /// @brief push() の結果
+  enum PushResult {
+    /// @brief 次のトークンが必要
+    kNeedMore,
+    /// @brief 受理した
+    kAccepted,
+    /// @brief エラーになった
+    kRejected
+  };
+
+
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] table 構文解析表
+  LRParserT(const TableType& table);
+
+  /// @brief デストラクタ
+  ~LRParserT();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 構文解析を行う．
+  /// @param[in] input 入力のトークン番号の列
+  /// @param[in] entry 入口番号
+  /// @return 受理した時 true を返す．
+  bool
+  parse(const vector<ymuint>& input,
+	ymuint entry = 0);
+
+  /// @brief トークンを一つずつ渡す構文解析を始める．
+  /// @param[in] entry 入口番号
+  void
+  start(ymuint entry = 0);
+
+  /// @brief トークンを一つ渡す．
+  /// @param[in] token トークン番号 (入力の終わりは Grammer::kEnd)
+  /// @return 結果を返す．
+  ///
+  /// kAccepted か kRejected を返した後は start() を呼ぶまで
+  /// 同じ結果を返す．
+  PushResult
+  push(ymuint token);
+
+  /// @brief 現在の状態で受け付ける終端記号の集合を返す．
+  ///
+  /// start() の後でのみ意味を持つ．TableType が acceptable_tokens()
+  /// を持つ時だけ用いることができる．
+  const ymuint64*
+  acceptable_tokens() const;
+
+  /// @brief 直前の構文解析で行った reduce の回数を返す．
+  ymuint64
+  reduce_num() const;
+
+  /// @brief 直前の構文解析でエラーになった入力の位置を返す．
+  ///
+  /// 受理した時は入力の長さを返す．
+  ymuint
+  error_pos() const;
+
+  /// @brief 使用回数を記録する ParseProfile を設定する．
+  /// @param[in] profile 記録先 (NULL の時は記録しない)
+  ///
+  /// profile の状態数は構文解析表の状態数と等しくなければならない．
+  void
+  set_profile(ParseProfile* profile);
+
+  /// @brief 計数方針のオブジェクトを返す．
+  CounterType&
+  counter();
+
+  /// @brief 計数方針のオブジェクトを返す．
+  const CounterType&
+  counter() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 構文解析表
+  const TableType& mTable;
+
+  // 状態スタック
+  vector<ymuint> mStack;
+
+  // push() で受け取ったトークン数
+  ymuint mPos;
+
+  // 直前の push() の結果
+  PushResult mResult;
+
+  // reduce の回数
+  ymuint64 mReduceNum;
+
+  // エラーになった位置
+  ymuint mErrorPos;
+
+  // 使用回数の記録先
+  ParseProfile* mProfile;
+
+  // 計数方針
+  CounterType mCounter;
+
+};
+
+/// @brief ParseTable を用いる構文解析器
+typedef LRParserT<ParseTable> LRParser;
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] table 構文解析表
+template<typename TableType,
+	 typename CounterType>
+inline
+LRParserT<TableType, CounterType>::LRParserT(const TableType& table) :
+  mTable(table),
+  mPos(0),
+  mResult(kRejected),
+  mReduceNum(0),
+  mErrorPos(0),
+  mProfile(NULL)
+{
+  mCounter.clear(mTable.token_num(), mTable.rule_num());
+}
+
+// @brief デストラクタ
+template<typename TableType,
+	 typename CounterType>
+inline
+LRParserT<TableType, CounterType>::~LRParserT()
+{
+}
+
+// @brief 構文解析を行う．
+// @param[in] input 入力のトークン番号の列
+// @param[in] entry 入口番号
+// @return 受理した時 true を返す．
+template<typename TableType,
+	 typename CounterType>
+bool
+LRParserT<TableType, CounterType>::parse(const vector<ymuint>& input,
+					 ymuint entry)
+{
+  start(entry);
+  for (vector<ymuint>::const_iterator p = input.begin();
+       p != input.end(); ++ p) {
+    if ( push(*p) == kRejected ) {
+      return false;
+    }
+  }
+  return push(Grammer::kEnd) == kAccepted;
+}
+
+// @brief トークンを一つずつ渡す構文解析を始める．
+// @param[in] entry 入口番号
+template<typename TableType,
+	 typename CounterType>
+inline
+void
+LRParserT<TableType, CounterType>::start(ymuint entry)
+{
+  ASSERT_COND( entry < mTable.start_num() );
+
+  mReduceNum = 0;
+  mPos = 0;
+  mResult = kNeedMore;
+  mStack.clear();
+  mStack.push_back(mTable.start_state(entry));
+  mCounter.count_parse();
+  mCounter.count_depth(1);
+}
+
+// @brief トークンを一つ渡す．
+// @param[in] token トークン番号 (入力の終わりは Grammer::kEnd)
+// @return 結果を返す．
+//
+// token を shift するまで reduce を繰り返す．
+template<typename TableType,
+	 typename CounterType>
+inline
+typename LRParserT<TableType, CounterType>::PushResult
+LRParserT<TableType, CounterType>::push(ymuint token)
+{
+  if ( mResult != kNeedMore ) {
+    return mResult;
+  }
+
+  for ( ; ; ) {
+    ymuint32 code = mTable.action(mStack.back(), token);
+    if ( mProfile != NULL ) {
+      mProfile->count_state(mStack.back());
+    }
+    switch ( ParseTable::action_type(code) ) {
+    case ParseTable::kShift:
+      if ( mProfile != NULL ) {
+	mProfile->count_transition(mStack.back(), ParseTable::action_arg(code));
+      }
+      mStack.push_back(ParseTable::action_arg(code));
+      mCounter.count_shift(token);
+      mCounter.count_depth(mStack.size());
+      ++ mPos;
+      return kNeedMore;
+
+    case ParseTable::kReduce:
+      {
+	ymuint rule_id = ParseTable::action_arg(code);
+	mCounter.count_reduce(rule_id);
+	if ( code == mTable.default_action(mStack.back()) ) {
+	  mCounter.count_default_reduce();
+	}
+	mStack.resize(mStack.size() - mTable.rule_size(rule_id));
+	ymuint next = mTable.goto_state(mStack.back(), mTable.rule_left(rule_id));
+	mCounter.count_goto();
+	ASSERT_COND( next != ParseTable::kNoState );
+	if ( mProfile != NULL ) {
+	  mProfile->count_transition(mStack.back(), next);
+	}
+	mStack.push_back(next);
+	mCounter.count_depth(mStack.size());
+	++ mReduceNum;
+      }
+      break;
+
+    case ParseTable::kShiftReduce:
+      {
+	// shift した状態は積まないので右辺の長さより一つ少なく降ろす．
+	ymuint rule_id = ParseTable::action_arg(code);
+	mCounter.count_shift(token);
+	mCounter.count_reduce(rule_id);
+	mStack.resize(mStack.size() - mTable.rule_size(rule_id) + 1);
+	ymuint next = mTable.goto_state(mStack.back(), mTable.rule_left(rule_id));
+	mCounter.count_goto();
+	ASSERT_COND( next != ParseTable::kNoState );
+	if ( mProfile != NULL ) {
+	  mProfile->count_transition(mStack.back(), next);
+	}
+	mStack.push_back(next);
+	mCounter.count_depth(mStack.size());
+	++ mReduceNum;
+	++ mPos;
+      }
+      return kNeedMore;
+
+    case ParseTable::kAccept:
+      mErrorPos = mPos;
+      mResult = kAccepted;
+      return kAccepted;
+
+    case ParseTable::kError:
+      mErrorPos = mPos;
+      mResult = kRejected;
+      return kRejected;
+    }
+  }
+}
+
+// @brief 現在の状態で受け付ける終端記号の集合を返す．
+template<typename TableType,
+	 typename CounterType>
+inline
+const ymuint64*
+LRParserT<TableType, CounterType>::acceptable_tokens() const
+{
+  return mTable.acceptable_tokens(mStack.back());
+}
+
+// @brief 直前の構文解析で行った reduce の回数を返す．
+template<typename TableType,
+	 typename CounterType>
+inline
+ymuint64
+LRParserT<TableType, CounterType>::reduce_num() const
+{
+  return mReduceNum;
+}
+
+// @brief 直前の構文解析でエラーになった入力の位置を返す．
+template<typename TableType,
+	 typename CounterType>
+inline
+ymuint
+LRParserT<TableType, CounterType>::error_pos() const
+{
+  return mErrorPos;
+}
+
+// @brief 使用回数を記録する ParseProfile を設定する．
+// @param[in] profile 記録先 (NULL の時は記録しない)
+template<typename TableType,
+	 typename CounterType>
+inline
+void
+LRParserT<TableType, CounterType>::set_profile(ParseProfile* profile)
+{
+  ASSERT_COND( profile == NULL || profile->state_num() == mTable.state_num() );
+  mProfile = profile;
+}
+
+// @brief 計数方針のオブジェクトを返す．
+template<typename TableType,
+	 typename CounterType>
+inline
+CounterType&
+LRParserT<TableType, CounterType>::counter()
+{
+  return mCounter;
+}
+
+// @brief 計数方針のオブジェクトを返す．
+template<typename TableType,
+	 typename CounterType>
+inline
+const CounterType&
+LRParserT<TableType, CounterType>::counter() const
+{
+  return mCounter;
+}
+
+END_NAMESPACE_YM
+
+#endif // LRPARSER_H
@@ -0,0 +1,1645 @@
+
+/// @file Lexer.cc
+/// @brief Lexer の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Lexer.h"
+#include "Token.h"
+#include "YmUtils/HashMap.h"
+#include <algorithm>
+
+#if PARSER_ENABLE_SIMD && defined(__GNUC__) && defined(__x86_64__)
+#define LEXER_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define LEXER_X86_SIMD 0
+#endif
+
+
+BEGIN_NAMESPACE_YM
+
+// 状態集合やシグネチャのハッシュ関数
+template<>
+struct
+HashFunc<vector<ymuint> >
+{
+  ymuint
+  operator()(const vector<ymuint>& key) const
+  {
+    ymuint ans = 0;
+    for (vector<ymuint>::const_iterator p = key.begin();
+	 p != key.end(); ++ p) {
+      ans += (ans * 1023);
+      ans += *p;
+    }
+    return ans;
+  }
+};
+
+BEGIN_NONAMESPACE
+
+// 遷移や受理がないことを表す番号
+const ymuint kNone = 0xFFFFFFFFU;
+
+// バイトの集合
+struct CharSet
+{
+  // コンストラクタ
+  CharSet()
+  {
+    for (ymuint i = 0; i < 4; ++ i) {
+      mBits[i] = 0UL;
+    }
+  }
+
+  // バイトを加える．
+  void
+  add(ymuint c)
+  {
+    mBits[c / 64] |= (1UL << (c % 64));
+  }
+
+  // 範囲を加える．
+  void
+  add_range(ymuint lo,
+	    ymuint hi)
+  {
+    for (ymuint c = lo; c <= hi; ++ c) {
+      add(c);
+    }
+  }
+
+  // 集合を加える．
+  void
+  add_set(const CharSet& src)
+  {
+    for (ymuint i = 0; i < 4; ++ i) {
+      mBits[i] |= src.mBits[i];
+    }
+  }
+
+  // 補集合にする．
+  void
+  invert()
+  {
+    for (ymuint i = 0; i < 4; ++ i) {
+      mBits[i] = ~mBits[i];
+    }
+  }
+
+  // バイトを含む時 true を返す．
+  bool
+  has(ymuint c) const
+  {
+    return (mBits[c / 64] >> (c % 64)) & 1UL;
+  }
+
+  // ただ一つのバイトからなる時そのバイトを返す．
+  // それ以外は kNone を返す．
+  ymuint
+  single() const
+  {
+    ymuint ans = kNone;
+    for (ymuint i = 0; i < 4; ++ i) {
+      if ( mBits[i] == 0UL ) {
+	continue;
+      }
+      if ( ans != kNone || (mBits[i] & (mBits[i] - 1)) != 0UL ) {
+	return kNone;
+      }
+      ans = i * 64 + __builtin_ctzll(mBits[i]);
+    }
+    return ans;
+  }
+
+  // ビットベクタ
+  ymuint64 mBits[4];
+};
+
+// NFA の状態
+//
+// Thompson の構成法では各状態はバイトの遷移を高々一つしか持たない．
+struct NfaState
+{
+  // ε遷移先のリスト
+  vector<ymuint> mEpsList;
+
+  // バイトの遷移の集合番号 (なければ kNone)
+  ymuint mSet;
+
+  // バイトの遷移先
+  ymuint mNext;
+
+  // 受理するパターンの優先順位 (受理しない時は kNone)
+  ymuint mAccept;
+};
+
+// NFA
+struct Nfa
+{
+  // 状態を作る．
+  ymuint
+  new_state()
+  {
+    ymuint id = mStateList.size();
+    NfaState state;
+    state.mSet = kNone;
+    state.mNext = kNone;
+    state.mAccept = kNone;
+    mStateList.push_back(state);
+    return id;
+  }
+
+  // ε遷移を加える．
+  void
+  add_eps(ymuint from,
+	  ymuint to)
+  {
+    mStateList[from].mEpsList.push_back(to);
+  }
+
+  // バイトの遷移を持つ断片 (start, end) を作る．
+  void
+  new_trans(const CharSet& set,
+	    ymuint& start,
+	    ymuint& end)
+  {
+    start = new_state();
+    end = new_state();
+    mStateList[start].mSet = mSetList.size();
+    mStateList[start].mNext = end;
+    mSetList.push_back(set);
+  }
+
+  // 状態のリスト
+  vector<NfaState> mStateList;
+
+  // バイトの集合のリスト
+  vector<CharSet> mSetList;
+};
+
+// 正規表現を読んで NFA の断片を作るクラス
+//
+// 文法は以下の通り．
+//   alt  ::= seq ( '|' seq )*
+//   seq  ::= rep*
+//   rep  ::= atom ( '*' | '+' | '?' )*
+//   atom ::= '(' alt ')' | '[' class ']' | '.' | '\' escape | byte
+class RegexParser
+{
+public:
+
+  // コンストラクタ
+  RegexParser(const string& pattern,
+	      Nfa& nfa) :
+    mPattern(pattern),
+    mPos(0),
+    mNfa(nfa)
+  {
+  }
+
+  // 全体を読む．
+  // 誤りがある時は false を返す．
+  bool
+  parse(ymuint& start,
+	ymuint& end)
+  {
+    if ( !parse_alt(start, end) ) {
+      return false;
+    }
+    if ( mPos < mPattern.size() ) {
+      mError = "unmatched ')'";
+      return false;
+    }
+    return true;
+  }
+
+  // エラーメッセージを返す．
+  const string&
+  error() const
+  {
+    return mError;
+  }
+
+
+private:
+
+  // 選択を読む．
+  bool
+  parse_alt(ymuint& start,
+	    ymuint& end)
+  {
+    if ( !parse_seq(start, end) ) {
+      return false;
+    }
+    while ( mPos < mPattern.size() && mPattern[mPos] == '|' ) {
+      ++ mPos;
+      ymuint start2;
+      ymuint end2;
+      if ( !parse_seq(start2, end2) ) {
+	return false;
+      }
+      ymuint new_start = mNfa.new_state();
+      ymuint new_end = mNfa.new_state();
+      mNfa.add_eps(new_start, start);
+      mNfa.add_eps(new_start, start2);
+      mNfa.add_eps(end, new_end);
+      mNfa.add_eps(end2, new_end);
+      start = new_start;
+      end = new_end;
+    }
+    return true;
+  }
+
+  // 連接を読む．
+  bool
+  parse_seq(ymuint& start,
+	    ymuint& end)
+  {
+    start = mNfa.new_state();
+    end = start;
+    while ( mPos < mPattern.size() &&
+	    mPattern[mPos] != '|' && mPattern[mPos] != ')' ) {
+      ymuint start2;
+      ymuint end2;
+      if ( !parse_rep(start2, end2) ) {
+	return false;
+      }
+      mNfa.add_eps(end, start2);
+      end = end2;
+    }
+    return true;
+  }
+
+  // 繰り返しを読む．
+  bool
+  parse_rep(ymuint& start,
+	    ymuint& end)
+  {
+    if ( !parse_atom(start, end) ) {
+      return false;
+    }
+    while ( mPos < mPattern.size() ) {
+      char c = mPattern[mPos];
+      if ( c != '*' && c != '+' && c != '?' ) {
+	break;
+      }
+      ++ mPos;
+      ymuint new_start = mNfa.new_state();
+      ymuint new_end = mNfa.new_state();
+      mNfa.add_eps(new_start, start);
+      mNfa.add_eps(end, new_end);
+      if ( c != '+' ) {
+	mNfa.add_eps(new_start, new_end);
+      }
+      if ( c != '?' ) {
+	mNfa.add_eps(end, start);
+      }
+      start = new_start;
+      end = new_end;
+    }
+    return true;
+  }
+
+  // 基本要素を読む．
+  bool
+  parse_atom(ymuint& start,
+	     ymuint& end)
+  {
+    char c = mPattern[mPos];
+    ++ mPos;
+    CharSet set;
+    switch ( c ) {
+    case '(':
+      if ( !parse_alt(start, end) ) {
+	return false;
+      }
+      if ( mPos >= mPattern.size() ) {
+	mError = "unmatched '('";
+	return false;
+      }
+      ++ mPos;
+      return true;
+
+    case '*':
+    case '+':
+    case '?':
+      mError = "nothing to repeat";
+      return false;
+
+    case '[':
+      if ( !parse_class(set) ) {
+	return false;
+      }
+      break;
+
+    case '.':
+      set.add('\n');
+      set.invert();
+      break;
+
+    case '\\':
+      if ( !parse_escape(set) ) {
+	return false;
+      }
+      break;
+
+    default:
+      set.add(static_cast<ymuint8>(c));
+      break;
+    }
+    mNfa.new_trans(set, start, end);
+    return true;
+  }
+
+  // 文字クラスの中身を読む．
+  bool
+  parse_class(CharSet& set)
+  {
+    bool negate = false;
+    if ( mPos < mPattern.size() && mPattern[mPos] == '^' ) {
+      negate = true;
+      ++ mPos;
+    }
+    bool first = true;
+    for ( ; ; ) {
+      if ( mPos >= mPattern.size() ) {
+	mError = "unterminated '['";
+	return false;
+      }
+      char c = mPattern[mPos];
+      ++ mPos;
+      if ( c == ']' && !first ) {
+	break;
+      }
+      first = false;
+
+      CharSet item;
+      ymuint lo;
+      if ( c == '\\' ) {
+	if ( !parse_escape(item) ) {
+	  return false;
+	}
+	if ( !single_byte(item, lo) ) {
+	  // \d などは範囲の端にはならない．
+	  set.add_set(item);
+	  continue;
+	}
+      }
+      else {
+	lo = static_cast<ymuint8>(c);
+      }
+
+      if ( mPos + 1 < mPattern.size() &&
+	   mPattern[mPos] == '-' && mPattern[mPos + 1] != ']' ) {
+	++ mPos;
+	char c2 = mPattern[mPos];
+	++ mPos;
+	ymuint hi = static_cast<ymuint8>(c2);
+	if ( c2 == '\\' ) {
+	  CharSet item2;
+	  if ( !parse_escape(item2) ) {
+	    return false;
+	  }
+	  if ( !single_byte(item2, hi) ) {
+	    mError = "bad range in '[]'";
+	    return false;
+	  }
+	}
+	if ( lo > hi ) {
+	  mError = "bad range in '[]'";
+	  return false;
+	}
+	set.add_range(lo, hi);
+      }
+      else {
+	set.add(lo);
+      }
+    }
+    if ( negate ) {
+      set.invert();
+    }
+    return true;
+  }
+
+  // '\' の次からを読む．
+  bool
+  parse_escape(CharSet& set)
+  {
+    if ( mPos >= mPattern.size() ) {
+      mError = "trailing '\\'";
+      return false;
+    }
+    char c = mPattern[mPos];
+    ++ mPos;
+    switch ( c ) {
+    case 'n': set.add('\n'); break;
+    case 't': set.add('\t'); break;
+    case 'r': set.add('\r'); break;
+    case 'f': set.add('\f'); break;
+    case 'v': set.add('\v'); break;
+    case '0': set.add(0); break;
+
+    case 'd':
+    case 'D':
+      set.add_range('0', '9');
+      if ( c == 'D' ) {
+	set.invert();
+      }
+      break;
+
+    case 'w':
+    case 'W':
+      set.add_range('a', 'z');
+      set.add_range('A', 'Z');
+      set.add_range('0', '9');
+      set.add('_');
+      if ( c == 'W' ) {
+	set.invert();
+      }
+      break;
+
+    case 's':
+    case 'S':
+      set.add(' ');
+      set.add('\t');
+      set.add('\n');
+      set.add('\r');
+      set.add('\f');
+      set.add('\v');
+      if ( c == 'S' ) {
+	set.invert();
+      }
+      break;
+
+    case 'x':
+      {
+	ymuint val = 0;
+	for (ymuint i = 0; i < 2; ++ i) {
+	  ymuint d;
+	  char h = mPos < mPattern.size() ? mPattern[mPos] : '\0';
+	  if ( h >= '0' && h <= '9' ) {
+	    d = h - '0';
+	  }
+	  else if ( h >= 'a' && h <= 'f' ) {
+	    d = h - 'a' + 10;
+	  }
+	  else if ( h >= 'A' && h <= 'F' ) {
+	    d = h - 'A' + 10;
+	  }
+	  else {
+	    mError = "bad '\\x' escape";
+	    return false;
+	  }
+	  val = val * 16 + d;
+	  ++ mPos;
+	}
+	set.add(val);
+      }
+      break;
+
+    default:
+      set.add(static_cast<ymuint8>(c));
+      break;
+    }
+    return true;
+  }
+
+  // 集合がバイト一つだけの時 true を返し，そのバイトを c に入れる．
+  static
+  bool
+  single_byte(const CharSet& set,
+	      ymuint& c)
+  {
+    ymuint n = 0;
+    for (ymuint i = 0; i < 256; ++ i) {
+      if ( set.has(i) ) {
+	c = i;
+	++ n;
+      }
+    }
+    return n == 1;
+  }
+
+
+private:
+
+  // パターン
+  const string& mPattern;
+
+  // 読んでいる位置
+  ymuint mPos;
+
+  // 作成中の NFA
+  Nfa& mNfa;
+
+  // エラーメッセージ
+  string mError;
+
+};
+
+// ε閉包を求める．
+// state_list は整列された状態集合になる．
+void
+closure(const Nfa& nfa,
+	vector<ymuint>& state_list,
+	vector<bool>& mark)
+{
+  vector<ymuint> queue(state_list);
+  state_list.clear();
+  for (vector<ymuint>::iterator p = queue.begin(); p != queue.end(); ++ p) {
+    mark[*p] = true;
+  }
+  for (ymuint rpos = 0; rpos < queue.size(); ++ rpos) {
+    const vector<ymuint>& eps_list = nfa.mStateList[queue[rpos]].mEpsList;
+    for (vector<ymuint>::const_iterator p = eps_list.begin();
+	 p != eps_list.end(); ++ p) {
+      if ( !mark[*p] ) {
+	mark[*p] = true;
+	queue.push_back(*p);
+      }
+    }
+  }
+  for (vector<ymuint>::iterator p = queue.begin(); p != queue.end(); ++ p) {
+    mark[*p] = false;
+  }
+  sort(queue.begin(), queue.end());
+  state_list.swap(queue);
+}
+
+// 文字列そのものを表す断片の時 true を返す．
+// literal にその文字列を入れる．
+bool
+literal_of(const Nfa& nfa,
+	   ymuint start,
+	   ymuint end,
+	   string& literal)
+{
+  ymuint id = start;
+  while ( id != end ) {
+    const NfaState& state = nfa.mStateList[id];
+    if ( state.mSet != kNone ) {
+      ymuint c = nfa.mSetList[state.mSet].single();
+      if ( !state.mEpsList.empty() || c == kNone ) {
+	return false;
+      }
+      literal += static_cast<char>(c);
+      id = state.mNext;
+    }
+    else if ( state.mEpsList.size() == 1 ) {
+      id = state.mEpsList[0];
+    }
+    else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// パターンを読んで NFA の初期状態につなぐ．
+// 誤りのないことは調べてあるものとする．
+void
+add_pattern(Nfa& nfa,
+	    ymuint nfa_start,
+	    const string& pattern,
+	    ymuint prio)
+{
+  RegexParser parser(pattern, nfa);
+  ymuint start;
+  ymuint end;
+  bool stat = parser.parse(start, end);
+  ASSERT_COND( stat );
+  nfa.mStateList[end].mAccept = prio;
+  nfa.add_eps(nfa_start, start);
+}
+
+// NFA で文字列全体を読んだ時に受理するパターンの優先順位を返す．
+// 受理しない時は kNone を返す．
+ymuint
+match_literal(const Nfa& nfa,
+	      ymuint nfa_start,
+	      const string& literal)
+{
+  vector<bool> mark(nfa.mStateList.size(), false);
+  vector<ymuint> state_list(1, nfa_start);
+  closure(nfa, state_list, mark);
+  for (ymuint i = 0; i < literal.size() && !state_list.empty(); ++ i) {
+    ymuint c = static_cast<ymuint8>(literal[i]);
+    vector<ymuint> next_list;
+    for (vector<ymuint>::iterator p = state_list.begin();
+	 p != state_list.end(); ++ p) {
+      const NfaState& state = nfa.mStateList[*p];
+      if ( state.mSet != kNone && nfa.mSetList[state.mSet].has(c) ) {
+	next_list.push_back(state.mNext);
+      }
+    }
+    closure(nfa, next_list, mark);
+    state_list.swap(next_list);
+  }
+  ymuint accept = kNone;
+  for (vector<ymuint>::iterator p = state_list.begin();
+       p != state_list.end(); ++ p) {
+    if ( nfa.mStateList[*p].mAccept < accept ) {
+      accept = nfa.mStateList[*p].mAccept;
+    }
+  }
+  return accept;
+}
+
+// 種つきのバイト列のハッシュ関数 (FNV-1a)
+ymuint64
+hash_bytes(const char* str,
+	   ymuint len,
+	   ymuint64 seed)
+{
+  ymuint64 h = 14695981039346656037ULL ^ seed;
+  for (ymuint i = 0; i < len; ++ i) {
+    h ^= static_cast<ymuint8>(str[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// ずらし量 disp で混ぜたハッシュ値から [0, n) の位置を求める．
+ymuint
+hash_slot(ymuint64 h,
+	  ymuint disp,
+	  ymuint n)
+{
+  h ^= disp * 0x9E3779B97F4A7C15ULL;
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  return static_cast<ymuint>(((h & 0xFFFFFFFFULL) * n) >> 32);
+}
+
+// ハッシュ値からバケット番号を求める．
+ymuint
+hash_bucket(ymuint64 h,
+	    ymuint n)
+{
+  return static_cast<ymuint>(((h >> 32) * n) >> 32);
+}
+
+// バイトを表す文字列を出力する．
+void
+print_byte(ostream& s,
+	   ymuint c)
+{
+  if ( c > ' ' && c < 0x7F ) {
+    s << static_cast<char>(c);
+  }
+  else {
+    const char* hex = "0123456789abcdef";
+    s << "\\x" << hex[c / 16] << hex[c % 16];
+  }
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス Lexer
+//////////////////////////////////////////////////////////////////////
+
+// 定数の定義
+const ymuint Lexer::kNoState;
+const ymuint Lexer::kNoToken;
+const ymuint Lexer::kSkipToken;
+const ymuint Lexer::kRunRangeMax;
+
+// @brief コンストラクタ
+// @param[in] grammer パターンを持つ文法
+// @param[in] split_keyword キーワードを DFA から除く時 true にする．
+Lexer::Lexer(const Grammer& grammer,
+	     bool split_keyword) :
+  mStateNum(0),
+  mClassNum(0),
+  mSimdMode(kScalar),
+  mSkipFunc(skip_scalar),
+  mKeywordSeed(0),
+  mKeywordMaxLen(0),
+  mTokenWordNum(0),
+  mBackupNum(0),
+  mErrorNum(0)
+{
+  // パターンを優先順位の順に集める．
+  // 優先順位はトークン番号の順で，読み飛ばすパターンは最後になる．
+  // ここで一度読んで誤りを調べ，文字列そのもののパターンを見つける．
+  vector<string> prio_pattern;
+  vector<ymuint> prio_token;
+  vector<string> prio_name;
+  vector<string> prio_literal;
+  vector<bool> prio_is_literal;
+  ymuint nt = grammer.token_num();
+  const vector<string>& skip_list = grammer.skip_pattern_list();
+  for (ymuint i = 0; i < nt + skip_list.size(); ++ i) {
+    string pattern;
+    string name;
+    ymuint token_id;
+    if ( i < nt ) {
+      const Token* token = grammer.token(i);
+      pattern = token->pattern();
+      if ( pattern.empty() ) {
+	continue;
+      }
+      name = token->str();
+      token_id = i;
+      if ( !token->is_terminal() ) {
+	cerr << "warning: pattern of nonterminal " << name
+	     << " is ignored" << endl;
+	continue;
+      }
+    }
+    else {
+      pattern = skip_list[i - nt];
+      name = "(skip)";
+      token_id = kSkipToken;
+    }
+
+    Nfa tmp_nfa;
+    RegexParser parser(pattern, tmp_nfa);
+    ymuint start;
+    ymuint end;
+    if ( !parser.parse(start, end) ) {
+      cerr << "syntax error in pattern of " << name << ": "
+	   << parser.error() << endl;
+      ++ mErrorNum;
+      continue;
+    }
+    string literal;
+    bool is_literal = token_id != kSkipToken &&
+      literal_of(tmp_nfa, start, end, literal) && !literal.empty();
+    prio_pattern.push_back(pattern);
+    prio_token.push_back(token_id);
+    prio_name.push_back(name);
+    prio_literal.push_back(literal);
+    prio_is_literal.push_back(is_literal);
+  }
+
+  // 文字列そのもの以外のパターンの断片を一つの初期状態から
+  // ε遷移でつなぐ．
+  Nfa nfa;
+  ymuint nfa_start = nfa.new_state();
+  ymuint np = prio_pattern.size();
+  for (ymuint i = 0; i < np; ++ i) {
+    if ( !split_keyword || !prio_is_literal[i] ) {
+      add_pattern(nfa, nfa_start, prio_pattern[i], i);
+    }
+  }
+
+  // 文字列そのもののパターンのうち，優先順位の低い他のパターン
+  // (識別子など) がちょうど全体を受理するものはキーワードとして
+  // DFA から除き，完全ハッシュで見分ける．それ以外は NFA に加える．
+  vector<string> kw_literal;
+  vector<ymuint> kw_token;
+  vector<ymuint> kw_host;
+  mHasKeyword.resize(nt, 0);
+  for (ymuint i = 0; i < np; ++ i) {
+    if ( !split_keyword || !prio_is_literal[i] ) {
+      continue;
+    }
+    const string& literal = prio_literal[i];
+    if ( find(kw_literal.begin(), kw_literal.end(), literal) != kw_literal.end() ) {
+      // 同じ文字列の優先順位の高いキーワードがあるので一致することはない．
+      continue;
+    }
+    ymuint host = match_literal(nfa, nfa_start, literal);
+    if ( host != kNone && host > i && prio_token[host] != kSkipToken ) {
+      kw_literal.push_back(literal);
+      kw_token.push_back(prio_token[i]);
+      kw_host.push_back(prio_token[host]);
+      mHasKeyword[prio_token[host]] = 1;
+    }
+    else {
+      add_pattern(nfa, nfa_start, prio_pattern[i], i);
+    }
+  }
+  build_keyword(kw_literal, kw_token, kw_host);
+
+  // 全ての集合で同じ振る舞いをするバイトを同値類にまとめる．
+  // 集合ごとに (今の同値類, 含むかどうか) で分ける．
+  vector<ymuint> byte_class(256, 0);
+  mClassNum = 1;
+  for (vector<CharSet>::iterator p = nfa.mSetList.begin();
+       p != nfa.mSetList.end(); ++ p) {
+    vector<ymuint> new_id(mClassNum * 2, kNone);
+    ymuint num = 0;
+    for (ymuint c = 0; c < 256; ++ c) {
+      ymuint key = byte_class[c] * 2 + (p->has(c) ? 1 : 0);
+      if ( new_id[key] == kNone ) {
+	new_id[key] = num;
+	++ num;
+      }
+      byte_class[c] = new_id[key];
+    }
+    mClassNum = num;
+  }
+  vector<ymuint> class_byte(mClassNum);
+  for (ymuint c = 256; c > 0; -- c) {
+    class_byte[byte_class[c - 1]] = c - 1;
+  }
+  for (ymuint c = 0; c < 256; ++ c) {
+    mByteClass[c] = byte_class[c];
+  }
+
+  // 部分集合構成法で DFA を作る．
+  ymuint nn = nfa.mStateList.size();
+  vector<bool> mark(nn, false);
+  HashMap<vector<ymuint>, ymuint> dfa_hash;
+  vector<vector<ymuint> > dfa_list;
+  vector<ymuint> dfa_trans;
+  vector<ymuint> dfa_accept;
+  vector<vector<ymuint> > dfa_accept_set;
+  {
+    vector<ymuint> start_list(1, nfa_start);
+    closure(nfa, start_list, mark);
+    dfa_hash.add(start_list, 0);
+    dfa_list.push_back(start_list);
+  }
+  for (ymuint i = 0; i < dfa_list.size(); ++ i) {
+    vector<ymuint> state_list(dfa_list[i]);
+    vector<ymuint> accept_set;
+    for (vector<ymuint>::iterator p = state_list.begin();
+	 p != state_list.end(); ++ p) {
+      if ( nfa.mStateList[*p].mAccept != kNone ) {
+	accept_set.push_back(nfa.mStateList[*p].mAccept);
+      }
+    }
+    sort(accept_set.begin(), accept_set.end());
+    accept_set.erase(unique(accept_set.begin(), accept_set.end()), accept_set.end());
+    dfa_accept.push_back(accept_set.empty() ? kNone : accept_set[0]);
+    dfa_accept_set.push_back(accept_set);
+
+    for (ymuint k = 0; k < mClassNum; ++ k) {
+      ymuint c = class_byte[k];
+      vector<ymuint> next_list;
+      for (vector<ymuint>::iterator p = state_list.begin();
+	   p != state_list.end(); ++ p) {
+	const NfaState& state = nfa.mStateList[*p];
+	if ( state.mSet != kNone && nfa.mSetList[state.mSet].has(c) ) {
+	  next_list.push_back(state.mNext);
+	}
+      }
+      if ( next_list.empty() ) {
+	dfa_trans.push_back(kNoState);
+	continue;
+      }
+      closure(nfa, next_list, mark);
+      ymuint next;
+      if ( !dfa_hash.find(next_list, next) ) {
+	next = dfa_list.size();
+	dfa_hash.add(next_list, next);
+	dfa_list.push_back(next_list);
+      }
+      dfa_trans.push_back(next);
+    }
+  }
+  ymuint nd = dfa_list.size();
+
+  if ( dfa_accept[0] != kNone ) {
+    cerr << "warning: pattern of " << prio_name[dfa_accept[0]]
+	 << " matches the empty string" << endl;
+  }
+
+  // Moore の方法で最小化する．
+  // 受理するパターンの集合で分けた分割から始め，(ブロック, 遷移先の
+  // ブロック) が異なる状態を分けることを変化がなくなるまで繰り返す．
+  // 文脈に応じた字句解析のために最優先でないパターンも区別する．
+  vector<ymuint> block(nd);
+  ymuint block_num = 0;
+  {
+    HashMap<vector<ymuint>, ymuint> sig_hash;
+    for (ymuint i = 0; i < nd; ++ i) {
+      const vector<ymuint>& sig = dfa_accept_set[i];
+      if ( !sig_hash.find(sig, block[i]) ) {
+	block[i] = block_num;
+	sig_hash.add(sig, block_num);
+	++ block_num;
+      }
+    }
+  }
+  for ( ; ; ) {
+    HashMap<vector<ymuint>, ymuint> sig_hash;
+    vector<ymuint> new_block(nd);
+    ymuint new_num = 0;
+    for (ymuint i = 0; i < nd; ++ i) {
+      vector<ymuint> sig;
+      sig.reserve(mClassNum + 1);
+      sig.push_back(block[i]);
+      for (ymuint k = 0; k < mClassNum; ++ k) {
+	ymuint next = dfa_trans[i * mClassNum + k];
+	sig.push_back(next == kNoState ? kNoState : block[next]);
+      }
+      if ( !sig_hash.find(sig, new_block[i]) ) {
+	new_block[i] = new_num;
+	sig_hash.add(sig, new_num);
+	++ new_num;
+      }
+    }
+    block.swap(new_block);
+    if ( new_num == block_num ) {
+      break;
+    }
+    block_num = new_num;
+  }
+
+  // 初期状態が 0 になるようにブロックに番号をつけ直して表を作る．
+  // DFA の状態 0 が初期状態で，各ブロックは最初に現れた状態で代表する．
+  vector<ymuint> block_id(block_num, kNone);
+  vector<ymuint> rep_list;
+  for (ymuint i = 0; i < nd; ++ i) {
+    if ( block_id[block[i]] == kNone ) {
+      block_id[block[i]] = rep_list.size();
+      rep_list.push_back(i);
+    }
+  }
+  mStateNum = block_num;
+  mTransList.resize(mStateNum * mClassNum);
+  mAcceptList.resize(mStateNum);
+  mAcceptTop.resize(mStateNum + 1);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    ymuint rep = rep_list[s];
+    ymuint accept = dfa_accept[rep];
+    mAcceptList[s] = accept == kNone ? kNoToken : prio_token[accept];
+    mAcceptTop[s] = mAcceptAll.size();
+    const vector<ymuint>& accept_set = dfa_accept_set[rep];
+    for (vector<ymuint>::const_iterator p = accept_set.begin();
+	 p != accept_set.end(); ++ p) {
+      mAcceptAll.push_back(prio_token[*p]);
+    }
+    bool has_error = false;
+    for (ymuint k = 0; k < mClassNum; ++ k) {
+      ymuint next = dfa_trans[rep * mClassNum + k];
+      if ( next == kNoState ) {
+	has_error = true;
+	mTransList[s * mClassNum + k] = kNoState;
+      }
+      else {
+	mTransList[s * mClassNum + k] = block_id[block[next]];
+      }
+    }
+    if ( s > 0 && has_error && mAcceptList[s] == kNoToken ) {
+      ++ mBackupNum;
+    }
+  }
+
+  mAcceptTop[mStateNum] = mAcceptAll.size();
+
+  // 各状態から受理しうるトークンの集合を求める．
+  // 遷移先の集合を加えることを変化がなくなるまで繰り返す．
+  mTokenWordNum = (nt + 63) / 64;
+  mLiveBits.clear();
+  mLiveBits.resize(mStateNum * mTokenWordNum, 0ULL);
+  mLiveFlag.clear();
+  mLiveFlag.resize(mStateNum, 0);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    for (ymuint i = mAcceptTop[s]; i < mAcceptTop[s + 1]; ++ i) {
+      ymuint token = mAcceptAll[i];
+      if ( token == kSkipToken ) {
+	mLiveFlag[s] |= kLiveSkip;
+      }
+      else {
+	mLiveBits[s * mTokenWordNum + token / 64] |= 1ULL << (token % 64);
+	if ( mHasKeyword[token] ) {
+	  mLiveFlag[s] |= kLiveKeyword;
+	}
+      }
+    }
+  }
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      for (ymuint k = 0; k < mClassNum; ++ k) {
+	ymuint next = mTransList[s * mClassNum + k];
+	if ( next == kNoState ) {
+	  continue;
+	}
+	for (ymuint w = 0; w < mTokenWordNum; ++ w) {
+	  ymuint64 bits = mLiveBits[s * mTokenWordNum + w] | mLiveBits[next * mTokenWordNum + w];
+	  if ( bits != mLiveBits[s * mTokenWordNum + w] ) {
+	    mLiveBits[s * mTokenWordNum + w] = bits;
+	    changed = true;
+	  }
+	}
+	ymuint8 flag = mLiveFlag[s] | mLiveFlag[next];
+	if ( flag != mLiveFlag[s] ) {
+	  mLiveFlag[s] = flag;
+	  changed = true;
+	}
+      }
+    }
+  }
+
+  // 自分自身にとどまるバイトの集合が少ない範囲で表せる状態を探す．
+  mRunIndex.resize(mStateNum, kNoState);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    Run run;
+    run.mNum = 0;
+    ymuint c = 0;
+    while ( c < 256 ) {
+      if ( mTransList[s * mClassNum + mByteClass[c]] != s ) {
+	++ c;
+	continue;
+      }
+      if ( run.mNum == kRunRangeMax ) {
+	run.mNum = kRunRangeMax + 1;
+	break;
+      }
+      ymuint c2 = c;
+      while ( c2 + 1 < 256 && mTransList[s * mClassNum + mByteClass[c2 + 1]] == s ) {
+	++ c2;
+      }
+      run.mLo[run.mNum] = c;
+      run.mHi[run.mNum] = c2;
+      ++ run.mNum;
+      c = c2 + 1;
+    }
+    if ( run.mNum > 0 && run.mNum <= kRunRangeMax ) {
+      mRunIndex[s] = mRunList.size();
+      mRunList.push_back(run);
+    }
+  }
+
+  set_simd_mode(best_simd_mode());
+}
+
+// @brief デストラクタ
+Lexer::~Lexer()
+{
+}
+
+// @brief キーワードの完全ハッシュ表を作る．
+// @param[in] literal_list キーワードの文字列のリスト
+// @param[in] token_list キーワードのトークン番号のリスト
+// @param[in] host_list キーワードを字句として受理するトークン番号のリスト
+//
+// hash-and-displace 法で最小完全ハッシュを作る．
+// キーワードをハッシュ値でバケットに分け，大きいバケットから順に
+// 全てのキーワードが空いた位置に入るずらし量を探す．
+// 見つからない時は種を変えてやり直す．
+void
+Lexer::build_keyword(const vector<string>& literal_list,
+		     const vector<ymuint>& token_list,
+		     const vector<ymuint>& host_list)
+{
+  ymuint n = literal_list.size();
+  if ( n == 0 ) {
+    return;
+  }
+  ymuint nb = (n + 1) / 2;
+  const ymuint disp_limit = 1U << 16;
+  vector<ymuint64> hash_list(n);
+  vector<ymuint> slot_list(n);
+  for (mKeywordSeed = 0; ; ++ mKeywordSeed) {
+    vector<vector<ymuint> > bucket_list(nb);
+    for (ymuint i = 0; i < n; ++ i) {
+      hash_list[i] = hash_bytes(literal_list[i].c_str(), literal_list[i].size(),
+				mKeywordSeed);
+      bucket_list[hash_bucket(hash_list[i], nb)].push_back(i);
+    }
+    vector<ymuint> order(nb);
+    for (ymuint b = 0; b < nb; ++ b) {
+      order[b] = b;
+    }
+    // 大きいバケットから順に (同じ大きさなら番号の順に) 決める．
+    for (ymuint i = 1; i < nb; ++ i) {
+      ymuint b = order[i];
+      ymuint j = i;
+      for ( ; j > 0 && bucket_list[order[j - 1]].size() < bucket_list[b].size(); -- j) {
+	order[j] = order[j - 1];
+      }
+      order[j] = b;
+    }
+
+    mKeywordDisp.clear();
+    mKeywordDisp.resize(nb, 0);
+    vector<bool> used(n, false);
+    bool ok = true;
+    for (ymuint k = 0; k < nb && ok; ++ k) {
+      const vector<ymuint>& bucket = bucket_list[order[k]];
+      if ( bucket.empty() ) {
+	break;
+      }
+      ymuint disp = 0;
+      for ( ; disp < disp_limit; ++ disp) {
+	bool found = true;
+	for (ymuint j = 0; j < bucket.size() && found; ++ j) {
+	  ymuint slot = hash_slot(hash_list[bucket[j]], disp, n);
+	  if ( used[slot] ) {
+	    found = false;
+	  }
+	  for (ymuint j2 = 0; j2 < j && found; ++ j2) {
+	    if ( slot_list[bucket[j2]] == slot ) {
+	      found = false;
+	    }
+	  }
+	  slot_list[bucket[j]] = slot;
+	}
+	if ( found ) {
+	  break;
+	}
+      }
+      if ( disp == disp_limit ) {
+	ok = false;
+	break;
+      }
+      mKeywordDisp[order[k]] = disp;
+      for (ymuint j = 0; j < bucket.size(); ++ j) {
+	used[slot_list[bucket[j]]] = true;
+      }
+    }
+    if ( ok ) {
+      break;
+    }
+  }
+
+  mKeywordTable.resize(n);
+  mKeywordMaxLen = 0;
+  for (ymuint i = 0; i < n; ++ i) {
+    if ( mKeywordMaxLen < literal_list[i].size() ) {
+      mKeywordMaxLen = literal_list[i].size();
+    }
+    Keyword& kw = mKeywordTable[slot_list[i]];
+    kw.mTop = mKeywordChars.size();
+    kw.mLen = literal_list[i].size();
+    kw.mToken = token_list[i];
+    kw.mHost = host_list[i];
+    mKeywordChars += literal_list[i];
+  }
+}
+
+// @brief キーワードを探す．
+// @param[in] str 字句の先頭
+// @param[in] len 字句の長さ
+// @param[in] host DFA が受理したトークン番号
+// @return キーワードならそのトークン番号を，そうでなければ host を返す．
+//
+// ハッシュ値から位置を求め，そこにあるキーワードと一度だけ比べる．
+ymuint
+Lexer::find_keyword(const char* str,
+		    ymuint len,
+		    ymuint host) const
+{
+  ymuint64 h = hash_bytes(str, len, mKeywordSeed);
+  ymuint n = mKeywordTable.size();
+  ymuint disp = mKeywordDisp[hash_bucket(h, mKeywordDisp.size())];
+  const Keyword& kw = mKeywordTable[hash_slot(h, disp, n)];
+  if ( kw.mLen == len && kw.mHost == host &&
+       memcmp(mKeywordChars.data() + kw.mTop, str, len) == 0 ) {
+    return kw.mToken;
+  }
+  return host;
+}
+
+// @brief 受け付けるトークンの集合の中から次のトークンを読む．
+// @param[inout] pos 読む位置．読んだトークンの次の位置に進む．
+// @param[in] end 入力の末尾
+// @param[out] start 読んだトークンの字句の先頭
+// @param[in] acceptable 受け付けるトークン番号のビットベクタ
+// @return トークン番号を返す．
+//
+// 遷移のたびに，その先で受理しうるトークンに受け付けるものが
+// あるか (読み飛ばすパターンかキーワードを含む) を調べ，なければ
+// そこで止める．受理する状態では受理するパターンを優先順位の順に
+// 調べ，受け付ける最初のものを覚える．
+// キーワードを持つトークンが受け付けられない時は，その長さの字句が
+// 受け付けるキーワードかどうかを完全ハッシュで調べる．
+// キーワードを持つトークンを受け付けた時は最後にキーワードかどうかを
+// 調べ，キーワードも受け付けるならそちらにする．
+// これは全てのパターンを一つの DFA にした時と同じ結果になる．
+ymuint
+Lexer::next_token(const char*& pos,
+		  const char* end,
+		  const char*& start,
+		  const ymuint64* acceptable) const
+{
+  for ( ; ; ) {
+    start = pos;
+    if ( pos == end ) {
+      return Grammer::kEnd;
+    }
+    ymuint token = kNoToken;
+    const char* last = pos;
+    ymuint state = 0;
+    for (const char* p = pos; p != end; ) {
+      state = mTransList[state * mClassNum + mByteClass[static_cast<ymuint8>(*p)]];
+      if ( state == kNoState ) {
+	break;
+      }
+      ++ p;
+      ymuint len = p - pos;
+
+      // この先で受け付けるトークンを受理しうるかを調べる．
+      ymuint8 flag = mLiveFlag[state];
+      bool live = (flag & kLiveSkip) ||
+	((flag & kLiveKeyword) && len <= mKeywordMaxLen);
+      const ymuint64* bits = &mLiveBits[state * mTokenWordNum];
+      for (ymuint w = 0; w < mTokenWordNum && !live; ++ w) {
+	if ( bits[w] & acceptable[w] ) {
+	  live = true;
+	}
+      }
+      if ( !live ) {
+	break;
+      }
+
+      ymuint tok = kNoToken;
+      bool by_prefix = false;
+      for (ymuint i = mAcceptTop[state]; i < mAcceptTop[state + 1]; ++ i) {
+	ymuint t = mAcceptAll[i];
+	if ( t == kSkipToken || ((acceptable[t / 64] >> (t % 64)) & 1ULL) ) {
+	  tok = t;
+	  break;
+	}
+	if ( mHasKeyword[t] && len <= mKeywordMaxLen ) {
+	  by_prefix = true;
+	  ymuint kw = find_keyword(pos, len, t);
+	  if ( kw != t && ((acceptable[kw / 64] >> (kw % 64)) & 1ULL) ) {
+	    tok = kw;
+	    break;
+	  }
+	}
+      }
+
+      // 字句の長さでトークンが変わらない時だけまとめて読み飛ばす．
+      ymuint run = mRunIndex[state];
+      if ( !by_prefix && run != kNoState && p != end &&
+	   mTransList[state * mClassNum + mByteClass[static_cast<ymuint8>(*p)]] == state ) {
+	p = mSkipFunc(mRunList[run], p + 1, end);
+      }
+      if ( tok != kNoToken ) {
+	token = tok;
+	last = p;
+      }
+    }
+    if ( token == kNoToken ) {
+      return kNoToken;
+    }
+    pos = last;
+    if ( token != kSkipToken ) {
+      if ( mHasKeyword[token] ) {
+	ymuint kw = find_keyword(start, last - start, token);
+	if ( kw != token && ((acceptable[kw / 64] >> (kw % 64)) & 1ULL) ) {
+	  token = kw;
+	}
+      }
+      return token;
+    }
+  }
+}
+
+// @brief 表の大きさ (バイト数) を返す．
+ymuint64
+Lexer::table_bytes() const
+{
+  return sizeof(mByteClass)
+    + mTransList.size() * sizeof(ymuint)
+    + mAcceptList.size() * sizeof(ymuint)
+    + mRunIndex.size() * sizeof(ymuint)
+    + mRunList.size() * sizeof(Run)
+    + mHasKeyword.size() * sizeof(ymuint8)
+    + mKeywordDisp.size() * sizeof(ymuint)
+    + mKeywordTable.size() * sizeof(Keyword)
+    + mKeywordChars.size()
+    + mAcceptTop.size() * sizeof(ymuint)
+    + mAcceptAll.size() * sizeof(ymuint)
+    + mLiveBits.size() * sizeof(ymuint64)
+    + mLiveFlag.size() * sizeof(ymuint8);
+}
+
+// @brief まとめて読み飛ばす方式を設定する．
+// @param[in] mode 方式
+void
+Lexer::set_simd_mode(SimdMode mode)
+{
+  SimdMode best = best_simd_mode();
+  if ( mode > best ) {
+    mode = best;
+  }
+  mSimdMode = mode;
+  switch ( mode ) {
+  case kScalar: mSkipFunc = skip_scalar; break;
+  case kSSE2:   mSkipFunc = skip_sse2; break;
+  case kAVX2:   mSkipFunc = skip_avx2; break;
+  }
+}
+
+// @brief この CPU で使える最も速い方式を返す．
+Lexer::SimdMode
+Lexer::best_simd_mode()
+{
+#if LEXER_X86_SIMD
+  // SSE2 は x86_64 では必ず使える．
+  static SimdMode best = __builtin_cpu_supports("avx2") ? kAVX2 : kSSE2;
+  return best;
+#else
+  return kScalar;
+#endif
+}
+
+// @brief 1 バイトずつ読み飛ばす．
+const char*
+Lexer::skip_scalar(const Run& run,
+		   const char* p,
+		   const char* end)
+{
+  for ( ; p != end; ++ p) {
+    ymuint8 c = static_cast<ymuint8>(*p);
+    bool in = false;
+    for (ymuint i = 0; i < run.mNum; ++ i) {
+      if ( static_cast<ymuint8>(c - run.mLo[i]) <= run.mHi[i] - run.mLo[i] ) {
+	in = true;
+	break;
+      }
+    }
+    if ( !in ) {
+      break;
+    }
+  }
+  return p;
+}
+
+#if LEXER_X86_SIMD
+
+BEGIN_NONAMESPACE
+
+// 範囲の数が num の時の SSE2 による読み飛ばし
+//
+// 範囲の判定は符号なしの (c - lo) <= (hi - lo) を
+// min(c - lo, hi - lo) == c - lo で行う．
+// num をテンプレート引数にして範囲のループを展開させる．
+template<ymuint num>
+inline
+const char*
+skip_sse2_n(const ymuint8* lo_list,
+	    const ymuint8* hi_list,
+	    const char* p,
+	    const char* end)
+{
+  __m128i lo[num];
+  __m128i width[num];
+  for (ymuint i = 0; i < num; ++ i) {
+    lo[i] = _mm_set1_epi8(static_cast<char>(lo_list[i]));
+    width[i] = _mm_set1_epi8(static_cast<char>(hi_list[i] - lo_list[i]));
+  }
+  while ( end - p >= 16 ) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i in = _mm_setzero_si128();
+    for (ymuint i = 0; i < num; ++ i) {
+      __m128i d = _mm_sub_epi8(x, lo[i]);
+      in = _mm_or_si128(in, _mm_cmpeq_epi8(_mm_min_epu8(d, width[i]), d));
+    }
+    ymuint mask = _mm_movemask_epi8(in);
+    if ( mask != 0xFFFFU ) {
+      return p + __builtin_ctz(~mask);
+    }
+    p += 16;
+  }
+  return p;
+}
+
+// 範囲の数が num の時の AVX2 による読み飛ばし
+template<ymuint num>
+__attribute__((target("avx2")))
+inline
+const char*
+skip_avx2_n(const ymuint8* lo_list,
+	    const ymuint8* hi_list,
+	    const char* p,
+	    const char* end)
+{
+  __m256i lo[num];
+  __m256i width[num];
+  for (ymuint i = 0; i < num; ++ i) {
+    lo[i] = _mm256_set1_epi8(static_cast<char>(lo_list[i]));
+    width[i] = _mm256_set1_epi8(static_cast<char>(hi_list[i] - lo_list[i]));
+  }
+  while ( end - p >= 32 ) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i in = _mm256_setzero_si256();
+    for (ymuint i = 0; i < num; ++ i) {
+      __m256i d = _mm256_sub_epi8(x, lo[i]);
+      in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_min_epu8(d, width[i]), d));
+    }
+    ymuint32 mask = _mm256_movemask_epi8(in);
+    if ( mask != 0xFFFFFFFFU ) {
+      return p + __builtin_ctz(~mask);
+    }
+    p += 32;
+  }
+  return p;
+}
+
+END_NONAMESPACE
+
+// @brief SSE2 で読み飛ばす．
+//
+// 16 バイトに満たない末尾は 1 バイトずつ調べる．
+const char*
+Lexer::skip_sse2(const Run& run,
+		 const char* p,
+		 const char* end)
+{
+  switch ( run.mNum ) {
+  case 1: p = skip_sse2_n<1>(run.mLo, run.mHi, p, end); break;
+  case 2: p = skip_sse2_n<2>(run.mLo, run.mHi, p, end); break;
+  case 3: p = skip_sse2_n<3>(run.mLo, run.mHi, p, end); break;
+  case 4: p = skip_sse2_n<4>(run.mLo, run.mHi, p, end); break;
+  }
+  if ( end - p >= 16 ) {
+    // 範囲の外のバイトで止まった．
+    return p;
+  }
+  return skip_scalar(run, p, end);
+}
+
+// @brief AVX2 で読み飛ばす．
+//
+// 32 バイトに満たない末尾は SSE2 で調べる．
+__attribute__((target("avx2")))
+const char*
+Lexer::skip_avx2(const Run& run,
+		 const char* p,
+		 const char* end)
+{
+  switch ( run.mNum ) {
+  case 1: p = skip_avx2_n<1>(run.mLo, run.mHi, p, end); break;
+  case 2: p = skip_avx2_n<2>(run.mLo, run.mHi, p, end); break;
+  case 3: p = skip_avx2_n<3>(run.mLo, run.mHi, p, end); break;
+  case 4: p = skip_avx2_n<4>(run.mLo, run.mHi, p, end); break;
+  }
+  if ( end - p >= 32 ) {
+    // 範囲の外のバイトで止まった．
+    return p;
+  }
+  return skip_sse2(run, p, end);
+}
+
+#else
+
+// @brief SSE2 で読み飛ばす．
+//
+// この環境では使えないので set_simd_mode() で選ばれることはない．
+const char*
+Lexer::skip_sse2(const Run& run,
+		 const char* p,
+		 const char* end)
+{
+  return skip_scalar(run, p, end);
+}
+
+// @brief AVX2 で読み飛ばす．
+//
+// この環境では使えないので set_simd_mode() で選ばれることはない．
+const char*
+Lexer::skip_avx2(const Run& run,
+		 const char* p,
+		 const char* end)
+{
+  return skip_scalar(run, p, end);
+}
+
+#endif
+
+// @brief 内容を出力する．
+// @param[in] s 出力先のストリーム
+// @param[in] grammer 元となった文法
+void
+Lexer::print(ostream& s,
+	     const Grammer& grammer) const
+{
+  s << "Lexer: " << mStateNum << " states, " << mClassNum << " classes, "
+    << mBackupNum << " backup states, "
+    << mRunList.size() << " run states" << endl;
+  if ( !mKeywordTable.empty() ) {
+    s << "  keywords: " << mKeywordTable.size() << " in "
+      << mKeywordDisp.size() << " buckets (seed: " << mKeywordSeed << ")"
+      << endl;
+    for (ymuint i = 0; i < mKeywordTable.size(); ++ i) {
+      const Keyword& kw = mKeywordTable[i];
+      s << "    K#" << i << ": \"" << mKeywordChars.substr(kw.mTop, kw.mLen)
+	<< "\" " << grammer.token(kw.mToken)->str()
+	<< " (in " << grammer.token(kw.mHost)->str() << ")" << endl;
+    }
+  }
+
+  // 同値類ごとにバイトの範囲を出力する．
+  for (ymuint k = 0; k < mClassNum; ++ k) {
+    s << "  C#" << k << ":";
+    ymuint c = 0;
+    while ( c < 256 ) {
+      if ( mByteClass[c] != k ) {
+	++ c;
+	continue;
+      }
+      ymuint c2 = c;
+      while ( c2 + 1 < 256 && mByteClass[c2 + 1] == k ) {
+	++ c2;
+      }
+      s << " ";
+      print_byte(s, c);
+      if ( c2 > c ) {
+	s << "-";
+	print_byte(s, c2);
+      }
+      c = c2 + 1;
+    }
+    s << endl;
+  }
+
+  for (ymuint state = 0; state < mStateNum; ++ state) {
+    s << "  S#" << state << ":";
+    ymuint token = mAcceptList[state];
+    if ( token == kSkipToken ) {
+      s << " accept (skip)";
+    }
+    else if ( token != kNoToken ) {
+      s << " accept " << grammer.token(token)->str();
+    }
+    ymuint run = mRunIndex[state];
+    if ( run != kNoState ) {
+      s << " run";
+      const Run& r = mRunList[run];
+      for (ymuint i = 0; i < r.mNum; ++ i) {
+	s << " ";
+	print_byte(s, r.mLo[i]);
+	if ( r.mHi[i] > r.mLo[i] ) {
+	  s << "-";
+	  print_byte(s, r.mHi[i]);
+	}
+      }
+    }
+    s << endl;
+    const char* head = "   ";
+    for (ymuint k = 0; k < mClassNum; ++ k) {
+      ymuint next = mTransList[state * mClassNum + k];
+      if ( next != kNoState ) {
+	s << head << " C#" << k << "->S#" << next;
+	head = "";
+      }
+    }
+    if ( head[0] == '\0' ) {
+      s << endl;
+    }
+  }
+  s << endl;
+}
+
+// @brief 入力全体をトークン番号の列にする．
+// @param[in] text 入力の先頭
+// @param[in] size 入力のバイト数
+// @param[out] token_list トークン番号の列 (文末記号は含まない)
+// @return 読み終えたバイト数を返す．
+ymuint64
+Lexer::scan(const char* text,
+	    ymuint64 size,
+	    vector<ymuint>& token_list) const
+{
+  const char* pos = text;
+  const char* end = text + size;
+  for ( ; ; ) {
+    ymuint token = next_token(pos, end);
+    if ( token == Grammer::kEnd ) {
+      return size;
+    }
+    if ( token == kNoToken ) {
+      return pos - text;
+    }
+    token_list.push_back(token);
+  }
+}
+
+// @brief 入力全体をトークン番号と字句の列にする．
+// @param[in] text 入力の先頭
+// @param[in] size 入力のバイト数
+// @param[out] token_list トークン番号の列 (文末記号は含まない)
+// @param[out] text_list トークンごとの字句
+// @return 読み終えたバイト数を返す．
+ymuint64
+Lexer::scan(const char* text,
+	    ymuint64 size,
+	    vector<ymuint>& token_list,
+	    vector<StrView>& text_list) const
+{
+  const char* pos = text;
+  const char* end = text + size;
+  for ( ; ; ) {
+    const char* start;
+    ymuint token = next_token(pos, end, start);
+    if ( token == Grammer::kEnd ) {
+      return size;
+    }
+    if ( token == kNoToken ) {
+      return pos - text;
+    }
+    token_list.push_back(token);
+    text_list.push_back(StrView(start, pos - start));
+  }
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,592 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+/// @file Lexer.h
+/// @brief Lexer のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include "Grammer.h"
+#include "StrView.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class Lexer Lexer.h "Lexer.h"
+/// @brief 終端記号のパターンから作られる字句解析器
+///
+/// Grammer::set_pattern() で終端記号に設定した正規表現と
+/// Grammer::add_skip_pattern() で追加した読み飛ばすパターンから
+/// 決定性有限オートマトン (DFA) を作る．
+/// 正規表現から Thompson の方法で NFA を作り，部分集合構成法で DFA に
+/// してから状態を最小化する．
+///
+/// 正規表現は以下のものからなる．バイト単位で扱う．
+/// - 文字: そのバイト自身
+/// - . : 改行以外の任意のバイト
+/// - [...] : 文字クラス．a-z の範囲と先頭の ^ による否定を書ける．
+/// - \\n \\t \\r \\f \\v \\0 \\xHH : 制御文字
+/// - \\d \\w \\s (と大文字の否定) : 数字，単語の文字，空白
+/// - \\ とその他の文字 : その文字自身
+/// - ( ) : グループ
+/// - | : 選択
+/// - * + ? : 繰り返し
+/// 書き方が誤っているパターンはエラーを出力して無視する．
+///
+/// 全てのパターンで同じ遷移をするバイトを一つの同値類にまとめ，
+/// 遷移表は (状態, 同値類) で引く．状態 0 が初期状態である．
+/// 字句解析は最長一致で，複数のパターンに一致する時はトークン番号の
+/// 小さい方とする．受理したトークンは Token::id() で表す．
+///
+/// 文字列そのもののパターン (キーワード) で，優先順位の低い他の
+/// パターン (識別子など) が同じ文字列全体を受理するものは DFA から除く．
+/// DFA がそのパターンを受理した時に，字句から最小完全ハッシュで
+/// 位置を求め，そこにあるキーワードと一度比べて見分ける．
+/// キーワードが多くても DFA は大きくならず，探す手間はキーワードの
+/// 数によらない．
+///
+/// 構文解析器の状態で受け付けるトークンの集合 (ParseTable::
+/// acceptable_tokens()) を next_token() に渡すと，その集合のトークン
+/// だけを対象にした字句解析を行う．字句の上で重なるトークンを
+/// 構文解析器の状態で見分けられる．各状態から受理しうるトークンの
+/// 集合を持ち，受け付けるトークンを受理しえなくなった所で止める．
+///
+/// 自分自身への遷移を持つ状態 (空白，識別子の続き，数字，注釈の本体など)
+/// のうち，とどまるバイトの集合が kRunRangeMax 個以下の範囲で表せる
+/// ものは，とどまる間のバイトをまとめて読み飛ばす．読み飛ばしには
+/// 実行時に CPU を調べて AVX2 か SSE2 を用い，使えない時は
+/// 1 バイトずつ調べる．set_simd_mode() で方式を選び直せる．
+//////////////////////////////////////////////////////////////////////
+class Lexer
+{
+public:
+
+  /// @brief 遷移がないことを表す状態番号
+  static
+  const ymuint kNoState = 0xFFFFFFFFU;
+
+  /// @brief 受理しないことを表すトークン番号
+  static
+  const ymuint kNoToken = 0xFFFFFFFFU;
+
+  /// @brief 読み飛ばすパターンを受理したことを表すトークン番号
+  static
+  const ymuint kSkipToken = 0xFFFFFFFEU;
+
+  /// @brief まとめて読み飛ばすバイトの範囲の最大数
+  static
+  const ymuint kRunRangeMax = 4;
+
+  /// @brief まとめて読み飛ばす方式
+  enum SimdMode {
+    /// @brief 1 バイトずつ調べる．
+    kScalar,
+    /// @brief SSE2 で 16 バイトずつ調べる．
+    kSSE2,
+    /// @brief AVX2 で 32 バイトずつ調べる．
+    kAVX2
+  };
+
+
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] grammer パターンを持つ文法
+  /// @param[in] split_keyword キーワードを DFA から除く時 true にする．
+  Lexer(const Grammer& grammer,
+	bool split_keyword = true);
+
+  /// @brief デストラクタ
+  ~Lexer();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 遷移表の情報を取り出す関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 状態数を返す．
+  ymuint
+  state_num() const;
+
+  /// @brief バイトの同値類の数を返す．
+  ymuint
+  class_num() const;
+
+  /// @brief バイトの同値類番号を返す．
+  /// @param[in] c バイト
+  ymuint
+  byte_class(ymuint8 c) const;
+
+  /// @brief 次の状態を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] cls 同値類番号
+  ///
+  /// 遷移がない時は kNoState を返す．
+  ymuint
+  next_state(ymuint state,
+	     ymuint cls) const;
+
+  /// @brief 状態で受理するトークン番号を返す．
+  /// @param[in] state 状態番号
+  ///
+  /// 受理しない時は kNoToken を，読み飛ばすパターンの時は
+  /// kSkipToken を返す．
+  ymuint
+  accept_token(ymuint state) const;
+
+  /// @brief 読み戻しが必要になりうる状態の数を返す．
+  ///
+  /// 受理しない状態で遷移のない同値類を持つもの (初期状態を除く) の数．
+  /// 0 の時は一度読んだバイトを読み直すことがない．
+  ymuint
+  backup_num() const;
+
+  /// @brief 書き方が誤っていて無視したパターンの数を返す．
+  ymuint
+  error_num() const;
+
+  /// @brief まとめて読み飛ばす状態の数を返す．
+  ymuint
+  run_state_num() const;
+
+  /// @brief DFA から除いたキーワードの数を返す．
+  ymuint
+  keyword_num() const;
+
+  /// @brief まとめて読み飛ばす方式を返す．
+  SimdMode
+  simd_mode() const;
+
+  /// @brief まとめて読み飛ばす方式を設定する．
+  /// @param[in] mode 方式
+  ///
+  /// この CPU で使えない方式の時は使える中で最も速いものになる．
+  void
+  set_simd_mode(SimdMode mode);
+
+  /// @brief この CPU で使える最も速い方式を返す．
+  static
+  SimdMode
+  best_simd_mode();
+
+  /// @brief 表の大きさ (バイト数) を返す．
+  ymuint64
+  table_bytes() const;
+
+  /// @brief 内容を出力する．
+  /// @param[in] s 出力先のストリーム
+  /// @param[in] grammer 元となった文法
+  void
+  print(ostream& s,
+	const Grammer& grammer) const;
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 字句解析を行う関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 次のトークンを読む．
+  /// @param[inout] pos 読む位置．読んだトークンの次の位置に進む．
+  /// @param[in] end 入力の末尾
+  /// @return トークン番号を返す．
+  ///
+  /// 読み飛ばすパターンは読み飛ばす．入力の末尾では Grammer::kEnd を，
+  /// どのパターンにも一致しない時は kNoToken を返す．
+  /// kNoToken の時 pos は一致しなかった字句の先頭を指す．
+  ymuint
+  next_token(const char*& pos,
+	     const char* end) const;
+
+  /// @brief 次のトークンを読んで字句の先頭も返す．
+  /// @param[inout] pos 読む位置．読んだトークンの次の位置に進む．
+  /// @param[in] end 入力の末尾
+  /// @param[out] start 読んだトークンの字句の先頭
+  /// @return トークン番号を返す．
+  ///
+  /// 字句は [start, pos) である．読み飛ばした字句は含まない．
+  ymuint
+  next_token(const char*& pos,
+	     const char* end,
+	     const char*& start) const;
+
+  /// @brief 受け付けるトークンの集合の中から次のトークンを読む．
+  /// @param[inout] pos 読む位置．読んだトークンの次の位置に進む．
+  /// @param[in] end 入力の末尾
+  /// @param[out] start 読んだトークンの字句の先頭
+  /// @param[in] acceptable 受け付けるトークン番号のビットベクタ
+  /// @return トークン番号を返す．
+  ///
+  /// acceptable は ParseTable::acceptable_tokens() と同じ形式で，
+  /// パターンを作った文法と同じトークン番号を用いる．
+  /// 読み飛ばすパターンは常に受け付ける．
+  /// 受け付けるトークンがどれも一致しない時は kNoToken を返す．
+  ymuint
+  next_token(const char*& pos,
+	     const char* end,
+	     const char*& start,
+	     const ymuint64* acceptable) const;
+
+  /// @brief 入力全体をトークン番号の列にする．
+  /// @param[in] text 入力の先頭
+  /// @param[in] size 入力のバイト数
+  /// @param[out] token_list トークン番号の列 (文末記号は含まない)
+  /// @return 読み終えたバイト数を返す．
+  ///
+  /// size より小さい時はその位置でエラーになっている．
+  ymuint64
+  scan(const char* text,
+       ymuint64 size,
+       vector<ymuint>& token_list) const;
+
+  /// @brief 入力全体をトークン番号と字句の列にする．
+  /// @param[in] text 入力の先頭
+  /// @param[in] size 入力のバイト数
+  /// @param[out] token_list トークン番号の列 (文末記号は含まない)
+  /// @param[out] text_list トークンごとの字句
+  /// @return 読み終えたバイト数を返す．
+  ///
+  /// 字句は text の中を指すので複写もメモリ確保も行わない．
+  /// text は text_list を使い終わるまで有効でなければならない．
+  ymuint64
+  scan(const char* text,
+       ymuint64 size,
+       vector<ymuint>& token_list,
+       vector<StrView>& text_list) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられるデータ構造
+  //////////////////////////////////////////////////////////////////////
+
+  // まとめて読み飛ばすバイトの範囲
+  struct Run
+  {
+    // 範囲の下限
+    ymuint8 mLo[kRunRangeMax];
+
+    // 範囲の上限
+    ymuint8 mHi[kRunRangeMax];
+
+    // 範囲の数
+    ymuint mNum;
+  };
+
+  // 完全ハッシュ表のキーワード
+  struct Keyword
+  {
+    // mKeywordChars 中の先頭位置
+    ymuint mTop;
+
+    // 長さ
+    ymuint mLen;
+
+    // トークン番号
+    ymuint mToken;
+
+    // 字句として受理するトークン番号
+    ymuint mHost;
+  };
+
+  // mLiveFlag のビット
+  enum {
+    // 読み飛ばすパターンを受理しうる．
+    kLiveSkip = 1,
+    // キーワードを持つトークンを受理しうる．
+    kLiveKeyword = 2
+  };
+
+  // 読み飛ばしを行う関数の型
+  // [p, end) の先頭から run に含まれるバイトを読み飛ばした位置を返す．
+  typedef const char* (*SkipFunc)(const Run& run,
+				  const char* p,
+				  const char* end);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief キーワードの完全ハッシュ表を作る．
+  /// @param[in] literal_list キーワードの文字列のリスト
+  /// @param[in] token_list キーワードのトークン番号のリスト
+  /// @param[in] host_list キーワードを字句として受理するトークン番号のリスト
+  void
+  build_keyword(const vector<string>& literal_list,
+		const vector<ymuint>& token_list,
+		const vector<ymuint>& host_list);
+
+  /// @brief キーワードを探す．
+  /// @param[in] str 字句の先頭
+  /// @param[in] len 字句の長さ
+  /// @param[in] host DFA が受理したトークン番号
+  /// @return キーワードならそのトークン番号を，そうでなければ host を返す．
+  ymuint
+  find_keyword(const char* str,
+	       ymuint len,
+	       ymuint host) const;
+
+  /// @brief 1 バイトずつ読み飛ばす．
+  static
+  const char*
+  skip_scalar(const Run& run,
+	      const char* p,
+	      const char* end);
+
+  /// @brief SSE2 で読み飛ばす．
+  static
+  const char*
+  skip_sse2(const Run& run,
+	    const char* p,
+	    const char* end);
+
+  /// @brief AVX2 で読み飛ばす．
+  static
+  const char*
+  skip_avx2(const Run& run,
+	    const char* p,
+	    const char* end);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 状態数
+  ymuint mStateNum;
+
+  // 同値類の数
+  ymuint mClassNum;
+
+  // バイトから同値類番号への変換表
+  ymuint8 mByteClass[256];
+
+  // 遷移表
+  // 状態番号 * mClassNum + 同値類番号 で引く．
+  vector<ymuint> mTransList;
+
+  // 状態ごとの受理するトークン番号
+  vector<ymuint> mAcceptList;
+
+  // 状態ごとの mRunList 中の番号 (まとめて読み飛ばさない時は kNoState)
+  vector<ymuint> mRunIndex;
+
+  // まとめて読み飛ばすバイトの範囲のリスト
+  vector<Run> mRunList;
+
+  // まとめて読み飛ばす方式
+  SimdMode mSimdMode;
+
+  // 読み飛ばしを行う関数
+  SkipFunc mSkipFunc;
+
+  // トークン番号ごとのキーワードを持つかどうかの印
+  vector<ymuint8> mHasKeyword;
+
+  // 完全ハッシュのバケットごとのずらし量
+  vector<ymuint> mKeywordDisp;
+
+  // 完全ハッシュ表
+  vector<Keyword> mKeywordTable;
+
+  // キーワードの文字を並べたもの
+  string mKeywordChars;
+
+  // 完全ハッシュの種
+  ymuint64 mKeywordSeed;
+
+  // キーワードの最大の長さ
+  ymuint mKeywordMaxLen;
+
+  // 状態ごとの mAcceptAll 中の先頭位置 (大きさは mStateNum + 1)
+  vector<ymuint> mAcceptTop;
+
+  // 受理するトークン番号を状態ごとに優先順位の順に並べたもの
+  vector<ymuint> mAcceptAll;
+
+  // トークン番号のビットベクタの語数
+  ymuint mTokenWordNum;
+
+  // 状態ごとの受理しうるトークン番号のビットベクタ
+  // (状態番号 * mTokenWordNum + 語の位置) で引く．
+  vector<ymuint64> mLiveBits;
+
+  // 状態ごとの受理しうるものの印 (kLiveSkip と kLiveKeyword)
+  vector<ymuint8> mLiveFlag;
+
+  // 読み戻しが必要になりうる状態の数
+  ymuint mBackupNum;
+
+  // 無視したパターンの数
+  ymuint mErrorNum;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 状態数を返す．
+inline
+ymuint
+Lexer::state_num() const
+{
+  return mStateNum;
+}
+
+// @brief バイトの同値類の数を返す．
+inline
+ymuint
+Lexer::class_num() const
+{
+  return mClassNum;
+}
+
+// @brief バイトの同値類番号を返す．
+// @param[in] c バイト
+inline
+ymuint
+Lexer::byte_class(ymuint8 c) const
+{
+  return mByteClass[c];
+}
+
+// @brief 次の状態を返す．
+// @param[in] state 状態番号
+// @param[in] cls 同値類番号
+inline
+ymuint
+Lexer::next_state(ymuint state,
+		  ymuint cls) const
+{
+  return mTransList[state * mClassNum + cls];
+}
+
+// @brief 状態で受理するトークン番号を返す．
+// @param[in] state 状態番号
+inline
+ymuint
+Lexer::accept_token(ymuint state) const
+{
+  return mAcceptList[state];
+}
+
+// @brief 読み戻しが必要になりうる状態の数を返す．
+inline
+ymuint
+Lexer::backup_num() const
+{
+  return mBackupNum;
+}
+
+// @brief 書き方が誤っていて無視したパターンの数を返す．
+inline
+ymuint
+Lexer::error_num() const
+{
+  return mErrorNum;
+}
+
+// @brief まとめて読み飛ばす状態の数を返す．
+inline
+ymuint
+Lexer::run_state_num() const
+{
+  return mRunList.size();
+}
+
+// @brief DFA から除いたキーワードの数を返す．
+inline
+ymuint
+Lexer::keyword_num() const
+{
+  return mKeywordTable.size();
+}
+
+// @brief まとめて読み飛ばす方式を返す．
+inline
+Lexer::SimdMode
+Lexer::simd_mode() const
+{
+  return mSimdMode;
+}
+
+// @brief 次のトークンを読む．
+// @param[inout] pos 読む位置．読んだトークンの次の位置に進む．
+// @param[in] end 入力の末尾
+// @return トークン番号を返す．
+inline
+ymuint
+Lexer::next_token(const char*& pos,
+		  const char* end) const
+{
+  const char* start;
+  return next_token(pos, end, start);
+}
+
+// @brief 次のトークンを読んで字句の先頭も返す．
+// @param[inout] pos 読む位置．読んだトークンの次の位置に進む．
+// @param[in] end 入力の末尾
+// @param[out] start 読んだトークンの字句の先頭
+// @return トークン番号を返す．
+//
+// 最後に受理した位置を覚えながら遷移がなくなるまで進む．
+// 初期状態の受理は空の字句になるので用いない．
+// キーワードを持つトークンの時は完全ハッシュで見分ける．
+// 次のバイトでも同じ状態にとどまる時は，その先をまとめて読み飛ばす．
+inline
+ymuint
+Lexer::next_token(const char*& pos,
+		  const char* end,
+		  const char*& start) const
+{
+  for ( ; ; ) {
+    start = pos;
+    if ( pos == end ) {
+      return Grammer::kEnd;
+    }
+    ymuint token = kNoToken;
+    const char* last = pos;
+    ymuint state = 0;
+    for (const char* p = pos; p != end; ) {
+      state = mTransList[state * mClassNum + mByteClass[static_cast<ymuint8>(*p)]];
+      if ( state == kNoState ) {
+	break;
+      }
+      ++ p;
+      ymuint run = mRunIndex[state];
+      if ( run != kNoState && p != end &&
+	   mTransList[state * mClassNum + mByteClass[static_cast<ymuint8>(*p)]] == state ) {
+	p = mSkipFunc(mRunList[run], p + 1, end);
+      }
+      if ( mAcceptList[state] != kNoToken ) {
+	token = mAcceptList[state];
+	last = p;
+      }
+    }
+    if ( token == kNoToken ) {
+      return kNoToken;
+    }
+    pos = last;
+    if ( token != kSkipToken ) {
+      if ( mHasKeyword[token] ) {
+	token = find_keyword(start, last - start, token);
+      }
+      return token;
+    }
+  }
+}
+
+END_NAMESPACE_YM
+
+#endif // LEXER_H
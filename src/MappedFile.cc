@@ -0,0 +1,169 @@
+
+/// @file MappedFile.cc
+/// @brief MappedFile の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPEDFILE_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#else
+#define MAPPEDFILE_HAVE_MMAP 0
+#endif
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// クラス MappedFile
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+MappedFile::MappedFile() :
+  mData(""),
+  mSize(0),
+  mOpen(false)
+{
+}
+
+// @brief デストラクタ
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#if MAPPEDFILE_HAVE_MMAP
+
+// @brief ファイルを写像する．
+// @param[in] filename ファイル名
+// @param[in] flags オプション (kSequential などの論理和)
+// @return 成功した時 true を返す．
+bool
+MappedFile::open(const string& filename,
+		 ymuint flags)
+{
+  close();
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if ( fd < 0 ) {
+    cerr << filename << ": " << strerror(errno) << endl;
+    return false;
+  }
+  struct stat st;
+  if ( fstat(fd, &st) < 0 ) {
+    cerr << filename << ": " << strerror(errno) << endl;
+    ::close(fd);
+    return false;
+  }
+
+  mSize = st.st_size;
+  if ( mSize == 0 ) {
+    // 長さ 0 の写像は作れないので空の内容とする．
+    ::close(fd);
+    mOpen = true;
+    return true;
+  }
+
+  int mmap_flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+  if ( flags & kPopulate ) {
+    mmap_flags |= MAP_POPULATE;
+  }
+#endif
+  void* p = mmap(NULL, mSize, PROT_READ, mmap_flags, fd, 0);
+  // 写像は fd を閉じても残る．
+  ::close(fd);
+  if ( p == MAP_FAILED ) {
+    cerr << filename << ": " << strerror(errno) << endl;
+    mSize = 0;
+    return false;
+  }
+
+  // madvise(2) は指示にすぎないので失敗しても続ける．
+  if ( flags & kSequential ) {
+    madvise(p, mSize, MADV_SEQUENTIAL);
+  }
+#if defined(MADV_HUGEPAGE)
+  if ( flags & kHugePage ) {
+    madvise(p, mSize, MADV_HUGEPAGE);
+  }
+#endif
+#if defined(MADV_WILLNEED)
+  if ( flags & kPopulate ) {
+    madvise(p, mSize, MADV_WILLNEED);
+  }
+#endif
+
+  mData = static_cast<const char*>(p);
+  mOpen = true;
+  return true;
+}
+
+// @brief 写像を解除する．
+void
+MappedFile::close()
+{
+  if ( mSize > 0 ) {
+    munmap(const_cast<char*>(mData), mSize);
+  }
+  mData = "";
+  mSize = 0;
+  mOpen = false;
+}
+
+#else
+
+// @brief ファイルを写像する．
+// @param[in] filename ファイル名
+// @param[in] flags オプション (kSequential などの論理和)
+// @return 成功した時 true を返す．
+//
+// mmap(2) がないので内容を読み込む．flags は用いない．
+bool
+MappedFile::open(const string& filename,
+		 ymuint flags)
+{
+  close();
+
+  ifstream in(filename.c_str(), ios::binary);
+  if ( !in ) {
+    cerr << filename << ": cannot open" << endl;
+    return false;
+  }
+  in.seekg(0, ios::end);
+  mSize = in.tellg();
+  in.seekg(0, ios::beg);
+  if ( mSize > 0 ) {
+    char* buf = new char[mSize];
+    in.read(buf, mSize);
+    mData = buf;
+  }
+  mOpen = true;
+  return true;
+}
+
+// @brief 写像を解除する．
+void
+MappedFile::close()
+{
+  if ( mSize > 0 ) {
+    delete [] mData;
+  }
+  mData = "";
+  mSize = 0;
+  mOpen = false;
+}
+
+#endif
+
+END_NAMESPACE_YM
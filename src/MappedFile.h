@@ -0,0 +1,173 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+/// @file MappedFile.h
+/// @brief MappedFile のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include "StrView.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class MappedFile MappedFile.h "MappedFile.h"
+/// @brief 読み出し専用でメモリに写像したファイル
+///
+/// mmap(2) でファイル全体を写像し，内容を複写せずに data() で見せる．
+/// Lexer::scan() に data() と size() を渡すとトークンの字句も
+/// 写像の中を指す StrView になるので，入力の複写も字句ごとの
+/// メモリ確保も起こらない．StrView は close() まで有効である．
+///
+/// open() のオプションで madvise(2) の指示を与えられる．
+/// - kSequential : 先頭から順に読む (先読みを増やす)
+/// - kHugePage : 大きなページを用いる (ファイルシステムが対応する時のみ)
+/// - kPopulate : 写像の時点で全体を読み込む
+/// 対応していない指示は無視する．
+/// mmap(2) のない環境では内容を読み込んだ領域を用いる．
+//////////////////////////////////////////////////////////////////////
+class MappedFile
+{
+public:
+
+  /// @brief open() のオプション
+  enum {
+    /// @brief 先頭から順に読む
+    kSequential = 1,
+    /// @brief 大きなページを用いる
+    kHugePage = 2,
+    /// @brief 写像の時点で全体を読み込む
+    kPopulate = 4
+  };
+
+
+public:
+
+  /// @brief コンストラクタ
+  MappedFile();
+
+  /// @brief デストラクタ
+  ///
+  /// 開いている時は close() する．
+  ~MappedFile();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief ファイルを写像する．
+  /// @param[in] filename ファイル名
+  /// @param[in] flags オプション (kSequential などの論理和)
+  /// @return 成功した時 true を返す．
+  ///
+  /// 開いていたファイルは先に close() する．
+  /// 失敗した時はエラーを出力する．
+  bool
+  open(const string& filename,
+       ymuint flags = kSequential);
+
+  /// @brief 写像を解除する．
+  void
+  close();
+
+  /// @brief 開いている時 true を返す．
+  bool
+  is_open() const;
+
+  /// @brief 内容の先頭を返す．
+  ///
+  /// 末尾の '\\0' はない．
+  const char*
+  data() const;
+
+  /// @brief 内容のバイト数を返す．
+  ymuint64
+  size() const;
+
+  /// @brief 内容の一部を返す．
+  /// @param[in] pos 先頭の位置
+  /// @param[in] len 長さ
+  StrView
+  view(ymuint64 pos,
+       ymuint len) const;
+
+
+private:
+
+  // コピーは禁止
+  MappedFile(const MappedFile& src);
+
+  // 代入は禁止
+  const MappedFile&
+  operator=(const MappedFile& src);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 内容の先頭
+  const char* mData;
+
+  // 内容のバイト数
+  ymuint64 mSize;
+
+  // 開いている時 true
+  // mSize が 0 でない時，内容は mmap(2) で写像したもの
+  // (mmap(2) のない環境では new[] で確保したもの) である．
+  bool mOpen;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 開いている時 true を返す．
+inline
+bool
+MappedFile::is_open() const
+{
+  return mOpen;
+}
+
+// @brief 内容の先頭を返す．
+inline
+const char*
+MappedFile::data() const
+{
+  return mData;
+}
+
+// @brief 内容のバイト数を返す．
+inline
+ymuint64
+MappedFile::size() const
+{
+  return mSize;
+}
+
+// @brief 内容の一部を返す．
+// @param[in] pos 先頭の位置
+// @param[in] len 長さ
+inline
+StrView
+MappedFile::view(ymuint64 pos,
+		 ymuint len) const
+{
+  ASSERT_COND( pos + len <= mSize );
+  return StrView(mData + pos, len);
+}
+
+END_NAMESPACE_YM
+
+#endif // MAPPEDFILE_H
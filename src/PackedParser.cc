@@ -0,0 +1,186 @@
+
+/// @file PackedParser.cc
+/// @brief PackedParser の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "PackedParser.h"
+#include "PackedTable.h"
+#include "LRParser.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+// PackedTable<SymbolType, StateType, CodeType> を用いる PackedParser
+//////////////////////////////////////////////////////////////////////
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+class PackedParserImpl :
+  public PackedParser
+{
+public:
+
+  typedef PackedTable<SymbolType, StateType, CodeType> TableType;
+
+  // コンストラクタ
+  PackedParserImpl(const ParseTable& table) :
+    mTable(table),
+    mParser(mTable)
+  {
+  }
+
+  // デストラクタ
+  virtual
+  ~PackedParserImpl()
+  {
+  }
+
+  // 構文解析を行う．
+  virtual
+  bool
+  parse(const vector<ymuint>& input,
+	ymuint entry)
+  {
+    return mParser.parse(input, entry);
+  }
+
+  // トークンを一つずつ渡す構文解析を始める．
+  virtual
+  void
+  start(ymuint entry)
+  {
+    mParser.start(entry);
+  }
+
+  // トークンを一つ渡す．
+  // PushResult の値の並びは LRParserT と同じである．
+  virtual
+  PushResult
+  push(ymuint token)
+  {
+    return static_cast<PushResult>(mParser.push(token));
+  }
+
+  // 直前の構文解析で行った reduce の回数を返す．
+  virtual
+  ymuint64
+  reduce_num() const
+  {
+    return mParser.reduce_num();
+  }
+
+  // 直前の構文解析でエラーになった入力の位置を返す．
+  virtual
+  ymuint
+  error_pos() const
+  {
+    return mParser.error_pos();
+  }
+
+  // 記号の要素のバイト数を返す．
+  virtual
+  ymuint
+  symbol_width() const
+  {
+    return sizeof(SymbolType);
+  }
+
+  // 状態の要素のバイト数を返す．
+  virtual
+  ymuint
+  state_width() const
+  {
+    return sizeof(StateType);
+  }
+
+  // 動作のコードのバイト数を返す．
+  virtual
+  ymuint
+  code_width() const
+  {
+    return sizeof(CodeType);
+  }
+
+  // 表の使用量(バイト)を返す．
+  virtual
+  ymuint64
+  table_bytes() const
+  {
+    return mTable.table_bytes();
+  }
+
+
+private:
+
+  // 構文解析表
+  // mParser が参照するので先に初期化する．
+  TableType mTable;
+
+  // 構文解析器
+  LRParserT<TableType> mParser;
+
+};
+
+// 型が合えば PackedParserImpl を作る．
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+PackedParser*
+try_new(const ParseTable& table)
+{
+  if ( !PackedTable<SymbolType, StateType, CodeType>::fits(table) ) {
+    return NULL;
+  }
+  return new PackedParserImpl<SymbolType, StateType, CodeType>(table);
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス PackedParser
+//////////////////////////////////////////////////////////////////////
+
+// @brief インスタンスを作る．
+// @param[in] table 元となる構文解析表
+PackedParser*
+PackedParser::new_obj(const ParseTable& table)
+{
+  // 表全体が最も小さくなる順に試す．
+  // 動作表が最も大きいので CodeType を優先して狭くする．
+  PackedParser* parser = try_new<ymuint8, ymuint8, ymuint16>(table);
+  if ( parser == NULL ) {
+    parser = try_new<ymuint8, ymuint16, ymuint16>(table);
+  }
+  if ( parser == NULL ) {
+    parser = try_new<ymuint16, ymuint16, ymuint16>(table);
+  }
+  if ( parser == NULL ) {
+    parser = try_new<ymuint8, ymuint16, ymuint32>(table);
+  }
+  if ( parser == NULL ) {
+    parser = try_new<ymuint16, ymuint16, ymuint32>(table);
+  }
+  if ( parser == NULL ) {
+    parser = try_new<ymuint16, ymuint32, ymuint32>(table);
+  }
+  if ( parser == NULL ) {
+    parser = try_new<ymuint32, ymuint32, ymuint32>(table);
+  }
+  ASSERT_COND( parser != NULL );
+  return parser;
+}
+
+// @brief デストラクタ
+PackedParser::~PackedParser()
+{
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,126 @@
+#ifndef PACKEDPARSER_H
+#define PACKEDPARSER_H
+
+/// @file PackedParser.h
+/// @brief PackedParser のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class ParseTable;
+
+//////////////////////////////////////////////////////////////////////
+/// @class PackedParser PackedParser.h "PackedParser.h"
+/// @brief PackedTable を用いる構文解析器の基底クラス
+///
+/// new_obj() が ParseTable の大きさから要素の型が最も狭い
+/// PackedTable を選んで，対応する LRParserT を持つ実装を作る．
+/// 型の選択は表を作る時に一度だけ行い，parse() の中の表引きは
+/// それぞれの型に特化される．
+/// LRParserT と同じく start() と push() でトークンを一つずつ渡す
+/// こともできる．PackedTable は受け付ける終端記号の集合を持たないので
+/// acceptable_tokens() はなく，文脈に応じた字句解析には ParseTable を
+/// 用いる LRParser を使う．
+//////////////////////////////////////////////////////////////////////
+class PackedParser
+{
+public:
+
+  /// @brief push() の結果
+  ///
+  /// 値の並びは LRParserT::PushResult と同じである．
+  enum PushResult {
+    /// @brief 次のトークンが必要
+    kNeedMore,
+    /// @brief 受理した
+    kAccepted,
+    /// @brief エラーになった
+    kRejected
+  };
+
+
+  /// @brief インスタンスを作る．
+  /// @param[in] table 元となる構文解析表
+  ///
+  /// table の内容は複製されるので，この後 table を破棄してもよい．
+  static
+  PackedParser*
+  new_obj(const ParseTable& table);
+
+  /// @brief デストラクタ
+  virtual
+  ~PackedParser();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 構文解析を行う．
+  /// @param[in] input 入力のトークン番号の列
+  /// @param[in] entry 入口番号
+  /// @return 受理した時 true を返す．
+  virtual
+  bool
+  parse(const vector<ymuint>& input,
+	ymuint entry = 0) = 0;
+
+  /// @brief トークンを一つずつ渡す構文解析を始める．
+  /// @param[in] entry 入口番号
+  virtual
+  void
+  start(ymuint entry = 0) = 0;
+
+  /// @brief トークンを一つ渡す．
+  /// @param[in] token トークン番号 (入力の終わりは Grammer::kEnd)
+  /// @return 結果を返す．
+  ///
+  /// kAccepted か kRejected を返した後は start() を呼ぶまで
+  /// 同じ結果を返す．
+  virtual
+  PushResult
+  push(ymuint token) = 0;
+
+  /// @brief 直前の構文解析で行った reduce の回数を返す．
+  virtual
+  ymuint64
+  reduce_num() const = 0;
+
+  /// @brief 直前の構文解析でエラーになった入力の位置を返す．
+  virtual
+  ymuint
+  error_pos() const = 0;
+
+  /// @brief 記号の要素のバイト数を返す．
+  virtual
+  ymuint
+  symbol_width() const = 0;
+
+  /// @brief 状態の要素のバイト数を返す．
+  virtual
+  ymuint
+  state_width() const = 0;
+
+  /// @brief 動作のコードのバイト数を返す．
+  virtual
+  ymuint
+  code_width() const = 0;
+
+  /// @brief 表の使用量(バイト)を返す．
+  virtual
+  ymuint64
+  table_bytes() const = 0;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // PACKEDPARSER_H
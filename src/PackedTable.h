@@ -0,0 +1,504 @@
+#ifndef PACKEDTABLE_H
+#define PACKEDTABLE_H
+
+/// @file PackedTable.h
+/// @brief PackedTable のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include "ParseTable.h"
+#include "BuildStats.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class PackedTable PackedTable.h "PackedTable.h"
+/// @brief 要素を狭い整数型で持つ ParseTable の複製
+///
+/// - SymbolType: トークン番号，同値類番号，非終端記号の通し番号，
+///               右辺の長さ
+/// - StateType:  状態番号，動作表の行の位置，規則番号，goto の例外の位置
+/// - CodeType:   動作のコード
+///
+/// 表の構造と動作のコードの形式は ParseTable と同じなので，
+/// LRParserT でそのまま用いることができる．
+/// StateType の最大値は遷移先がないことを，SymbolType の最大値は
+/// 疎な行の末尾を表すのに用いる．
+/// 各型に収まるかどうかは fits() で調べる．
+//////////////////////////////////////////////////////////////////////
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+class PackedTable
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] table 元となる構文解析表
+  ///
+  /// fits(table) が true でなければならない．
+  PackedTable(const ParseTable& table);
+
+  /// @brief デストラクタ
+  ~PackedTable();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 表の要素がそれぞれの型に収まる時 true を返す．
+  /// @param[in] table 対象の構文解析表
+  static
+  bool
+  fits(const ParseTable& table);
+
+  /// @brief 状態数を返す．
+  ymuint
+  state_num() const;
+
+  /// @brief 入口の数を返す．
+  ymuint
+  start_num() const;
+
+  /// @brief 初期状態の番号を返す．
+  /// @param[in] pos 入口番号 ( 0 <= pos < start_num() )
+  ymuint
+  start_state(ymuint pos = 0) const;
+
+  /// @brief 動作を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] token_id 先読みのトークン番号
+  ymuint32
+  action(ymuint state,
+	 ymuint token_id) const;
+
+  /// @brief 状態の既定の動作を返す．
+  /// @param[in] state 状態番号
+  ymuint32
+  default_action(ymuint state) const;
+
+  /// @brief 非終端記号による遷移先を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] token_id 非終端記号のトークン番号
+  ymuint
+  goto_state(ymuint state,
+	     ymuint token_id) const;
+
+  /// @brief トークン数を返す．
+  ymuint
+  token_num() const;
+
+  /// @brief 規則数を返す．
+  ymuint
+  rule_num() const;
+
+  /// @brief 規則の左辺のトークン番号を返す．
+  /// @param[in] rule_id 規則番号
+  ymuint
+  rule_left(ymuint rule_id) const;
+
+  /// @brief 規則の右辺の長さを返す．
+  /// @param[in] rule_id 規則番号
+  ymuint
+  rule_size(ymuint rule_id) const;
+
+  /// @brief 表の使用量(バイト)を返す．
+  ymuint64
+  table_bytes() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 配列を狭い型の配列に写す．
+  /// @param[in] src 元の配列
+  /// @param[out] dst 写し先の配列
+  /// @param[in] no_val src 中で dst_no_val に置き換える値
+  /// @param[in] dst_no_val 置き換え後の値
+  template<typename SrcType,
+	   typename DstType>
+  static
+  void
+  narrow_copy(const vector<SrcType>& src,
+	      vector<DstType>& dst,
+	      SrcType no_val = 0,
+	      DstType dst_no_val = 0);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる定数
+  //////////////////////////////////////////////////////////////////////
+
+  // 遷移先がないことを表す値
+  static
+  const StateType kNoPackedState = static_cast<StateType>(-1);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 同値類の数
+  ymuint mClassNum;
+
+  // 入口番号をキーにした初期状態の配列
+  vector<StateType> mStartState;
+
+  // トークン番号をキーにした同値類番号の配列
+  vector<SymbolType> mTokenClass;
+
+  // トークン番号をキーにした非終端記号の通し番号の配列
+  // 終端記号の場合は 0
+  vector<SymbolType> mNontermIndex;
+
+  // 状態番号をキーにした動作表の行の位置の配列
+  // 下位 2 ビットが ParseTable::RowKind
+  vector<StateType> mActionRow;
+
+  // 状態番号をキーにした既定の動作の配列
+  vector<CodeType> mDefaultAction;
+
+  // 動作表
+  // (行番号 * mClassNum + 同値類番号) をキーにした配列
+  vector<CodeType> mAction;
+
+  // 疎な行の同値類番号の配列
+  vector<SymbolType> mSparseClass;
+
+  // 疎な行の動作の配列
+  vector<CodeType> mSparseAction;
+
+  // 非終端記号の通し番号をキーにした goto の既定値の配列
+  vector<StateType> mGotoDefault;
+
+  // 非終端記号の通し番号をキーにした例外の先頭位置の配列
+  vector<StateType> mGotoExcTop;
+
+  // goto の例外の状態番号の配列
+  vector<StateType> mGotoExcState;
+
+  // goto の例外の遷移先の配列
+  vector<StateType> mGotoExcNext;
+
+  // 規則番号をキーにした左辺のトークン番号の配列
+  vector<SymbolType> mRuleLeft;
+
+  // 規則番号をキーにした右辺の長さの配列
+  vector<SymbolType> mRuleSize;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// 定数の定義
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+const StateType PackedTable<SymbolType, StateType, CodeType>::kNoPackedState;
+
+// @brief コンストラクタ
+// @param[in] table 元となる構文解析表
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+PackedTable<SymbolType, StateType, CodeType>::PackedTable(const ParseTable& table) :
+  mClassNum(table.mClassNum)
+{
+  ASSERT_COND( fits(table) );
+
+  narrow_copy(table.mStartState, mStartState);
+  narrow_copy(table.mTokenClass, mTokenClass);
+  narrow_copy(table.mNontermIndex, mNontermIndex, ParseTable::kNoIndex);
+  narrow_copy(table.mActionRow, mActionRow);
+  narrow_copy(table.mDefaultAction, mDefaultAction);
+  narrow_copy(table.mAction, mAction);
+  narrow_copy(table.mSparseClass, mSparseClass, ParseTable::kNoIndex,
+	      static_cast<SymbolType>(-1));
+  narrow_copy(table.mSparseAction, mSparseAction);
+  narrow_copy(table.mGotoDefault, mGotoDefault, ParseTable::kNoState, kNoPackedState);
+  narrow_copy(table.mGotoExcTop, mGotoExcTop);
+  narrow_copy(table.mGotoExcState, mGotoExcState);
+  narrow_copy(table.mGotoExcNext, mGotoExcNext);
+  narrow_copy(table.mRuleLeft, mRuleLeft);
+  narrow_copy(table.mRuleSize, mRuleSize);
+}
+
+// @brief デストラクタ
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+PackedTable<SymbolType, StateType, CodeType>::~PackedTable()
+{
+}
+
+// @brief 表の要素がそれぞれの型に収まる時 true を返す．
+// @param[in] table 対象の構文解析表
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+bool
+PackedTable<SymbolType, StateType, CodeType>::fits(const ParseTable& table)
+{
+  // 最大値は疎な行の末尾に使うので同値類の数はそれより小さくなければならない．
+  const ymuint64 sym_limit = static_cast<SymbolType>(-1);
+  if ( table.token_num() > sym_limit || table.class_num() >= sym_limit ) {
+    return false;
+  }
+  for (ymuint r = 0; r < table.rule_num(); ++ r) {
+    if ( table.rule_size(r) > sym_limit ) {
+      return false;
+    }
+  }
+
+  // 最大値は kNoPackedState に使うので状態数はそれより小さくなければならない．
+  if ( table.state_num() >= kNoPackedState ||
+       table.rule_num() > kNoPackedState ||
+       table.goto_exception_num() > kNoPackedState ) {
+    return false;
+  }
+  for (ymuint s = 0; s < table.state_num(); ++ s) {
+    if ( table.mActionRow[s] > kNoPackedState ) {
+      return false;
+    }
+  }
+
+  // 動作の引数は状態番号か規則番号
+  ymuint64 arg_max = table.state_num();
+  if ( arg_max < table.rule_num() ) {
+    arg_max = table.rule_num();
+  }
+  ymuint64 code_max = (arg_max << 3) | 7U;
+  if ( code_max > static_cast<CodeType>(-1) ) {
+    return false;
+  }
+
+  return true;
+}
+
+// @brief 状態数を返す．
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::state_num() const
+{
+  return mActionRow.size();
+}
+
+// @brief 入口の数を返す．
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::start_num() const
+{
+  return mStartState.size();
+}
+
+// @brief 初期状態の番号を返す．
+// @param[in] pos 入口番号
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::start_state(ymuint pos) const
+{
+  return mStartState[pos];
+}
+
+// @brief 動作を返す．
+// @param[in] state 状態番号
+// @param[in] token_id 先読みのトークン番号
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint32
+PackedTable<SymbolType, StateType, CodeType>::action(ymuint state,
+						     ymuint token_id) const
+{
+  ymuint cls = mTokenClass[token_id];
+  ymuint pos = mActionRow[state];
+  ymuint idx = pos >> 2;
+  switch ( pos & 3U ) {
+  case ParseTable::kDenseRow:
+    {
+      ymuint32 code = mAction[idx * mClassNum + cls];
+      if ( code == ParseTable::kDefaultAction ) {
+	code = mDefaultAction[state];
+      }
+      return code;
+    }
+
+  case ParseTable::kSparseRow:
+    while ( mSparseClass[idx] < cls ) {
+      ++ idx;
+    }
+    if ( mSparseClass[idx] == cls ) {
+      return mSparseAction[idx];
+    }
+    return ParseTable::make_action(ParseTable::kError);
+
+  default:
+    return mDefaultAction[state];
+  }
+}
+
+// @brief 状態の既定の動作を返す．
+// @param[in] state 状態番号
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint32
+PackedTable<SymbolType, StateType, CodeType>::default_action(ymuint state) const
+{
+  return mDefaultAction[state];
+}
+
+// @brief 非終端記号による遷移先を返す．
+// @param[in] state 状態番号
+// @param[in] token_id 非終端記号のトークン番号
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::goto_state(ymuint state,
+							 ymuint token_id) const
+{
+  ymuint idx = mNontermIndex[token_id];
+  typename vector<StateType>::const_iterator b = mGotoExcState.begin() + mGotoExcTop[idx];
+  typename vector<StateType>::const_iterator e = mGotoExcState.begin() + mGotoExcTop[idx + 1];
+  typename vector<StateType>::const_iterator p = lower_bound(b, e, static_cast<StateType>(state));
+  if ( p != e && *p == state ) {
+    return mGotoExcNext[p - mGotoExcState.begin()];
+  }
+  StateType next = mGotoDefault[idx];
+  if ( next == kNoPackedState ) {
+    return ParseTable::kNoState;
+  }
+  return next;
+}
+
+// @brief トークン数を返す．
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::token_num() const
+{
+  return mTokenClass.size();
+}
+
+// @brief 規則数を返す．
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::rule_num() const
+{
+  return mRuleLeft.size();
+}
+
+// @brief 規則の左辺のトークン番号を返す．
+// @param[in] rule_id 規則番号
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::rule_left(ymuint rule_id) const
+{
+  return mRuleLeft[rule_id];
+}
+
+// @brief 規則の右辺の長さを返す．
+// @param[in] rule_id 規則番号
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+inline
+ymuint
+PackedTable<SymbolType, StateType, CodeType>::rule_size(ymuint rule_id) const
+{
+  return mRuleSize[rule_id];
+}
+
+// @brief 表の使用量(バイト)を返す．
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+ymuint64
+PackedTable<SymbolType, StateType, CodeType>::table_bytes() const
+{
+  return vector_bytes(mStartState)
+    + vector_bytes(mTokenClass)
+    + vector_bytes(mNontermIndex)
+    + vector_bytes(mActionRow)
+    + vector_bytes(mDefaultAction)
+    + vector_bytes(mAction)
+    + vector_bytes(mSparseClass)
+    + vector_bytes(mSparseAction)
+    + vector_bytes(mGotoDefault)
+    + vector_bytes(mGotoExcTop)
+    + vector_bytes(mGotoExcState)
+    + vector_bytes(mGotoExcNext)
+    + vector_bytes(mRuleLeft)
+    + vector_bytes(mRuleSize);
+}
+
+// @brief 配列を狭い型の配列に写す．
+// @param[in] src 元の配列
+// @param[out] dst 写し先の配列
+// @param[in] no_val src 中で dst_no_val に置き換える値
+// @param[in] dst_no_val 置き換え後の値
+template<typename SymbolType,
+	 typename StateType,
+	 typename CodeType>
+template<typename SrcType,
+	 typename DstType>
+void
+PackedTable<SymbolType, StateType, CodeType>::narrow_copy(const vector<SrcType>& src,
+							  vector<DstType>& dst,
+							  SrcType no_val,
+							  DstType dst_no_val)
+{
+  ymuint n = src.size();
+  dst.clear();
+  dst.reserve(n);
+  for (ymuint i = 0; i < n; ++ i) {
+    SrcType val = src[i];
+    if ( no_val != 0 && val == no_val ) {
+      dst.push_back(dst_no_val);
+    }
+    else {
+      DstType val1 = static_cast<DstType>(val);
+      ASSERT_COND( val1 == val );
+      dst.push_back(val1);
+    }
+  }
+}
+
+END_NAMESPACE_YM
+
+#endif // PACKEDTABLE_H
@@ -0,0 +1,143 @@
+
+/// @file ParseCounter.cc
+/// @brief ParseCounter の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "ParseCounter.h"
+#include "Grammer.h"
+#include "Token.h"
+#include "Rule.h"
+#include <sstream>
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// JSON の文字列として書き出す．
+void
+write_json_string(ostream& s,
+		  const string& str)
+{
+  s << '"';
+  for (string::const_iterator p = str.begin(); p != str.end(); ++ p) {
+    char c = *p;
+    switch ( c ) {
+    case '"':  s << "\\\""; break;
+    case '\\': s << "\\\\"; break;
+    case '\n': s << "\\n"; break;
+    case '\t': s << "\\t"; break;
+    default:
+      if ( static_cast<unsigned char>(c) < 0x20 ) {
+	const char* hex = "0123456789abcdef";
+	s << "\\u00" << hex[(c >> 4) & 15] << hex[c & 15];
+      }
+      else {
+	s << c;
+      }
+      break;
+    }
+  }
+  s << '"';
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス ParseCounter
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+ParseCounter::ParseCounter()
+{
+  clear(0, 0);
+}
+
+// @brief デストラクタ
+ParseCounter::~ParseCounter()
+{
+}
+
+// @brief 大きさを設定し，内容をクリアする．
+// @param[in] token_num トークン数
+// @param[in] rule_num 規則数
+void
+ParseCounter::clear(ymuint token_num,
+		    ymuint rule_num)
+{
+  mParseNum = 0;
+  mShiftNum.clear();
+  mShiftNum.resize(token_num, 0);
+  mReduceNum.clear();
+  mReduceNum.resize(rule_num, 0);
+  mDefaultReduceNum = 0;
+  mGotoNum = 0;
+  mMaxDepth = 0;
+}
+
+// @brief 内容を JSON 形式で書き出す．
+// @param[in] s 出力先のストリーム
+// @param[in] grammer 構文解析表の元となった文法
+void
+ParseCounter::write_json(ostream& s,
+			 const Grammer& grammer) const
+{
+  ymuint64 shift_total = 0;
+  for (vector<ymuint64>::const_iterator p = mShiftNum.begin();
+       p != mShiftNum.end(); ++ p) {
+    shift_total += *p;
+  }
+  ymuint64 reduce_total = 0;
+  for (vector<ymuint64>::const_iterator p = mReduceNum.begin();
+       p != mReduceNum.end(); ++ p) {
+    reduce_total += *p;
+  }
+
+  s << "{" << endl
+    << "  \"parse_num\": " << mParseNum << "," << endl
+    << "  \"shift_num\": " << shift_total << "," << endl
+    << "  \"reduce_num\": " << reduce_total << "," << endl
+    << "  \"default_reduce_num\": " << mDefaultReduceNum << "," << endl
+    << "  \"goto_num\": " << mGotoNum << "," << endl
+    << "  \"max_stack_depth\": " << mMaxDepth << "," << endl;
+
+  s << "  \"tokens\": [";
+  const char* comma = "";
+  for (ymuint i = 0; i < mShiftNum.size(); ++ i) {
+    if ( mShiftNum[i] == 0 ) {
+      continue;
+    }
+    s << comma << endl
+      << "    { \"id\": " << i << ", \"name\": ";
+    write_json_string(s, grammer.token(i)->str());
+    s << ", \"shift\": " << mShiftNum[i] << " }";
+    comma = ",";
+  }
+  s << endl
+    << "  ]," << endl;
+
+  s << "  \"rules\": [";
+  comma = "";
+  for (ymuint i = 0; i < mReduceNum.size(); ++ i) {
+    if ( mReduceNum[i] == 0 ) {
+      continue;
+    }
+    ostringstream buf;
+    grammer.rule(i)->print(buf);
+    s << comma << endl
+      << "    { \"id\": " << i << ", \"rule\": ";
+    write_json_string(s, buf.str());
+    s << ", \"reduce\": " << mReduceNum[i] << " }";
+    comma = ",";
+  }
+  s << endl
+    << "  ]" << endl
+    << "}" << endl;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,316 @@
+#ifndef PARSECOUNTER_H
+#define PARSECOUNTER_H
+
+/// @file ParseCounter.h
+/// @brief ParseCounter のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class Grammer;
+
+//////////////////////////////////////////////////////////////////////
+/// @class NullParseCounter ParseCounter.h "ParseCounter.h"
+/// @brief 何も数えない計数方針
+///
+/// LRParserT の既定の計数方針．全ての関数が空のインライン関数なので
+/// 計数の処理はコンパイル時に取り除かれる．
+//////////////////////////////////////////////////////////////////////
+struct NullParseCounter
+{
+  /// @brief 大きさを設定し，内容をクリアする．
+  void
+  clear(ymuint token_num,
+	ymuint rule_num)
+  {
+  }
+
+  /// @brief 構文解析の開始を数える．
+  void
+  count_parse()
+  {
+  }
+
+  /// @brief shift を数える．
+  void
+  count_shift(ymuint token_id)
+  {
+  }
+
+  /// @brief reduce を数える．
+  void
+  count_reduce(ymuint rule_id)
+  {
+  }
+
+  /// @brief 既定の reduce を数える．
+  void
+  count_default_reduce()
+  {
+  }
+
+  /// @brief goto 表の参照を数える．
+  void
+  count_goto()
+  {
+  }
+
+  /// @brief 状態スタックの深さを記録する．
+  void
+  count_depth(ymuint depth)
+  {
+  }
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class ParseCounter ParseCounter.h "ParseCounter.h"
+/// @brief 構文解析中の動作を数える計数方針
+///
+/// LRParserT<TableType, ParseCounter> で用いると以下を数える．
+/// - トークンごとの shift の回数 (shift-reduce 動作を含む)
+/// - 規則ごとの reduce の回数 (shift-reduce 動作を含む)
+/// - 状態の既定の動作と同じ reduce の回数
+/// - goto 表の参照回数
+/// - 状態スタックの深さの最大値
+/// 結果は write_json() で規則とトークンの名前つきで書き出す．
+/// 規則は Grammer::print_rules() と同じ形式で表す．
+//////////////////////////////////////////////////////////////////////
+class ParseCounter
+{
+public:
+
+  /// @brief コンストラクタ
+  ParseCounter();
+
+  /// @brief デストラクタ
+  ~ParseCounter();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 計数用の関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 大きさを設定し，内容をクリアする．
+  /// @param[in] token_num トークン数
+  /// @param[in] rule_num 規則数
+  void
+  clear(ymuint token_num,
+	ymuint rule_num);
+
+  /// @brief 構文解析の開始を数える．
+  void
+  count_parse();
+
+  /// @brief shift を数える．
+  /// @param[in] token_id shift したトークン番号
+  void
+  count_shift(ymuint token_id);
+
+  /// @brief reduce を数える．
+  /// @param[in] rule_id reduce した規則番号
+  void
+  count_reduce(ymuint rule_id);
+
+  /// @brief 既定の reduce を数える．
+  ///
+  /// count_reduce() とは別に呼ばれる．
+  void
+  count_default_reduce();
+
+  /// @brief goto 表の参照を数える．
+  void
+  count_goto();
+
+  /// @brief 状態スタックの深さを記録する．
+  /// @param[in] depth 深さ
+  void
+  count_depth(ymuint depth);
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 結果を取り出す関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 構文解析の回数を返す．
+  ymuint64
+  parse_num() const;
+
+  /// @brief トークンの shift の回数を返す．
+  /// @param[in] token_id トークン番号
+  ymuint64
+  shift_num(ymuint token_id) const;
+
+  /// @brief 規則の reduce の回数を返す．
+  /// @param[in] rule_id 規則番号
+  ymuint64
+  reduce_num(ymuint rule_id) const;
+
+  /// @brief 既定の reduce の回数を返す．
+  ymuint64
+  default_reduce_num() const;
+
+  /// @brief goto 表の参照回数を返す．
+  ymuint64
+  goto_num() const;
+
+  /// @brief 状態スタックの深さの最大値を返す．
+  ymuint
+  max_depth() const;
+
+  /// @brief 内容を JSON 形式で書き出す．
+  /// @param[in] s 出力先のストリーム
+  /// @param[in] grammer 構文解析表の元となった文法
+  ///
+  /// 回数が 0 のトークンと規則は書き出さない．
+  void
+  write_json(ostream& s,
+	     const Grammer& grammer) const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 構文解析の回数
+  ymuint64 mParseNum;
+
+  // トークン番号をキーにした shift の回数の配列
+  vector<ymuint64> mShiftNum;
+
+  // 規則番号をキーにした reduce の回数の配列
+  vector<ymuint64> mReduceNum;
+
+  // 既定の reduce の回数
+  ymuint64 mDefaultReduceNum;
+
+  // goto 表の参照回数
+  ymuint64 mGotoNum;
+
+  // 状態スタックの深さの最大値
+  ymuint mMaxDepth;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 構文解析の開始を数える．
+inline
+void
+ParseCounter::count_parse()
+{
+  ++ mParseNum;
+}
+
+// @brief shift を数える．
+// @param[in] token_id shift したトークン番号
+inline
+void
+ParseCounter::count_shift(ymuint token_id)
+{
+  ++ mShiftNum[token_id];
+}
+
+// @brief reduce を数える．
+// @param[in] rule_id reduce した規則番号
+inline
+void
+ParseCounter::count_reduce(ymuint rule_id)
+{
+  ++ mReduceNum[rule_id];
+}
+
+// @brief 既定の reduce を数える．
+inline
+void
+ParseCounter::count_default_reduce()
+{
+  ++ mDefaultReduceNum;
+}
+
+// @brief goto 表の参照を数える．
+inline
+void
+ParseCounter::count_goto()
+{
+  ++ mGotoNum;
+}
+
+// @brief 状態スタックの深さを記録する．
+// @param[in] depth 深さ
+inline
+void
+ParseCounter::count_depth(ymuint depth)
+{
+  if ( mMaxDepth < depth ) {
+    mMaxDepth = depth;
+  }
+}
+
+// @brief 構文解析の回数を返す．
+inline
+ymuint64
+ParseCounter::parse_num() const
+{
+  return mParseNum;
+}
+
+// @brief トークンの shift の回数を返す．
+// @param[in] token_id トークン番号
+inline
+ymuint64
+ParseCounter::shift_num(ymuint token_id) const
+{
+  return mShiftNum[token_id];
+}
+
+// @brief 規則の reduce の回数を返す．
+// @param[in] rule_id 規則番号
+inline
+ymuint64
+ParseCounter::reduce_num(ymuint rule_id) const
+{
+  return mReduceNum[rule_id];
+}
+
+// @brief 既定の reduce の回数を返す．
+inline
+ymuint64
+ParseCounter::default_reduce_num() const
+{
+  return mDefaultReduceNum;
+}
+
+// @brief goto 表の参照回数を返す．
+inline
+ymuint64
+ParseCounter::goto_num() const
+{
+  return mGotoNum;
+}
+
+// @brief 状態スタックの深さの最大値を返す．
+inline
+ymuint
+ParseCounter::max_depth() const
+{
+  return mMaxDepth;
+}
+
+END_NAMESPACE_YM
+
+#endif // PARSECOUNTER_H
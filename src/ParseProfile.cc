@@ -0,0 +1,118 @@
+
+/// @file ParseProfile.cc
+/// @brief ParseProfile の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "ParseProfile.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// クラス ParseProfile
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] state_num 状態数
+ParseProfile::ParseProfile(ymuint state_num)
+{
+  clear(state_num);
+}
+
+// @brief デストラクタ
+ParseProfile::~ParseProfile()
+{
+}
+
+// @brief 状態数を設定し，内容をクリアする．
+// @param[in] state_num 状態数
+void
+ParseProfile::clear(ymuint state_num)
+{
+  mStateCount.clear();
+  mStateCount.resize(state_num, 0);
+  mTransList.clear();
+  mTransList.resize(state_num);
+}
+
+// @brief 内容を書き出す．
+// @param[in] s 出力先のストリーム
+//
+// 形式は以下の通り．使用回数が 0 のものは書き出さない．
+// - 1 行目は状態数
+// - s <状態番号> <使用回数>
+// - t <遷移元> <遷移先> <使用回数>
+void
+ParseProfile::write(ostream& s) const
+{
+  ymuint n = state_num();
+  s << n << endl;
+  for (ymuint i = 0; i < n; ++ i) {
+    if ( mStateCount[i] > 0 ) {
+      s << "s " << i << " " << mStateCount[i] << endl;
+    }
+  }
+  for (ymuint i = 0; i < n; ++ i) {
+    const vector<pair<ymuint, ymuint64> >& trans_list = mTransList[i];
+    for (vector<pair<ymuint, ymuint64> >::const_iterator p = trans_list.begin();
+	 p != trans_list.end(); ++ p) {
+      s << "t " << i << " " << p->first << " " << p->second << endl;
+    }
+  }
+}
+
+// @brief 内容を読み込む．
+// @param[in] s 入力元のストリーム
+// @return 形式が正しければ true を返す．
+bool
+ParseProfile::read(istream& s)
+{
+  ymuint n;
+  if ( !(s >> n) ) {
+    return false;
+  }
+  clear(n);
+
+  string tag;
+  while ( s >> tag ) {
+    if ( tag == "s" ) {
+      ymuint state;
+      ymuint64 count;
+      if ( !(s >> state >> count) || state >= n ) {
+	return false;
+      }
+      mStateCount[state] += count;
+    }
+    else if ( tag == "t" ) {
+      ymuint from;
+      ymuint to;
+      ymuint64 count;
+      if ( !(s >> from >> to >> count) || from >= n || to >= n ) {
+	return false;
+      }
+      vector<pair<ymuint, ymuint64> >& trans_list = mTransList[from];
+      vector<pair<ymuint, ymuint64> >::iterator p = trans_list.begin();
+      for ( ; p != trans_list.end(); ++ p) {
+	if ( p->first == to ) {
+	  break;
+	}
+      }
+      if ( p != trans_list.end() ) {
+	p->second += count;
+      }
+      else {
+	trans_list.push_back(make_pair(to, count));
+      }
+    }
+    else {
+      return false;
+    }
+  }
+  return true;
+}
+
+END_NAMESPACE_YM
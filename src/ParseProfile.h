@@ -0,0 +1,163 @@
+#ifndef PARSEPROFILE_H
+#define PARSEPROFILE_H
+
+/// @file ParseProfile.h
+/// @brief ParseProfile のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class ParseProfile ParseProfile.h "ParseProfile.h"
+/// @brief 構文解析中の状態と遷移の使用回数を記録するクラス
+///
+/// LRParserT::set_profile() で設定すると，動作を引いた状態ごとの回数と
+/// 状態スタックに積んだ遷移 (積む直前のスタックの先頭, 積んだ状態)
+/// ごとの回数を数える．
+/// 結果は ParseTable::reorder() で状態番号のつけ直しに用いる．
+/// 状態番号は記録した時の ParseTable のものである．
+//////////////////////////////////////////////////////////////////////
+class ParseProfile
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] state_num 状態数
+  ParseProfile(ymuint state_num = 0);
+
+  /// @brief デストラクタ
+  ~ParseProfile();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 状態数を設定し，内容をクリアする．
+  /// @param[in] state_num 状態数
+  void
+  clear(ymuint state_num);
+
+  /// @brief 状態数を返す．
+  ymuint
+  state_num() const;
+
+  /// @brief 状態の使用回数を数える．
+  /// @param[in] state 状態番号
+  void
+  count_state(ymuint state);
+
+  /// @brief 遷移の使用回数を数える．
+  /// @param[in] from 遷移元の状態番号
+  /// @param[in] to 遷移先の状態番号
+  void
+  count_transition(ymuint from,
+		   ymuint to);
+
+  /// @brief 状態の使用回数を返す．
+  /// @param[in] state 状態番号
+  ymuint64
+  state_count(ymuint state) const;
+
+  /// @brief 状態から出る遷移と使用回数のリストを返す．
+  /// @param[in] state 状態番号
+  const vector<pair<ymuint, ymuint64> >&
+  transition_list(ymuint state) const;
+
+  /// @brief 内容を書き出す．
+  /// @param[in] s 出力先のストリーム
+  void
+  write(ostream& s) const;
+
+  /// @brief 内容を読み込む．
+  /// @param[in] s 入力元のストリーム
+  /// @return 形式が正しければ true を返す．
+  bool
+  read(istream& s);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 状態番号をキーにした使用回数の配列
+  vector<ymuint64> mStateCount;
+
+  // 状態番号をキーにした (遷移先, 使用回数) のリストの配列
+  vector<vector<pair<ymuint, ymuint64> > > mTransList;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 状態数を返す．
+inline
+ymuint
+ParseProfile::state_num() const
+{
+  return mStateCount.size();
+}
+
+// @brief 状態の使用回数を数える．
+// @param[in] state 状態番号
+inline
+void
+ParseProfile::count_state(ymuint state)
+{
+  ++ mStateCount[state];
+}
+
+// @brief 遷移の使用回数を数える．
+// @param[in] from 遷移元の状態番号
+// @param[in] to 遷移先の状態番号
+//
+// 遷移先の数は少ないので線形に探す．
+inline
+void
+ParseProfile::count_transition(ymuint from,
+			       ymuint to)
+{
+  vector<pair<ymuint, ymuint64> >& trans_list = mTransList[from];
+  for (vector<pair<ymuint, ymuint64> >::iterator p = trans_list.begin();
+       p != trans_list.end(); ++ p) {
+    if ( p->first == to ) {
+      ++ p->second;
+      return;
+    }
+  }
+  trans_list.push_back(make_pair(to, 1ULL));
+}
+
+// @brief 状態の使用回数を返す．
+// @param[in] state 状態番号
+inline
+ymuint64
+ParseProfile::state_count(ymuint state) const
+{
+  return mStateCount[state];
+}
+
+// @brief 状態から出る遷移と使用回数のリストを返す．
+// @param[in] state 状態番号
+inline
+const vector<pair<ymuint, ymuint64> >&
+ParseProfile::transition_list(ymuint state) const
+{
+  return mTransList[state];
+}
+
+END_NAMESPACE_YM
+
+#endif // PARSEPROFILE_H
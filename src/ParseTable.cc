@@ -0,0 +1,847 @@
+
+/// @file ParseTable.cc
+/// @brief ParseTable の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "ParseTable.h"
+#include "Grammer.h"
+#include "Token.h"
+#include "Rule.h"
+#include "LALR1Set.h"
+#include "LR0State.h"
+#include "BuildStats.h"
+#include "PhaseProfiler.h"
+#include "ParseProfile.h"
+#include "YmUtils/HashMap.h"
+
+
+BEGIN_NAMESPACE_YM
+
+// 動作表の列のハッシュ関数
+template<>
+struct
+HashFunc<vector<ymuint32> >
+{
+  ymuint
+  operator()(const vector<ymuint32>& key) const
+  {
+    ymuint ans = 0;
+    for (vector<ymuint32>::const_iterator p = key.begin();
+	 p != key.end(); ++ p) {
+      ans += (ans * 1023);
+      ans += *p;
+    }
+    return ans;
+  }
+};
+
+BEGIN_NONAMESPACE
+
+// 行を表に登録して行番号を返す．
+// 同じ内容の行が既にあればその番号を返す．
+template<typename T>
+ymuint
+share_row(const vector<T>& row,
+	  HashMap<vector<ymuint32>, ymuint>& row_map,
+	  vector<T>& table)
+{
+  vector<ymuint32> key(row.begin(), row.end());
+  ymuint id;
+  if ( !row_map.find(key, id) ) {
+    id = table.size() / row.size();
+    row_map.add(key, id);
+    table.insert(table.end(), row.begin(), row.end());
+  }
+  return id;
+}
+
+// 状態番号をつけ直した動作のコードを返す．
+inline
+ymuint32
+renumber_action(ymuint32 code,
+		const vector<ymuint>& new_id)
+{
+  if ( ParseTable::action_type(code) == ParseTable::kShift ) {
+    return ParseTable::make_action(ParseTable::kShift,
+				   new_id[ParseTable::action_arg(code)]);
+  }
+  return code;
+}
+
+// 使用回数の降順に並べるための比較関数
+// 回数が等しい時は状態番号の昇順にする．
+struct StateCountGt
+{
+  StateCountGt(const ParseProfile& profile) :
+    mProfile(profile)
+  {
+  }
+
+  bool
+  operator()(ymuint a,
+	     ymuint b) const
+  {
+    ymuint64 ca = mProfile.state_count(a);
+    ymuint64 cb = mProfile.state_count(b);
+    if ( ca != cb ) {
+      return ca > cb;
+    }
+    return a < b;
+  }
+
+  const ParseProfile& mProfile;
+};
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス ParseTable
+//////////////////////////////////////////////////////////////////////
+
+// 定数の定義
+const ymuint ParseTable::kNoState;
+const ymuint ParseTable::kNoIndex;
+const ymuint ParseTable::kSparseLimit;
+
+// @brief コンストラクタ
+// @param[in] grammer 元となる文法
+// @param[in] lalr1set 元となる LALR(1) 正準集
+// @param[in] stats 統計情報の記録先
+// @param[in] keep_conflict 衝突で捨てた動作も持つ時 true
+ParseTable::ParseTable(const Grammer& grammer,
+		       const LALR1Set& lalr1set,
+		       BuildStats* stats,
+		       bool keep_conflict)
+{
+  PhaseProfiler profiler(stats);
+  stats = profiler.stats();
+  PhaseTimer timer(stats, BuildStats::kEmit);
+
+  mStateNum = lalr1set.state_list().size();
+  ymuint ns = lalr1set.start_num();
+  mStartState.resize(ns);
+  for (ymuint k = 0; k < ns; ++ k) {
+    mStartState[k] = lalr1set.start_state(k)->id();
+  }
+
+  // 終端記号と非終端記号の通し番号は Grammer::freeze() でつけられている．
+  ymuint nt = grammer.token_num();
+  ymuint nterm = grammer.terminal_num();
+  vector<ymuint> term_index(nt, 0);
+  mNontermNum = grammer.nonterminal_num();
+  mNontermIndex.resize(nt, kNoIndex);
+  mTokenName.resize(nt);
+  for (ymuint i = 0; i < nt; ++ i) {
+    const Token* token = grammer.token(i);
+    mTokenName[i] = token->str();
+    if ( token->is_terminal() ) {
+      term_index[i] = token->dense_id();
+    }
+    else {
+      mNontermIndex[i] = token->dense_id() - nterm;
+    }
+  }
+
+  // まず終端記号ごとの動作表と goto 表を作る．
+  vector<ymuint32> full_action(mStateNum * nterm, make_action(kError));
+  vector<ymuint> full_goto(mStateNum * mNontermNum, kNoState);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    const vector<pair<const Token*, ymuint> >& shift_list = lalr1set.shift_list(s);
+    for (vector<pair<const Token*, ymuint> >::const_iterator p = shift_list.begin();
+	 p != shift_list.end(); ++ p) {
+      const Token* token = p->first;
+      ymuint next = p->second;
+      if ( token->is_terminal() ) {
+	full_action[s * nterm + term_index[token->id()]] = make_action(kShift, next);
+      }
+      else {
+	full_goto[s * mNontermNum + mNontermIndex[token->id()]] = next;
+      }
+    }
+    const vector<pair<const Token*, const Rule*> >& reduce_list = lalr1set.reduce_list(s);
+    for (vector<pair<const Token*, const Rule*> >::const_iterator p = reduce_list.begin();
+	 p != reduce_list.end(); ++ p) {
+      const Token* token = p->first;
+      const Rule* rule = p->second;
+      full_action[s * nterm + term_index[token->id()]] = make_action(kReduce, rule->id());
+    }
+  }
+  for (ymuint k = 0; k < ns; ++ k) {
+    full_action[lalr1set.accept_state(k) * nterm + term_index[Grammer::kEnd]] = make_action(kAccept);
+  }
+
+  // 一つの規則による reduce しか行わない状態を求める．
+  // 衝突で捨てた動作を持つ状態は除く．
+  vector<const Rule*> reduce_rule(mStateNum, NULL);
+  for (ymuint t = 0; t < mStateNum; ++ t) {
+    const Rule* rule = NULL;
+    bool ok = !keep_conflict || lalr1set.conflict_list(t).empty();
+    for (ymuint k = 0; k < nterm && ok; ++ k) {
+      ymuint32 code = full_action[t * nterm + k];
+      switch ( action_type(code) ) {
+      case kError:
+	break;
+
+      case kReduce:
+	{
+	  const Rule* rule1 = grammer.rule(action_arg(code));
+	  if ( rule == NULL ) {
+	    rule = rule1;
+	  }
+	  else if ( rule != rule1 ) {
+	    ok = false;
+	  }
+	}
+	break;
+
+      case kShift:
+      case kShiftReduce:
+      case kAccept:
+	ok = false;
+	break;
+      }
+    }
+    for (ymuint j = 0; j < mNontermNum && ok; ++ j) {
+      if ( full_goto[t * mNontermNum + j] != kNoState ) {
+	ok = false;
+      }
+    }
+    if ( ok ) {
+      reduce_rule[t] = rule;
+    }
+  }
+
+  // goto(s, B) が単位規則 A -> B の reduce しか行わない状態の時は，
+  // そこで reduce を行ってから goto(s, A) に遷移する代わりに直接
+  // goto(s, A) に遷移する．連鎖している場合はたどれるだけたどる．
+  ymuint bypass_num = 0;
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    for (ymuint j = 0; j < mNontermNum; ++ j) {
+      ymuint next = full_goto[s * mNontermNum + j];
+      ymuint n = 0;
+      while ( next != kNoState && n < mStateNum ) {
+	const Rule* rule = reduce_rule[next];
+	if ( rule == NULL || !rule->is_unit() || rule->has_action() ) {
+	  break;
+	}
+	next = full_goto[s * mNontermNum + mNontermIndex[rule->left()->id()]];
+	ASSERT_COND( next != kNoState );
+	++ n;
+      }
+      if ( n > 0 ) {
+	full_goto[s * mNontermNum + j] = next;
+	++ bypass_num;
+      }
+    }
+  }
+
+  // shift した先の状態が reduce しか行わない時は shift-reduce 動作にする．
+  ymuint shift_reduce_num = 0;
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    for (ymuint k = 0; k < nterm; ++ k) {
+      ymuint32& code = full_action[s * nterm + k];
+      if ( action_type(code) != kShift ) {
+	continue;
+      }
+      const Rule* rule = reduce_rule[action_arg(code)];
+      if ( rule != NULL ) {
+	code = make_action(kShiftReduce, rule->id());
+	++ shift_reduce_num;
+      }
+    }
+  }
+
+  // 以上の変換で到達できなくなった状態を取り除いて番号をつけ直す．
+  vector<ymuint> new_id(mStateNum, kNoState);
+  {
+    vector<ymuint> queue;
+    for (ymuint k = 0; k < ns; ++ k) {
+      ymuint s = mStartState[k];
+      if ( new_id[s] == kNoState ) {
+	new_id[s] = 0;
+	queue.push_back(s);
+      }
+    }
+    for (ymuint rpos = 0; rpos < queue.size(); ++ rpos) {
+      ymuint s = queue[rpos];
+      for (ymuint k = 0; k < nterm; ++ k) {
+	ymuint32 code = full_action[s * nterm + k];
+	if ( action_type(code) == kShift ) {
+	  ymuint next = action_arg(code);
+	  if ( new_id[next] == kNoState ) {
+	    new_id[next] = 0;
+	    queue.push_back(next);
+	  }
+	}
+      }
+      for (ymuint j = 0; j < mNontermNum; ++ j) {
+	ymuint next = full_goto[s * mNontermNum + j];
+	if ( next != kNoState && new_id[next] == kNoState ) {
+	  new_id[next] = 0;
+	  queue.push_back(next);
+	}
+      }
+    }
+  }
+  ymuint new_num = 0;
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    if ( new_id[s] != kNoState ) {
+      new_id[s] = new_num;
+      ++ new_num;
+    }
+  }
+  ymuint dropped_num = mStateNum - new_num;
+  if ( dropped_num > 0 ) {
+    vector<ymuint32> tmp_action(new_num * nterm);
+    vector<ymuint> tmp_goto(new_num * mNontermNum);
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      ymuint s1 = new_id[s];
+      if ( s1 == kNoState ) {
+	continue;
+      }
+      for (ymuint k = 0; k < nterm; ++ k) {
+	ymuint32 code = full_action[s * nterm + k];
+	if ( action_type(code) == kShift ) {
+	  code = make_action(kShift, new_id[action_arg(code)]);
+	}
+	tmp_action[s1 * nterm + k] = code;
+      }
+      for (ymuint j = 0; j < mNontermNum; ++ j) {
+	ymuint next = full_goto[s * mNontermNum + j];
+	if ( next != kNoState ) {
+	  next = new_id[next];
+	}
+	tmp_goto[s1 * mNontermNum + j] = next;
+      }
+    }
+    full_action.swap(tmp_action);
+    full_goto.swap(tmp_goto);
+    for (ymuint k = 0; k < ns; ++ k) {
+      mStartState[k] = new_id[mStartState[k]];
+    }
+    mStateNum = new_num;
+  }
+
+  // 衝突で捨てた動作を状態ごとにトークン番号の順に並べる．
+  mConflictTop.clear();
+  mConflictToken.clear();
+  mConflictAction.clear();
+  if ( keep_conflict ) {
+    vector<vector<pair<ymuint, ymuint32> > > conflict_list(mStateNum);
+    for (ymuint s = 0; s < new_id.size(); ++ s) {
+      ymuint s1 = new_id[s];
+      if ( s1 == kNoState ) {
+	continue;
+      }
+      const vector<pair<const Token*, const Rule*> >& src_list = lalr1set.conflict_list(s);
+      for (vector<pair<const Token*, const Rule*> >::const_iterator p = src_list.begin();
+	   p != src_list.end(); ++ p) {
+	conflict_list[s1].push_back(make_pair(p->first->id(),
+					      make_action(kReduce, p->second->id())));
+      }
+    }
+    mConflictTop.resize(mStateNum + 1);
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      mConflictTop[s] = mConflictToken.size();
+      vector<pair<ymuint, ymuint32> >& dst_list = conflict_list[s];
+      sort(dst_list.begin(), dst_list.end());
+      for (vector<pair<ymuint, ymuint32> >::iterator p = dst_list.begin();
+	   p != dst_list.end(); ++ p) {
+	mConflictToken.push_back(p->first);
+	mConflictAction.push_back(p->second);
+      }
+    }
+    mConflictTop[mStateNum] = mConflictToken.size();
+  }
+
+  // 全ての状態で同じ動作を持つ終端記号を同値類にまとめる．
+  HashMap<vector<ymuint32>, ymuint> column_map;
+  vector<ymuint> term_class(nterm);
+  vector<ymuint> class_rep;
+  for (ymuint k = 0; k < nterm; ++ k) {
+    vector<ymuint32> column(mStateNum);
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      column[s] = full_action[s * nterm + k];
+    }
+    ymuint cls;
+    if ( !column_map.find(column, cls) ) {
+      cls = class_rep.size();
+      column_map.add(column, cls);
+      class_rep.push_back(k);
+    }
+    term_class[k] = cls;
+  }
+  mClassNum = class_rep.size();
+
+  // 状態ごとに動作表の行の表し方を選ぶ．
+  // 各状態で最も多く現れる reduce を既定の動作とする．
+  // - 既定の動作以外にエラーしか持たない状態は既定の動作だけで表す．
+  // - エラー以外の要素が少なく，共有した行よりも小さくなる状態は
+  //   (同値類番号, 動作) の整列したリストで表す．リストの末尾には
+  //   kNoIndex を置く．
+  // - それ以外の状態は直接引ける行で表す．行の中の既定の動作の要素は
+  //   kDefaultAction に置き換えてから共有する．
+  // 行を共有する状態はエラー以外の要素数も等しいので，同じ表し方になる．
+  vector<vector<ymuint32> > row_list(mStateNum, vector<ymuint32>(mClassNum));
+  HashMap<vector<ymuint32>, ymuint> row_count;
+  mDefaultAction.resize(mStateNum);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    vector<ymuint32>& row = row_list[s];
+    for (ymuint c = 0; c < mClassNum; ++ c) {
+      row[c] = full_action[s * nterm + class_rep[c]];
+    }
+
+    ymuint32 def_code = make_action(kError);
+    ymuint def_num = 0;
+    for (ymuint c = 0; c < mClassNum; ++ c) {
+      ymuint32 code = row[c];
+      if ( action_type(code) != kReduce || code == def_code ) {
+	continue;
+      }
+      ymuint num = 0;
+      for (ymuint c1 = c; c1 < mClassNum; ++ c1) {
+	if ( row[c1] == code ) {
+	  ++ num;
+	}
+      }
+      if ( num > def_num ) {
+	def_code = code;
+	def_num = num;
+      }
+    }
+    mDefaultAction[s] = def_code;
+    if ( def_num > 0 ) {
+      for (ymuint c = 0; c < mClassNum; ++ c) {
+	if ( row[c] == def_code ) {
+	  row[c] = kDefaultAction;
+	}
+      }
+    }
+
+    ymuint n = 0;
+    row_count.find(row, n);
+    row_count.add(row, n + 1);
+  }
+
+  HashMap<vector<ymuint32>, ymuint> action_row_map;
+  mAction.clear();
+  mSparseClass.clear();
+  mSparseAction.clear();
+  mActionRow.resize(mStateNum);
+  ymuint dense_num = 0;
+  ymuint sparse_num = 0;
+  ymuint default_num = 0;
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    const vector<ymuint32>& row = row_list[s];
+    ymuint entry_num = 0;
+    ymuint def_num = 0;
+    for (ymuint c = 0; c < mClassNum; ++ c) {
+      if ( row[c] == kDefaultAction ) {
+	++ def_num;
+      }
+      if ( row[c] != make_action(kError) ) {
+	++ entry_num;
+      }
+    }
+    ymuint share_num = 0;
+    row_count.find(row, share_num);
+
+    if ( def_num > 0 && def_num == entry_num ) {
+      // 先読みによらずに reduce してもエラーの検出が遅れるだけで
+      // エラーになる記号を shift することはない．
+      mActionRow[s] = kDefaultRow;
+      ++ default_num;
+    }
+    else if ( entry_num <= kSparseLimit &&
+	      (entry_num + 1) * 2 * share_num < mClassNum ) {
+      // 一つの要素は同値類番号と動作の二語からなる．
+      mActionRow[s] = (mSparseClass.size() << 2) | kSparseRow;
+      for (ymuint c = 0; c < mClassNum; ++ c) {
+	ymuint32 code = row[c];
+	if ( code == kDefaultAction ) {
+	  code = mDefaultAction[s];
+	}
+	if ( code != make_action(kError) ) {
+	  mSparseClass.push_back(c);
+	  mSparseAction.push_back(code);
+	}
+      }
+      mSparseClass.push_back(kNoIndex);
+      mSparseAction.push_back(make_action(kError));
+      ++ sparse_num;
+    }
+    else {
+      mActionRow[s] = (share_row(row, action_row_map, mAction) << 2) | kDenseRow;
+      ++ dense_num;
+    }
+  }
+
+  // goto 表を非終端記号ごとの既定値と例外のリストにする．
+  mGotoDefault.resize(mNontermNum);
+  mGotoExcTop.resize(mNontermNum + 1);
+  mGotoExcState.clear();
+  mGotoExcNext.clear();
+  for (ymuint j = 0; j < mNontermNum; ++ j) {
+    // 最も多く現れる遷移先を求める．
+    HashMap<ymuint, ymuint> count_map;
+    ymuint def_next = kNoState;
+    ymuint def_num = 0;
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      ymuint next = full_goto[s * mNontermNum + j];
+      if ( next == kNoState ) {
+	continue;
+      }
+      ymuint num = 0;
+      count_map.find(next, num);
+      ++ num;
+      count_map.add(next, num);
+      if ( num > def_num || (num == def_num && next < def_next) ) {
+	def_next = next;
+	def_num = num;
+      }
+    }
+    mGotoDefault[j] = def_next;
+
+    mGotoExcTop[j] = mGotoExcState.size();
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      ymuint next = full_goto[s * mNontermNum + j];
+      if ( next != kNoState && next != def_next ) {
+	mGotoExcState.push_back(s);
+	mGotoExcNext.push_back(next);
+      }
+    }
+  }
+  mGotoExcTop[mNontermNum] = mGotoExcState.size();
+
+  // 非終端記号はエラーしか持たない同値類に写す．
+  // kEpsilon は入力に現れないので必ずそのような同値類に属する．
+  ymuint error_class = term_class[term_index[Grammer::kEpsilon]];
+  mTokenClass.resize(nt);
+  for (ymuint i = 0; i < nt; ++ i) {
+    if ( grammer.token(i)->is_terminal() ) {
+      mTokenClass[i] = term_class[term_index[i]];
+    }
+    else {
+      mTokenClass[i] = error_class;
+    }
+  }
+
+  // 動作表の行のエラー以外の要素から受け付ける終端記号の集合を作る．
+  // 行の既定の動作の印もエラー以外の要素である．
+  mTokenWordNum = (nt + 63) / 64;
+  mAcceptableBits.clear();
+  mAcceptableBits.resize(mStateNum * mTokenWordNum, 0ULL);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    const vector<ymuint32>& row = row_list[s];
+    ymuint64* bits = &mAcceptableBits[s * mTokenWordNum];
+    for (ymuint i = 0; i < nt; ++ i) {
+      if ( row[mTokenClass[i]] != make_action(kError) ) {
+	bits[i / 64] |= 1ULL << (i % 64);
+      }
+    }
+  }
+
+  ymuint nr = grammer.rule_num();
+  mRuleLeft.resize(nr);
+  mRuleSize.resize(nr);
+  for (ymuint r = 0; r < nr; ++ r) {
+    const Rule* rule = grammer.rule(r);
+    mRuleLeft[r] = rule->left()->id();
+    mRuleSize[r] = rule->right_size();
+  }
+
+  if ( stats != NULL ) {
+    stats->set_count(BuildStats::kUnitBypassNum, bypass_num);
+    stats->set_count(BuildStats::kShiftReduceNum, shift_reduce_num);
+    stats->set_count(BuildStats::kDroppedStateNum, dropped_num);
+    stats->set_count(BuildStats::kClassNum, mClassNum);
+    stats->set_count(BuildStats::kActionRowNum, action_row_num());
+    stats->set_count(BuildStats::kDenseRowNum, dense_num);
+    stats->set_count(BuildStats::kSparseRowNum, sparse_num);
+    stats->set_count(BuildStats::kDefaultRowNum, default_num);
+    stats->set_count(BuildStats::kGotoExcNum, goto_exception_num());
+    stats->update_peak(BuildStats::kMemParseTable, table_bytes());
+  }
+}
+
+// @brief デストラクタ
+ParseTable::~ParseTable()
+{
+}
+
+// @brief 使用回数に基づいて状態番号をつけ直す．
+// @param[in] profile この表で記録した使用回数
+void
+ParseTable::reorder(const ParseProfile& profile)
+{
+  ASSERT_COND( profile.state_num() == mStateNum );
+
+  // 使用回数の多い状態から，最も多く使われた未配置の遷移先を
+  // たどる鎖を作って順に番号を与える．
+  vector<ymuint> hot_list;
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    if ( profile.state_count(s) > 0 ) {
+      hot_list.push_back(s);
+    }
+  }
+  sort(hot_list.begin(), hot_list.end(), StateCountGt(profile));
+
+  vector<ymuint> new_id(mStateNum, kNoState);
+  ymuint last_id = 0;
+  for (vector<ymuint>::iterator p = hot_list.begin();
+       p != hot_list.end(); ++ p) {
+    ymuint s = *p;
+    while ( s != kNoState && new_id[s] == kNoState ) {
+      new_id[s] = last_id;
+      ++ last_id;
+
+      const vector<pair<ymuint, ymuint64> >& trans_list = profile.transition_list(s);
+      ymuint next = kNoState;
+      ymuint64 next_count = 0;
+      for (vector<pair<ymuint, ymuint64> >::const_iterator q = trans_list.begin();
+	   q != trans_list.end(); ++ q) {
+	if ( new_id[q->first] == kNoState && q->second > next_count ) {
+	  next = q->first;
+	  next_count = q->second;
+	}
+      }
+      s = next;
+    }
+  }
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    if ( new_id[s] == kNoState ) {
+      new_id[s] = last_id;
+      ++ last_id;
+    }
+  }
+  ASSERT_COND( last_id == mStateNum );
+
+  vector<ymuint> old_id(mStateNum);
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    old_id[new_id[s]] = s;
+  }
+
+  for (vector<ymuint>::iterator p = mStartState.begin();
+       p != mStartState.end(); ++ p) {
+    *p = new_id[*p];
+  }
+
+  // 動作表の行を新しい状態番号の順に作り直す．
+  // 密な行は最初に参照する状態の順に並べる．
+  // 番号のつけ直しは一対一なので行の共有関係は変わらない．
+  vector<ymuint32> action_row(mStateNum);
+  vector<ymuint32> default_action(mStateNum);
+  vector<ymuint32> action;
+  vector<ymuint> sparse_class;
+  vector<ymuint32> sparse_action;
+  vector<ymuint> dense_id(action_row_num(), kNoIndex);
+  action.reserve(mAction.size());
+  sparse_class.reserve(mSparseClass.size());
+  sparse_action.reserve(mSparseAction.size());
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    ymuint s0 = old_id[s];
+    default_action[s] = renumber_action(mDefaultAction[s0], new_id);
+    ymuint32 pos = mActionRow[s0];
+    ymuint idx = pos >> 2;
+    switch ( pos & 3U ) {
+    case kDenseRow:
+      if ( dense_id[idx] == kNoIndex ) {
+	dense_id[idx] = action.size() / mClassNum;
+	for (ymuint c = 0; c < mClassNum; ++ c) {
+	  action.push_back(renumber_action(mAction[idx * mClassNum + c], new_id));
+	}
+      }
+      action_row[s] = (dense_id[idx] << 2) | kDenseRow;
+      break;
+
+    case kSparseRow:
+      action_row[s] = (sparse_class.size() << 2) | kSparseRow;
+      for ( ; ; ++ idx) {
+	sparse_class.push_back(mSparseClass[idx]);
+	sparse_action.push_back(renumber_action(mSparseAction[idx], new_id));
+	if ( mSparseClass[idx] == kNoIndex ) {
+	  break;
+	}
+      }
+      break;
+
+    default:
+      action_row[s] = pos;
+      break;
+    }
+  }
+  mActionRow.swap(action_row);
+  mDefaultAction.swap(default_action);
+
+  vector<ymuint64> acceptable_bits(mAcceptableBits.size());
+  for (ymuint s = 0; s < mStateNum; ++ s) {
+    ymuint s0 = old_id[s];
+    for (ymuint w = 0; w < mTokenWordNum; ++ w) {
+      acceptable_bits[s * mTokenWordNum + w] = mAcceptableBits[s0 * mTokenWordNum + w];
+    }
+  }
+  mAcceptableBits.swap(acceptable_bits);
+  mAction.swap(action);
+  mSparseClass.swap(sparse_class);
+  mSparseAction.swap(sparse_action);
+
+  // 衝突で捨てた動作は reduce だけなので並べ直すだけでよい．
+  if ( !mConflictTop.empty() ) {
+    vector<ymuint> conflict_top(mStateNum + 1);
+    vector<ymuint> conflict_token;
+    vector<ymuint32> conflict_action;
+    conflict_token.reserve(mConflictToken.size());
+    conflict_action.reserve(mConflictAction.size());
+    for (ymuint s = 0; s < mStateNum; ++ s) {
+      ymuint s0 = old_id[s];
+      conflict_top[s] = conflict_token.size();
+      for (ymuint i = mConflictTop[s0]; i < mConflictTop[s0 + 1]; ++ i) {
+	conflict_token.push_back(mConflictToken[i]);
+	conflict_action.push_back(mConflictAction[i]);
+      }
+    }
+    conflict_top[mStateNum] = conflict_token.size();
+    mConflictTop.swap(conflict_top);
+    mConflictToken.swap(conflict_token);
+    mConflictAction.swap(conflict_action);
+  }
+
+  // goto 表の例外を新しい状態番号の順に並べ直す．
+  // 遷移先ごとの個数は変わらないので既定値も変わらない．
+  for (ymuint j = 0; j < mNontermNum; ++ j) {
+    if ( mGotoDefault[j] != kNoState ) {
+      mGotoDefault[j] = new_id[mGotoDefault[j]];
+    }
+    ymuint b = mGotoExcTop[j];
+    ymuint e = mGotoExcTop[j + 1];
+    vector<pair<ymuint, ymuint> > exc_list;
+    for (ymuint i = b; i < e; ++ i) {
+      exc_list.push_back(make_pair(new_id[mGotoExcState[i]],
+				   new_id[mGotoExcNext[i]]));
+    }
+    sort(exc_list.begin(), exc_list.end());
+    for (ymuint i = b; i < e; ++ i) {
+      mGotoExcState[i] = exc_list[i - b].first;
+      mGotoExcNext[i] = exc_list[i - b].second;
+    }
+  }
+}
+
+// @brief 表の使用量(バイト)を返す．
+ymuint64
+ParseTable::table_bytes() const
+{
+  return vector_bytes(mTokenClass)
+    + vector_bytes(mNontermIndex)
+    + vector_bytes(mStartState)
+    + vector_bytes(mActionRow)
+    + vector_bytes(mDefaultAction)
+    + vector_bytes(mAction)
+    + vector_bytes(mSparseClass)
+    + vector_bytes(mSparseAction)
+    + vector_bytes(mGotoDefault)
+    + vector_bytes(mGotoExcTop)
+    + vector_bytes(mGotoExcState)
+    + vector_bytes(mGotoExcNext)
+    + vector_bytes(mConflictTop)
+    + vector_bytes(mConflictToken)
+    + vector_bytes(mConflictAction)
+    + vector_bytes(mAcceptableBits)
+    + vector_bytes(mRuleLeft)
+    + vector_bytes(mRuleSize);
+}
+
+// @brief 内容を出力する．
+// @param[in] s 出力先のストリーム
+void
+ParseTable::print(ostream& s) const
+{
+  ymuint nt = token_num();
+  for (ymuint c = 0; c < mClassNum; ++ c) {
+    s << "Class#" << c << ":";
+    for (ymuint i = 0; i < nt; ++ i) {
+      if ( mNontermIndex[i] == kNoIndex && mTokenClass[i] == c ) {
+	s << " " << mTokenName[i];
+      }
+    }
+    s << endl;
+  }
+  s << endl;
+
+  for (ymuint k = 0; k < mStartState.size(); ++ k) {
+    s << "Entry#" << k << ": State#" << mStartState[k] << endl;
+  }
+  s << endl;
+
+  for (ymuint state = 0; state < mStateNum; ++ state) {
+    s << "State#" << state << ": ";
+    ymuint32 pos = mActionRow[state];
+    bool default_only = false;
+    switch ( pos & 3U ) {
+    case kDenseRow:
+      s << "(action row#" << (pos >> 2) << ")" << endl;
+      break;
+
+    case kSparseRow:
+      s << "(sparse)" << endl;
+      break;
+
+    case kDefaultRow:
+      s << "(default)" << endl
+	<< "  default: reduce Rule#" << action_arg(mDefaultAction[state]) << endl;
+      default_only = true;
+      break;
+    }
+    for (ymuint c = 0; c < mClassNum && !default_only; ++ c) {
+      ymuint32 code = class_action(state, c);
+      switch ( action_type(code) ) {
+      case kError:
+	break;
+
+      case kShift:
+	s << "  Class#" << c << ": shift State#" << action_arg(code) << endl;
+	break;
+
+      case kReduce:
+	s << "  Class#" << c << ": reduce Rule#" << action_arg(code) << endl;
+	break;
+
+      case kShiftReduce:
+	s << "  Class#" << c << ": shift-reduce Rule#" << action_arg(code) << endl;
+	break;
+
+      case kAccept:
+	s << "  Class#" << c << ": accept" << endl;
+	break;
+      }
+    }
+    for (ymuint i = 0; i < conflict_num(state); ++ i) {
+      s << "  " << mTokenName[conflict_token(state, i)]
+	<< ": conflict reduce Rule#" << action_arg(conflict_action(state, i)) << endl;
+    }
+    s << endl;
+  }
+
+  for (ymuint i = 0; i < nt; ++ i) {
+    ymuint j = mNontermIndex[i];
+    if ( j == kNoIndex ) {
+      continue;
+    }
+    s << "Goto " << mTokenName[i] << ":";
+    if ( mGotoDefault[j] != kNoState ) {
+      s << " default State#" << mGotoDefault[j];
+    }
+    for (ymuint k = mGotoExcTop[j]; k < mGotoExcTop[j + 1]; ++ k) {
+      s << ", State#" << mGotoExcState[k] << " -> State#" << mGotoExcNext[k];
+    }
+    s << endl;
+  }
+  s << endl;
+}
+
+END_NAMESPACE_YM
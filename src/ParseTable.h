@@ -0,0 +1,672 @@
+#ifndef PARSETABLE_H
+#define PARSETABLE_H
+
+/// @file ParseTable.h
+/// @brief ParseTable のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include <algorithm>
+
+
+BEGIN_NAMESPACE_YM
+
+class Grammer;
+class LALR1Set;
+class BuildStats;
+class ParseProfile;
+
+//////////////////////////////////////////////////////////////////////
+/// @class ParseTable ParseTable.h "ParseTable.h"
+/// @brief LALR1Set から作られる構文解析器用の表
+///
+/// 全ての状態で同じ動作を持つ終端記号を一つの同値類にまとめ，
+/// 動作表は (状態, 同値類) で引く．
+/// トークン番号から同値類番号への変換表を持つ．
+///
+/// 各状態の既定の動作(最も多く現れる reduce)を状態ごとに持ち，
+/// 動作表の行の表し方は状態ごとに次の三つから選ぶ．
+/// - 既定の動作: エラー以外の要素が既定の reduce だけの状態
+///   (bison の consistent state)．先読みを見ずに reduce する．
+///   エラーの検出は遅れるが，エラーになる記号を shift することはない．
+/// - 疎な行: エラー以外の要素が kSparseLimit 個以下の状態．
+///   (同値類番号, 動作) を同値類番号の順に並べたリストを先頭から探す．
+/// - 密な行: それ以外の状態．同値類番号で直接引く．
+///   同じ内容の行は一つだけ持ち，各状態は行番号で参照する．
+///   行の中の既定の動作の要素は「既定の動作」を表す印に置き換えてから
+///   共有するので，既定の reduce だけが異なる状態も同じ行を共有できる．
+///
+/// 単位規則 A -> B の reduce しか行わない状態への goto(s, B) は
+/// goto(s, A) に置き換える．これで reduce の連鎖が省略される．
+/// 意味動作を持つ規則(Rule::has_action())は除外する．
+/// 入力を受理するかどうかは変わらない．
+///
+/// shift した先の状態が一つの規則による reduce しか行わない(LR(0) の
+/// reduce 状態)時は，その shift を shift-reduce 動作に置き換える．
+/// これらの変換で到達できなくなった状態は取り除くので，状態番号は
+/// LALR1Set のものとは異なる．
+///
+/// 非終端記号に対する goto 表は別に持ち，非終端記号ごとの列で表す．
+/// 各列は最も多く現れる遷移先を既定値とし，それ以外の遷移先を
+/// 状態番号で整列した例外のリストとして持つ．
+/// reduce 後の goto は必ず存在する遷移しか引かないので，遷移の
+/// ない要素は既定値で埋めてよい．
+///
+/// reorder() で ParseProfile の使用回数に基づいて状態番号をつけ直す
+/// ことができる．構文解析の結果は変わらない．
+///
+/// keep_conflict を指定して作ると，LALR1Set が衝突で捨てた reduce を
+/// (状態, トークン) ごとの別の表に持つ．GLRParser はこれを用いて
+/// 衝突した要素で分岐する．LRParserT はこの表を参照しない．
+/// 衝突を持つ状態は reduce しか行わない状態として扱わないので，
+/// shift-reduce 動作と単位規則の除去の対象にはならない．
+///
+/// 状態ごとに受け付ける終端記号の集合をトークン番号のビットベクタで
+/// 持つ．動作表の行のエラー以外の要素から作るので，既定の動作だけで
+/// 表す状態でも先読みの集合が分かる．文脈に応じた字句解析に用いる．
+///
+/// 文法の入口ごとに初期状態を持つ．受理動作は入口ごとに別の状態に
+/// 置かれるので，どの入口から始めたかを区別する必要はない．
+///
+/// 動作は 32 ビットのコードで表す．
+/// 下位 3 ビットが ActionType，残りが引数(状態番号か規則番号)である．
+/// コード 0 はエラーを表す．
+//////////////////////////////////////////////////////////////////////
+class ParseTable
+{
+  template<typename SymbolType, typename StateType, typename CodeType>
+  friend class PackedTable;
+
+public:
+
+  /// @brief 動作の種類
+  enum ActionType {
+    /// @brief エラー
+    kError  = 0,
+    /// @brief shift (引数は次状態)
+    kShift  = 1,
+    /// @brief reduce (引数は規則番号)
+    kReduce = 2,
+    /// @brief 受理
+    kAccept = 3,
+    /// @brief shift してからすぐに reduce する (引数は規則番号)
+    ///
+    /// shift した状態はスタックに積まない．
+    kShiftReduce = 4
+  };
+
+  /// @brief 遷移先がないことを表す状態番号
+  static
+  const ymuint kNoState = 0xFFFFFFFFU;
+
+
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] grammer 元となる文法
+  /// @param[in] lalr1set 元となる LALR(1) 正準集
+  /// @param[in] stats 統計情報の記録先
+  /// @param[in] keep_conflict 衝突で捨てた動作も持つ時 true
+  ParseTable(const Grammer& grammer,
+	     const LALR1Set& lalr1set,
+	     BuildStats* stats = NULL,
+	     bool keep_conflict = false);
+
+  /// @brief デストラクタ
+  ~ParseTable();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 使用回数に基づいて状態番号をつけ直す．
+  /// @param[in] profile この表で記録した使用回数
+  ///
+  /// 使用回数の多い状態から順に，その状態から最も多く使われた
+  /// 遷移先をたどって連続した番号を与える．使われなかった状態は
+  /// 元の順番のまま後ろに置く．
+  /// 密な行と疎な行も新しい状態番号の順に並べ直す．
+  void
+  reorder(const ParseProfile& profile);
+
+  /// @brief 状態数を返す．
+  ymuint
+  state_num() const;
+
+  /// @brief 入口の数を返す．
+  ymuint
+  start_num() const;
+
+  /// @brief 初期状態の番号を返す．
+  /// @param[in] pos 入口番号 ( 0 <= pos < start_num() )
+  ymuint
+  start_state(ymuint pos = 0) const;
+
+  /// @brief トークン数を返す．
+  ymuint
+  token_num() const;
+
+  /// @brief 終端記号の同値類の数を返す．
+  ymuint
+  class_num() const;
+
+  /// @brief 動作表の異なる密な行の数を返す．
+  ymuint
+  action_row_num() const;
+
+  /// @brief goto 表の例外の数を返す．
+  ymuint
+  goto_exception_num() const;
+
+  /// @brief トークン番号から同値類番号を返す．
+  /// @param[in] token_id トークン番号
+  ///
+  /// 非終端記号はエラーの同値類に写される．
+  ymuint
+  token_class(ymuint token_id) const;
+
+  /// @brief 動作を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] token_id 先読みのトークン番号
+  ymuint32
+  action(ymuint state,
+	 ymuint token_id) const;
+
+  /// @brief 同値類番号で動作を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] cls 同値類番号
+  ymuint32
+  class_action(ymuint state,
+	       ymuint cls) const;
+
+  /// @brief 状態の既定の動作を返す．
+  /// @param[in] state 状態番号
+  ///
+  /// 既定の reduce を持たない状態ではエラーを返す．
+  ymuint32
+  default_action(ymuint state) const;
+
+  /// @brief 衝突で捨てた動作の数を返す．
+  /// @param[in] state 状態番号
+  ///
+  /// keep_conflict を指定せずに作った表では常に 0 を返す．
+  ymuint
+  conflict_num(ymuint state) const;
+
+  /// @brief 衝突で捨てた動作の先読みのトークン番号を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] pos 位置番号 ( 0 <= pos < conflict_num(state) )
+  ///
+  /// トークン番号の昇順に並んでいる．
+  ymuint
+  conflict_token(ymuint state,
+		 ymuint pos) const;
+
+  /// @brief 衝突で捨てた動作を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] pos 位置番号 ( 0 <= pos < conflict_num(state) )
+  ///
+  /// 動作は常に reduce である．
+  ymuint32
+  conflict_action(ymuint state,
+		  ymuint pos) const;
+
+  /// @brief 受け付ける終端記号の集合のビットベクタの語数を返す．
+  ymuint
+  token_word_num() const;
+
+  /// @brief 状態で受け付ける終端記号の集合を返す．
+  /// @param[in] state 状態番号
+  /// @return トークン番号のビットベクタ (token_word_num() 語) を返す．
+  ///
+  /// トークン番号 i は (i / 64) 語目の (i % 64) ビット目である．
+  /// 動作がエラーでない終端記号 (文末記号を含む) の集合である．
+  const ymuint64*
+  acceptable_tokens(ymuint state) const;
+
+  /// @brief 状態で終端記号を受け付ける時 true を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] token_id トークン番号
+  bool
+  is_acceptable(ymuint state,
+		ymuint token_id) const;
+
+  /// @brief 非終端記号による遷移先を返す．
+  /// @param[in] state 状態番号
+  /// @param[in] token_id 非終端記号のトークン番号
+  /// @return 遷移先の状態番号を返す．
+  ///
+  /// 遷移が存在しない組み合わせに対する値は既定値か kNoState になる．
+  ymuint
+  goto_state(ymuint state,
+	     ymuint token_id) const;
+
+  /// @brief 規則数を返す．
+  ymuint
+  rule_num() const;
+
+  /// @brief 規則の左辺のトークン番号を返す．
+  /// @param[in] rule_id 規則番号
+  ymuint
+  rule_left(ymuint rule_id) const;
+
+  /// @brief 規則の右辺の長さを返す．
+  /// @param[in] rule_id 規則番号
+  ymuint
+  rule_size(ymuint rule_id) const;
+
+  /// @brief 表の使用量(バイト)を返す．
+  ymuint64
+  table_bytes() const;
+
+  /// @brief 内容を出力する．
+  /// @param[in] s 出力先のストリーム
+  void
+  print(ostream& s) const;
+
+  /// @brief 動作のコードを作る．
+  /// @param[in] type 種類
+  /// @param[in] arg 引数
+  static
+  ymuint32
+  make_action(ActionType type,
+	      ymuint arg = 0);
+
+  /// @brief 動作の種類を取り出す．
+  /// @param[in] code 動作のコード
+  static
+  ActionType
+  action_type(ymuint32 code);
+
+  /// @brief 動作の引数を取り出す．
+  /// @param[in] code 動作のコード
+  static
+  ymuint
+  action_arg(ymuint32 code);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる定数
+  //////////////////////////////////////////////////////////////////////
+
+  // 非終端記号でないことを表す通し番号
+  static
+  const ymuint kNoIndex = 0xFFFFFFFFU;
+
+  // 状態ごとの既定の動作を表す印
+  // 種類は kError で引数が 1 のコード
+  static
+  const ymuint32 kDefaultAction = 8U;
+
+  // 疎な行で表す状態のエラー以外の要素数の上限
+  static
+  const ymuint kSparseLimit = 8;
+
+  // 動作表の行の表し方
+  // mActionRow の下位 2 ビットに入れる．
+  enum RowKind {
+    // 密な行 (残りのビットは行番号)
+    kDenseRow   = 0,
+    // 疎な行 (残りのビットは mSparseClass 中の先頭位置)
+    kSparseRow  = 1,
+    // 既定の動作のみ
+    kDefaultRow = 2
+  };
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 状態数
+  ymuint mStateNum;
+
+  // 入口番号をキーにした初期状態の配列
+  vector<ymuint> mStartState;
+
+  // 同値類の数
+  ymuint mClassNum;
+
+  // 非終端記号の数
+  ymuint mNontermNum;
+
+  // トークン番号をキーにした同値類番号の配列
+  vector<ymuint> mTokenClass;
+
+  // トークン番号をキーにした非終端記号の通し番号の配列
+  // 終端記号の場合は kNoIndex
+  vector<ymuint> mNontermIndex;
+
+  // 状態番号をキーにした動作表の行の位置の配列
+  // 下位 2 ビットが RowKind
+  vector<ymuint32> mActionRow;
+
+  // 状態番号をキーにした既定の動作の配列
+  vector<ymuint32> mDefaultAction;
+
+  // 動作表
+  // (行番号 * mClassNum + 同値類番号) をキーにした配列
+  vector<ymuint32> mAction;
+
+  // 疎な行の同値類番号の配列
+  // 状態ごとに昇順に並べ，末尾に kNoIndex を置く．
+  vector<ymuint> mSparseClass;
+
+  // 疎な行の動作の配列
+  // mSparseClass と同じ位置に対応する動作を置く．
+  vector<ymuint32> mSparseAction;
+
+  // 非終端記号の通し番号をキーにした goto の既定値の配列
+  vector<ymuint> mGotoDefault;
+
+  // 非終端記号の通し番号をキーにした例外の先頭位置の配列
+  // 大きさは mNontermNum + 1
+  vector<ymuint> mGotoExcTop;
+
+  // goto の例外の状態番号の配列
+  // 各非終端記号の範囲内では状態番号の昇順に並んでいる．
+  vector<ymuint> mGotoExcState;
+
+  // goto の例外の遷移先の配列
+  vector<ymuint> mGotoExcNext;
+
+  // 状態番号をキーにした衝突で捨てた動作の先頭位置の配列
+  // 大きさは mStateNum + 1 で，keep_conflict でなければ空
+  vector<ymuint> mConflictTop;
+
+  // 衝突で捨てた動作の先読みのトークン番号の配列
+  vector<ymuint> mConflictToken;
+
+  // 衝突で捨てた動作の配列
+  vector<ymuint32> mConflictAction;
+
+  // 受け付ける終端記号の集合のビットベクタの語数
+  ymuint mTokenWordNum;
+
+  // 受け付ける終端記号の集合のビットベクタの配列
+  // (状態番号 * mTokenWordNum + 語の位置) をキーにする．
+  vector<ymuint64> mAcceptableBits;
+
+  // 規則番号をキーにした左辺のトークン番号の配列
+  vector<ymuint> mRuleLeft;
+
+  // 規則番号をキーにした右辺の長さの配列
+  vector<ymuint> mRuleSize;
+
+  // トークン番号をキーにしたトークン名の配列 (print() 用)
+  vector<string> mTokenName;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 状態数を返す．
+inline
+ymuint
+ParseTable::state_num() const
+{
+  return mStateNum;
+}
+
+// @brief 入口の数を返す．
+inline
+ymuint
+ParseTable::start_num() const
+{
+  return mStartState.size();
+}
+
+// @brief 初期状態の番号を返す．
+// @param[in] pos 入口番号
+inline
+ymuint
+ParseTable::start_state(ymuint pos) const
+{
+  return mStartState[pos];
+}
+
+// @brief トークン数を返す．
+inline
+ymuint
+ParseTable::token_num() const
+{
+  return mTokenClass.size();
+}
+
+// @brief 終端記号の同値類の数を返す．
+inline
+ymuint
+ParseTable::class_num() const
+{
+  return mClassNum;
+}
+
+// @brief 動作表の異なる行の数を返す．
+inline
+ymuint
+ParseTable::action_row_num() const
+{
+  return mClassNum > 0 ? mAction.size() / mClassNum : 0;
+}
+
+// @brief goto 表の例外の数を返す．
+inline
+ymuint
+ParseTable::goto_exception_num() const
+{
+  return mGotoExcState.size();
+}
+
+// @brief トークン番号から同値類番号を返す．
+// @param[in] token_id トークン番号
+inline
+ymuint
+ParseTable::token_class(ymuint token_id) const
+{
+  return mTokenClass[token_id];
+}
+
+// @brief 動作を返す．
+// @param[in] state 状態番号
+// @param[in] token_id 先読みのトークン番号
+inline
+ymuint32
+ParseTable::action(ymuint state,
+		   ymuint token_id) const
+{
+  return class_action(state, token_class(token_id));
+}
+
+// @brief 同値類番号で動作を返す．
+// @param[in] state 状態番号
+// @param[in] cls 同値類番号
+inline
+ymuint32
+ParseTable::class_action(ymuint state,
+			 ymuint cls) const
+{
+  ymuint32 pos = mActionRow[state];
+  ymuint idx = pos >> 2;
+  switch ( pos & 3U ) {
+  case kDenseRow:
+    {
+      ymuint32 code = mAction[idx * mClassNum + cls];
+      if ( code == kDefaultAction ) {
+	code = mDefaultAction[state];
+      }
+      return code;
+    }
+
+  case kSparseRow:
+    // 末尾の kNoIndex で必ず止まる．
+    while ( mSparseClass[idx] < cls ) {
+      ++ idx;
+    }
+    if ( mSparseClass[idx] == cls ) {
+      return mSparseAction[idx];
+    }
+    return make_action(kError);
+
+  default:
+    return mDefaultAction[state];
+  }
+}
+
+// @brief 状態の既定の動作を返す．
+// @param[in] state 状態番号
+inline
+ymuint32
+ParseTable::default_action(ymuint state) const
+{
+  return mDefaultAction[state];
+}
+
+// @brief 衝突で捨てた動作の数を返す．
+// @param[in] state 状態番号
+inline
+ymuint
+ParseTable::conflict_num(ymuint state) const
+{
+  if ( mConflictTop.empty() ) {
+    return 0;
+  }
+  return mConflictTop[state + 1] - mConflictTop[state];
+}
+
+// @brief 衝突で捨てた動作の先読みのトークン番号を返す．
+// @param[in] state 状態番号
+// @param[in] pos 位置番号
+inline
+ymuint
+ParseTable::conflict_token(ymuint state,
+			   ymuint pos) const
+{
+  return mConflictToken[mConflictTop[state] + pos];
+}
+
+// @brief 衝突で捨てた動作を返す．
+// @param[in] state 状態番号
+// @param[in] pos 位置番号
+inline
+ymuint32
+ParseTable::conflict_action(ymuint state,
+			    ymuint pos) const
+{
+  return mConflictAction[mConflictTop[state] + pos];
+}
+
+// @brief 受け付ける終端記号の集合のビットベクタの語数を返す．
+inline
+ymuint
+ParseTable::token_word_num() const
+{
+  return mTokenWordNum;
+}
+
+// @brief 状態で受け付ける終端記号の集合を返す．
+// @param[in] state 状態番号
+inline
+const ymuint64*
+ParseTable::acceptable_tokens(ymuint state) const
+{
+  return &mAcceptableBits[state * mTokenWordNum];
+}
+
+// @brief 状態で終端記号を受け付ける時 true を返す．
+// @param[in] state 状態番号
+// @param[in] token_id トークン番号
+inline
+bool
+ParseTable::is_acceptable(ymuint state,
+			  ymuint token_id) const
+{
+  return (mAcceptableBits[state * mTokenWordNum + token_id / 64] >> (token_id % 64)) & 1ULL;
+}
+
+// @brief 非終端記号による遷移先を返す．
+// @param[in] state 状態番号
+// @param[in] token_id 非終端記号のトークン番号
+inline
+ymuint
+ParseTable::goto_state(ymuint state,
+		       ymuint token_id) const
+{
+  ymuint idx = mNontermIndex[token_id];
+  vector<ymuint>::const_iterator b = mGotoExcState.begin() + mGotoExcTop[idx];
+  vector<ymuint>::const_iterator e = mGotoExcState.begin() + mGotoExcTop[idx + 1];
+  vector<ymuint>::const_iterator p = lower_bound(b, e, state);
+  if ( p != e && *p == state ) {
+    return mGotoExcNext[p - mGotoExcState.begin()];
+  }
+  return mGotoDefault[idx];
+}
+
+// @brief 規則数を返す．
+inline
+ymuint
+ParseTable::rule_num() const
+{
+  return mRuleLeft.size();
+}
+
+// @brief 規則の左辺のトークン番号を返す．
+// @param[in] rule_id 規則番号
+inline
+ymuint
+ParseTable::rule_left(ymuint rule_id) const
+{
+  return mRuleLeft[rule_id];
+}
+
+// @brief 規則の右辺の長さを返す．
+// @param[in] rule_id 規則番号
+inline
+ymuint
+ParseTable::rule_size(ymuint rule_id) const
+{
+  return mRuleSize[rule_id];
+}
+
+// @brief 動作のコードを作る．
+// @param[in] type 種類
+// @param[in] arg 引数
+inline
+ymuint32
+ParseTable::make_action(ActionType type,
+			ymuint arg)
+{
+  return (static_cast<ymuint32>(arg) << 3) | static_cast<ymuint32>(type);
+}
+
+// @brief 動作の種類を取り出す．
+// @param[in] code 動作のコード
+inline
+ParseTable::ActionType
+ParseTable::action_type(ymuint32 code)
+{
+  return static_cast<ActionType>(code & 7U);
+}
+
+// @brief 動作の引数を取り出す．
+// @param[in] code 動作のコード
+inline
+ymuint
+ParseTable::action_arg(ymuint32 code)
+{
+  return code >> 3;
+}
+
+END_NAMESPACE_YM
+
+#endif // PARSETABLE_H
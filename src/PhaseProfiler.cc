@@ -0,0 +1,148 @@
+
+/// @file PhaseProfiler.cc
+/// @brief PhaseProfiler の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "PhaseProfiler.h"
+#include <cstdlib>
+
+#if PARSER_HAVE_GPERFTOOLS
+#include <gperftools/profiler.h>
+#include <gperftools/heap-profiler.h>
+#endif
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// set_default_prefix() で設定された接頭辞
+string sDefaultPrefix;
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス PhaseProfiler
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] stats 統計情報の記録先 (NULL でもよい)
+// @param[in] prefix 出力ファイル名の接頭辞
+PhaseProfiler::PhaseProfiler(BuildStats* stats,
+			     const string& prefix) :
+  mPrefix(prefix),
+  mStats(stats),
+  mOrigListener(NULL),
+  mActive(BuildStats::kPhaseNum)
+{
+  if ( !is_enabled() ) {
+    return;
+  }
+
+#if !PARSER_HAVE_GPERFTOOLS
+  static bool warned = false;
+  if ( !warned ) {
+    cerr << "Warning: profiling was requested, but gperftools is not linked."
+	 << endl;
+    warned = true;
+  }
+#endif
+
+  if ( mStats == NULL ) {
+    mStats = &mLocalStats;
+  }
+  mOrigListener = mStats->listener();
+  mStats->set_listener(this);
+}
+
+// @brief デストラクタ
+PhaseProfiler::~PhaseProfiler()
+{
+  if ( is_enabled() ) {
+    mStats->set_listener(mOrigListener);
+  }
+}
+
+// @brief プロファイルを行う時 true を返す．
+bool
+PhaseProfiler::is_enabled() const
+{
+  return !mPrefix.empty();
+}
+
+// @brief フェーズを記録すべき BuildStats を返す．
+BuildStats*
+PhaseProfiler::stats() const
+{
+  return mStats;
+}
+
+// @brief フェーズの開始
+// @param[in] phase フェーズ
+void
+PhaseProfiler::phase_begin(BuildStats::Phase phase)
+{
+  if ( mOrigListener != NULL ) {
+    mOrigListener->phase_begin(phase);
+  }
+
+  if ( mActive != BuildStats::kPhaseNum ) {
+    // 入れ子になったフェーズは外側に含める．
+    return;
+  }
+  mActive = phase;
+
+#if PARSER_HAVE_GPERFTOOLS
+  string base = mPrefix + "." + BuildStats::phase_name(phase);
+  ProfilerStart((base + ".prof").c_str());
+  HeapProfilerStart(base.c_str());
+#endif
+}
+
+// @brief フェーズの終了
+// @param[in] phase フェーズ
+void
+PhaseProfiler::phase_end(BuildStats::Phase phase)
+{
+  if ( phase == mActive ) {
+#if PARSER_HAVE_GPERFTOOLS
+    ProfilerStop();
+    HeapProfilerDump(BuildStats::phase_name(phase));
+    HeapProfilerStop();
+#endif
+    mActive = BuildStats::kPhaseNum;
+  }
+
+  if ( mOrigListener != NULL ) {
+    mOrigListener->phase_end(phase);
+  }
+}
+
+// @brief 出力ファイル名の接頭辞のデフォルト値を設定する．
+// @param[in] prefix 接頭辞 (空文字列で環境変数の値に戻す)
+void
+PhaseProfiler::set_default_prefix(const string& prefix)
+{
+  sDefaultPrefix = prefix;
+}
+
+// @brief 出力ファイル名の接頭辞のデフォルト値を返す．
+string
+PhaseProfiler::default_prefix()
+{
+  if ( !sDefaultPrefix.empty() ) {
+    return sDefaultPrefix;
+  }
+  const char* env = getenv("PARSER_PROFILE");
+  if ( env != NULL ) {
+    return string(env);
+  }
+  return string();
+}
+
+END_NAMESPACE_YM
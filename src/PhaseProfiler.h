@@ -0,0 +1,134 @@
+#ifndef PHASEPROFILER_H
+#define PHASEPROFILER_H
+
+/// @file PhaseProfiler.h
+/// @brief PhaseProfiler のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include "BuildStats.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class PhaseProfiler PhaseProfiler.h "PhaseProfiler.h"
+/// @brief 構文解析表生成の各フェーズを gperftools でプロファイルするクラス
+///
+/// 出力先の接頭辞が空でなければ，BuildStats のリスナとして登録して
+/// フェーズごとに CPU プロファイラとヒーププロファイラを起動する．
+/// 出力ファイルは以下の通り．
+/// - <prefix>.<phase>.prof         CPU プロファイル
+/// - <prefix>.<phase>.NNNN.heap    ヒーププロファイル
+/// いずれも pprof で読み込める．
+///
+/// gperftools のプロファイラは入れ子にできないので，他のフェーズの
+/// 内側で呼ばれるフェーズ(kClosure)は外側のフェーズに含まれる．
+/// 同じフェーズが再び呼ばれた場合にはファイルは上書きされる．
+///
+/// 接頭辞は set_default_prefix() で設定する．設定されていない時は
+/// 環境変数 PARSER_PROFILE の値を用いる．
+/// gperftools なしでビルドされた場合は何もしない．
+//////////////////////////////////////////////////////////////////////
+class PhaseProfiler :
+  public PhaseListener
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] stats 統計情報の記録先 (NULL でもよい)
+  /// @param[in] prefix 出力ファイル名の接頭辞
+  ///
+  /// prefix が空の時は何もしない．
+  /// stats が NULL でプロファイルを行う時は内部の BuildStats を用いる．
+  /// 元のリスナには引き続き通知が送られる．
+  explicit
+  PhaseProfiler(BuildStats* stats,
+		const string& prefix = default_prefix());
+
+  /// @brief デストラクタ
+  ///
+  /// 元のリスナを戻す．
+  virtual
+  ~PhaseProfiler();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief プロファイルを行う時 true を返す．
+  bool
+  is_enabled() const;
+
+  /// @brief フェーズを記録すべき BuildStats を返す．
+  ///
+  /// プロファイルを行わない時はコンストラクタに与えた stats をそのまま返す．
+  BuildStats*
+  stats() const;
+
+  /// @brief フェーズの開始
+  /// @param[in] phase フェーズ
+  virtual
+  void
+  phase_begin(BuildStats::Phase phase);
+
+  /// @brief フェーズの終了
+  /// @param[in] phase フェーズ
+  virtual
+  void
+  phase_end(BuildStats::Phase phase);
+
+  /// @brief 出力ファイル名の接頭辞のデフォルト値を設定する．
+  /// @param[in] prefix 接頭辞 (空文字列で環境変数の値に戻す)
+  static
+  void
+  set_default_prefix(const string& prefix);
+
+  /// @brief 出力ファイル名の接頭辞のデフォルト値を返す．
+  static
+  string
+  default_prefix();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // コピーは禁止
+  //////////////////////////////////////////////////////////////////////
+
+  PhaseProfiler(const PhaseProfiler& src);
+
+  const PhaseProfiler&
+  operator=(const PhaseProfiler& src);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 出力ファイル名の接頭辞
+  string mPrefix;
+
+  // 記録先
+  BuildStats* mStats;
+
+  // stats が NULL の時に用いる記録先
+  BuildStats mLocalStats;
+
+  // 元のリスナ
+  PhaseListener* mOrigListener;
+
+  // プロファイル中のフェーズ (プロファイル中でなければ kPhaseNum)
+  BuildStats::Phase mActive;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // PHASEPROFILER_H
@@ -23,7 +23,8 @@ Rule::Rule(ymuint id,
 	   const vector<Token*>& right) :
   mId(id),
   mLeft(left),
-  mRight(right)
+  mRight(right),
+  mHasAction(false)
 {
 }
 
@@ -70,11 +71,45 @@ Rule::last_terminal() const
 {
   for (int i = right_size(); -- i >= 0; ) {
     const Token* token = mRight[i];
-    if ( token->rule_list().empty() ) {
+    if ( token->is_terminal() ) {
       return token;
     }
   }
   return NULL;
 }
 
+// @brief 単位規則(右辺が非終端記号一つの規則)の時 true を返す．
+bool
+Rule::is_unit() const
+{
+  return right_size() == 1 && !mRight[0]->is_terminal();
+}
+
+// @brief 意味動作を持つ時 true を返す．
+bool
+Rule::has_action() const
+{
+  return mHasAction;
+}
+
+// @brief 意味動作を持つかどうかを設定する．
+// @param[in] flag 意味動作を持つ時 true
+void
+Rule::set_has_action(bool flag)
+{
+  mHasAction = flag;
+}
+
+// @brief 内容を "左辺 ::= 右辺" の形式で出力する．
+// @param[in] s 出力先のストリーム
+void
+Rule::print(ostream& s) const
+{
+  s << mLeft->str() << " ::=";
+  for (vector<Token*>::const_iterator p = mRight.begin();
+       p != mRight.end(); ++ p) {
+    s << " " << (*p)->str();
+  }
+}
+
 END_NAMESPACE_YM
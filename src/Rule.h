@@ -59,6 +59,28 @@ public:
   const Token*
   last_terminal() const;
 
+  /// @brief 単位規則(右辺が非終端記号一つの規則)の時 true を返す．
+  bool
+  is_unit() const;
+
+  /// @brief 意味動作を持つ時 true を返す．
+  ///
+  /// 意味動作を持つ単位規則は構文解析表の単位規則の除去の対象とならない．
+  bool
+  has_action() const;
+
+  /// @brief 意味動作を持つかどうかを設定する．
+  /// @param[in] flag 意味動作を持つ時 true
+  void
+  set_has_action(bool flag = true);
+
+  /// @brief 内容を "左辺 ::= 右辺" の形式で出力する．
+  /// @param[in] s 出力先のストリーム
+  ///
+  /// 末尾に改行は出力しない．
+  void
+  print(ostream& s) const;
+
 
 private:
   //////////////////////////////////////////////////////////////////////
@@ -74,6 +96,9 @@ private:
   // 右辺のトークンリスト
   vector<Token*> mRight;
 
+  // 意味動作を持つ時 true
+  bool mHasAction;
+
 };
 
 END_NAMESPACE_YM
@@ -0,0 +1,358 @@
+
+/// @file SentenceGen.cc
+/// @brief SentenceGen, SentenceSink の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "SentenceGen.h"
+#include "Grammer.h"
+#include "Token.h"
+#include "Rule.h"
+
+
+BEGIN_NAMESPACE_YM
+
+BEGIN_NONAMESPACE
+
+// 飽和加算を行う．
+inline
+ymuint
+sat_add(ymuint a,
+	ymuint b)
+{
+  ymuint64 c = static_cast<ymuint64>(a) + b;
+  if ( c >= SentenceGen::kInfLength ) {
+    return SentenceGen::kInfLength - 1;
+  }
+  return static_cast<ymuint>(c);
+}
+
+END_NONAMESPACE
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス SentenceSink
+//////////////////////////////////////////////////////////////////////
+
+// @brief デストラクタ
+SentenceSink::~SentenceSink()
+{
+}
+
+// @brief 文の終わり
+void
+SentenceSink::end_sentence()
+{
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス StreamSentenceSink
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] s 出力先のストリーム
+StreamSentenceSink::StreamSentenceSink(ostream& s) :
+  mS(s),
+  mFirst(true)
+{
+}
+
+// @brief デストラクタ
+StreamSentenceSink::~StreamSentenceSink()
+{
+}
+
+// @brief 終端記号を受け取る．
+void
+StreamSentenceSink::put_token(const Token* token)
+{
+  if ( !mFirst ) {
+    mS << " ";
+  }
+  mS << token->str();
+  mFirst = false;
+}
+
+// @brief 文の終わり
+void
+StreamSentenceSink::end_sentence()
+{
+  mS << endl;
+  mFirst = true;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス SentenceGen
+//////////////////////////////////////////////////////////////////////
+
+// 定数の定義
+const ymuint SentenceGen::kInfLength;
+
+// @brief コンストラクタ
+// @param[in] grammer 対象の文法
+// @param[in] seed 乱数の種
+SentenceGen::SentenceGen(const Grammer& grammer,
+			 ymuint32 seed) :
+  mGrammer(grammer),
+  mWeight(grammer.rule_num(), 1.0),
+  mGrowth(1.0)
+{
+  ASSERT_COND( grammer.start_num() > 0 );
+
+  set_seed(seed);
+  calc_min_cost();
+}
+
+// @brief デストラクタ
+SentenceGen::~SentenceGen()
+{
+}
+
+// @brief 規則の重みを設定する．
+// @param[in] rule 対象の規則
+// @param[in] weight 重み (0 以上，デフォルトは 1)
+void
+SentenceGen::set_weight(const Rule* rule,
+			double weight)
+{
+  ASSERT_COND( rule->id() < mWeight.size() );
+  ASSERT_COND( weight >= 0.0 );
+  mWeight[rule->id()] = weight;
+}
+
+// @brief 最短でない規則の重みに掛ける係数を設定する．
+// @param[in] growth 係数 (デフォルトは 1)
+void
+SentenceGen::set_growth(double growth)
+{
+  ASSERT_COND( growth >= 0.0 );
+  mGrowth = growth;
+}
+
+// @brief 乱数の種を設定し直す．
+void
+SentenceGen::set_seed(ymuint32 seed)
+{
+  // 0 にならないように適当な定数を混ぜる．
+  mRandState = (static_cast<ymuint64>(seed) << 32) ^ 0x9E3779B97F4A7C15ULL;
+}
+
+// @brief 記号から導出される最短の終端記号列の長さを返す．
+// @param[in] token 記号
+ymuint
+SentenceGen::min_length(const Token* token) const
+{
+  ASSERT_COND( token->id() < mTokenLen.size() );
+  return mTokenLen[token->id()];
+}
+
+// @brief 開始記号から文を一つ生成する．
+// @param[in] target 目標の長さ
+// @param[in] sink 出力先
+// @return 生成した終端記号数を返す．
+ymuint64
+SentenceGen::generate(ymuint64 target,
+		      SentenceSink& sink)
+{
+  return generate(mGrammer.token(Grammer::kStart), target, sink);
+}
+
+// @brief 指定した記号から記号列を一つ生成する．
+// @param[in] start 開始記号
+// @param[in] target 目標の長さ
+// @param[in] sink 出力先
+// @return 生成した終端記号数を返す．
+ymuint64
+SentenceGen::generate(const Token* start,
+		      ymuint64 target,
+		      SentenceSink& sink)
+{
+  ymuint start_len = min_length(start);
+  ASSERT_COND( start_len != kInfLength );
+
+  ymuint64 budget = 0;
+  if ( target > start_len ) {
+    budget = target - start_len;
+  }
+
+  ymuint64 n = 0;
+  mStack.clear();
+  mStack.push_back(start);
+  while ( !mStack.empty() ) {
+    const Token* token = mStack.back();
+    mStack.pop_back();
+    if ( token->is_terminal() ) {
+      // 終端記号
+      sink.put_token(token);
+      ++ n;
+      continue;
+    }
+    const Rule* rule = choose_rule(token, budget);
+    // 最左導出なので右辺を逆順に積む．
+    for (ymuint i = rule->right_size(); i > 0; -- i) {
+      mStack.push_back(rule->right(i - 1));
+    }
+  }
+  sink.end_sentence();
+
+  return n;
+}
+
+// @brief 記号と規則の最短の導出を求める．
+void
+SentenceGen::calc_min_cost()
+{
+  ymuint nt = mGrammer.token_num();
+  ymuint nr = mGrammer.rule_num();
+
+  mTokenLen.clear();
+  mTokenLen.resize(nt, kInfLength);
+  mTokenStep.clear();
+  mTokenStep.resize(nt, kInfLength);
+  for (ymuint i = 0; i < nt; ++ i) {
+    const Token* token = mGrammer.token(i);
+    if ( token->is_terminal() ) {
+      mTokenLen[i] = 1;
+      mTokenStep[i] = 0;
+    }
+  }
+
+  // (長さ, 段数) の辞書式順序で最小のものを不動点計算で求める．
+  vector<ymuint> rule_step(nr, kInfLength);
+  mRuleLen.clear();
+  mRuleLen.resize(nr, kInfLength);
+  for (bool changed = true; changed; ) {
+    changed = false;
+    for (ymuint r = 0; r < nr; ++ r) {
+      const Rule* rule = mGrammer.rule(r);
+      ymuint len = 0;
+      ymuint step = 1;
+      bool ok = true;
+      ymuint n = rule->right_size();
+      for (ymuint i = 0; i < n; ++ i) {
+	ymuint id = rule->right(i)->id();
+	if ( mTokenLen[id] == kInfLength ) {
+	  ok = false;
+	  break;
+	}
+	len = sat_add(len, mTokenLen[id]);
+	step = sat_add(step, mTokenStep[id]);
+      }
+      if ( !ok ) {
+	continue;
+      }
+      mRuleLen[r] = len;
+      rule_step[r] = step;
+      ymuint lid = rule->left()->id();
+      if ( len < mTokenLen[lid] ||
+	   (len == mTokenLen[lid] && step < mTokenStep[lid]) ) {
+	mTokenLen[lid] = len;
+	mTokenStep[lid] = step;
+	changed = true;
+      }
+    }
+  }
+
+  mRuleMinimal.clear();
+  mRuleMinimal.resize(nr, false);
+  for (ymuint r = 0; r < nr; ++ r) {
+    if ( mRuleLen[r] == kInfLength ) {
+      continue;
+    }
+    ymuint lid = mGrammer.rule(r)->left()->id();
+    if ( mRuleLen[r] == mTokenLen[lid] && rule_step[r] == mTokenStep[lid] ) {
+      mRuleMinimal[r] = true;
+    }
+  }
+}
+
+// @brief 規則を選ぶ．
+// @param[in] token 展開する記号
+// @param[inout] budget 残りの予算
+const Rule*
+SentenceGen::choose_rule(const Token* token,
+			 ymuint64& budget)
+{
+  ymuint tlen = mTokenLen[token->id()];
+  ASSERT_COND( tlen != kInfLength );
+
+  const vector<const Rule*>& rule_list = token->rule_list();
+  mCandList.clear();
+  mCandWeight.clear();
+  double total = 0.0;
+  const Rule* fallback = NULL;
+  for (vector<const Rule*>::const_iterator p = rule_list.begin();
+       p != rule_list.end(); ++ p) {
+    const Rule* rule = *p;
+    ymuint id = rule->id();
+    double w;
+    if ( mRuleMinimal[id] ) {
+      if ( fallback == NULL ) {
+	fallback = rule;
+      }
+      w = mWeight[id];
+    }
+    else {
+      if ( mRuleLen[id] == kInfLength ) {
+	continue;
+      }
+      ymuint64 extra = mRuleLen[id] - tlen;
+      if ( extra == 0 ) {
+	extra = 1;
+      }
+      if ( extra > budget ) {
+	continue;
+      }
+      w = mWeight[id] * mGrowth;
+    }
+    mCandList.push_back(rule);
+    mCandWeight.push_back(w);
+    total += w;
+  }
+  ASSERT_COND( fallback != NULL );
+
+  const Rule* rule = fallback;
+  if ( total > 0.0 ) {
+    double x = rand_double() * total;
+    ymuint n = mCandList.size();
+    for (ymuint i = 0; i < n; ++ i) {
+      if ( mCandWeight[i] == 0.0 ) {
+	continue;
+      }
+      rule = mCandList[i];
+      if ( x < mCandWeight[i] ) {
+	break;
+      }
+      x -= mCandWeight[i];
+    }
+  }
+
+  if ( !mRuleMinimal[rule->id()] ) {
+    ymuint64 extra = mRuleLen[rule->id()] - tlen;
+    if ( extra == 0 ) {
+      extra = 1;
+    }
+    budget -= extra;
+  }
+
+  return rule;
+}
+
+// @brief [0, 1) の乱数を返す．
+double
+SentenceGen::rand_double()
+{
+  // xorshift64*
+  mRandState ^= mRandState >> 12;
+  mRandState ^= mRandState << 25;
+  mRandState ^= mRandState >> 27;
+  ymuint64 x = mRandState * 0x2545F4914F6CDD1DULL;
+  return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+END_NAMESPACE_YM
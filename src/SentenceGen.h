@@ -0,0 +1,261 @@
+#ifndef SENTENCEGEN_H
+#define SENTENCEGEN_H
+
+/// @file SentenceGen.h
+/// @brief SentenceGen, SentenceSink のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+BEGIN_NAMESPACE_YM
+
+class Grammer;
+class Rule;
+class Token;
+
+//////////////////////////////////////////////////////////////////////
+/// @class SentenceSink SentenceGen.h "SentenceGen.h"
+/// @brief SentenceGen が生成した終端記号を受け取るクラス
+//////////////////////////////////////////////////////////////////////
+class SentenceSink
+{
+public:
+
+  /// @brief デストラクタ
+  virtual
+  ~SentenceSink();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 終端記号を受け取る．
+  /// @param[in] token 終端記号
+  virtual
+  void
+  put_token(const Token* token) = 0;
+
+  /// @brief 文の終わり
+  ///
+  /// デフォルトの実装はなにもしない．
+  virtual
+  void
+  end_sentence();
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class StreamSentenceSink SentenceGen.h "SentenceGen.h"
+/// @brief 終端記号の文字列を空白で区切ってストリームに書き出す SentenceSink
+///
+/// 文の終わりで改行する．
+//////////////////////////////////////////////////////////////////////
+class StreamSentenceSink :
+  public SentenceSink
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] s 出力先のストリーム
+  StreamSentenceSink(ostream& s);
+
+  /// @brief デストラクタ
+  virtual
+  ~StreamSentenceSink();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // SentenceSink の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 終端記号を受け取る．
+  virtual
+  void
+  put_token(const Token* token);
+
+  /// @brief 文の終わり
+  virtual
+  void
+  end_sentence();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 出力先のストリーム
+  ostream& mS;
+
+  // 文の先頭の時 true
+  bool mFirst;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class SentenceGen SentenceGen.h "SentenceGen.h"
+/// @brief 文法から無作為に文を生成するクラス
+///
+/// 各記号について最短の導出(終端記号数が最小，同じなら導出の段数が最小)
+/// を前もって求めておき，それを上限の見積もりに用いて目標の長さを
+/// 越えないように規則を選ぶ．
+/// - 残りの予算があるうちは，予算に収まる規則の中から重みに比例した
+///   確率で選ぶ．最短でない規則の重みには growth を掛ける．
+/// - 予算を使い切ったら最短の規則のみを選ぶ．
+/// 最短でない規則は必ず 1 以上の予算を消費するので生成は必ず停止する．
+///
+/// 最左導出を未展開の記号のスタックで行うので，使用メモリは
+/// 生成する文の長さに比例し，生成した記号列は保持しない．
+/// 結果は SentenceSink に逐次渡される．
+//////////////////////////////////////////////////////////////////////
+class SentenceGen
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] grammer 対象の文法
+  /// @param[in] seed 乱数の種
+  ///
+  /// grammer には開始記号が設定されていなければならない．
+  SentenceGen(const Grammer& grammer,
+	      ymuint32 seed = 1);
+
+  /// @brief デストラクタ
+  ~SentenceGen();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 規則の重みを設定する．
+  /// @param[in] rule 対象の規則
+  /// @param[in] weight 重み (0 以上，デフォルトは 1)
+  void
+  set_weight(const Rule* rule,
+	     double weight);
+
+  /// @brief 最短でない規則の重みに掛ける係数を設定する．
+  /// @param[in] growth 係数 (デフォルトは 1)
+  ///
+  /// 大きくすると目標の長さに近い文が生成される．
+  void
+  set_growth(double growth);
+
+  /// @brief 乱数の種を設定し直す．
+  void
+  set_seed(ymuint32 seed);
+
+  /// @brief 記号から導出される最短の終端記号列の長さを返す．
+  /// @param[in] token 記号
+  ///
+  /// 終端記号列を導出できない場合には kInfLength を返す．
+  ymuint
+  min_length(const Token* token) const;
+
+  /// @brief 開始記号から文を一つ生成する．
+  /// @param[in] target 目標の長さ
+  /// @param[in] sink 出力先
+  /// @return 生成した終端記号数を返す．
+  ///
+  /// 生成される文の長さは max(target, min_length(開始記号)) 以下となる．
+  /// 入口が複数ある場合はどれか一つの入口の文になる．
+  ymuint64
+  generate(ymuint64 target,
+	   SentenceSink& sink);
+
+  /// @brief 指定した記号から記号列を一つ生成する．
+  /// @param[in] start 開始記号
+  /// @param[in] target 目標の長さ
+  /// @param[in] sink 出力先
+  /// @return 生成した終端記号数を返す．
+  ymuint64
+  generate(const Token* start,
+	   ymuint64 target,
+	   SentenceSink& sink);
+
+  /// @brief 終端記号列を導出できないことを表す長さ
+  static
+  const ymuint kInfLength = 0xFFFFFFFFU;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // 内部で用いられる関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 記号と規則の最短の導出を求める．
+  void
+  calc_min_cost();
+
+  /// @brief 規則を選ぶ．
+  /// @param[in] token 展開する記号
+  /// @param[inout] budget 残りの予算
+  const Rule*
+  choose_rule(const Token* token,
+	      ymuint64& budget);
+
+  /// @brief [0, 1) の乱数を返す．
+  double
+  rand_double();
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 対象の文法
+  const Grammer& mGrammer;
+
+  // 記号の最短の長さ
+  // Token::id() をキーにした配列
+  vector<ymuint> mTokenLen;
+
+  // 記号の最短の導出の段数
+  // Token::id() をキーにした配列
+  vector<ymuint> mTokenStep;
+
+  // 規則の最短の長さ
+  // Rule::id() をキーにした配列
+  vector<ymuint> mRuleLen;
+
+  // 規則が最短の導出の時 true
+  // Rule::id() をキーにした配列
+  vector<bool> mRuleMinimal;
+
+  // 規則の重み
+  // Rule::id() をキーにした配列
+  vector<double> mWeight;
+
+  // 最短でない規則の重みに掛ける係数
+  double mGrowth;
+
+  // 乱数の状態
+  ymuint64 mRandState;
+
+  // 未展開の記号のスタック
+  vector<const Token*> mStack;
+
+  // 規則の候補 (作業用)
+  vector<const Rule*> mCandList;
+
+  // 候補の重み (作業用)
+  vector<double> mCandWeight;
+
+};
+
+END_NAMESPACE_YM
+
+#endif // SENTENCEGEN_H
@@ -0,0 +1,222 @@
+#ifndef STRVIEW_H
+#define STRVIEW_H
+
+/// @file StrView.h
+/// @brief StrView のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+#include <cstring>
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+/// @class StrView StrView.h "StrView.h"
+/// @brief 他の場所にある文字列の一部を指すクラス
+///
+/// 先頭のポインタと長さだけを持ち，文字列は複写しない．
+/// 指している文字列 (MappedFile の内容など) より長く使ってはならない．
+/// 文字列を残す必要がある時だけ str() で複写する．
+//////////////////////////////////////////////////////////////////////
+class StrView
+{
+public:
+
+  /// @brief 空のコンストラクタ
+  StrView();
+
+  /// @brief コンストラクタ
+  /// @param[in] data 先頭のポインタ
+  /// @param[in] size 長さ
+  StrView(const char* data,
+	  ymuint size);
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 先頭のポインタを返す．
+  ///
+  /// 末尾の '\\0' はない．
+  const char*
+  data() const;
+
+  /// @brief 長さを返す．
+  ymuint
+  size() const;
+
+  /// @brief 空の時 true を返す．
+  bool
+  empty() const;
+
+  /// @brief 文字を返す．
+  /// @param[in] pos 位置 ( 0 <= pos < size() )
+  char
+  operator[](ymuint pos) const;
+
+  /// @brief 複写した string を返す．
+  string
+  str() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 先頭のポインタ
+  const char* mData;
+
+  // 長さ
+  ymuint mSize;
+
+};
+
+/// @brief 等価比較
+bool
+operator==(const StrView& left,
+	   const StrView& right);
+
+/// @brief 等価比較
+bool
+operator==(const StrView& left,
+	   const char* right);
+
+/// @brief 非等価比較
+bool
+operator!=(const StrView& left,
+	   const StrView& right);
+
+/// @brief 非等価比較
+bool
+operator!=(const StrView& left,
+	   const char* right);
+
+/// @brief ストリーム出力
+ostream&
+operator<<(ostream& s,
+	   const StrView& view);
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief 空のコンストラクタ
+inline
+StrView::StrView() :
+  mData(""),
+  mSize(0)
+{
+}
+
+// @brief コンストラクタ
+// @param[in] data 先頭のポインタ
+// @param[in] size 長さ
+inline
+StrView::StrView(const char* data,
+		 ymuint size) :
+  mData(data),
+  mSize(size)
+{
+}
+
+// @brief 先頭のポインタを返す．
+inline
+const char*
+StrView::data() const
+{
+  return mData;
+}
+
+// @brief 長さを返す．
+inline
+ymuint
+StrView::size() const
+{
+  return mSize;
+}
+
+// @brief 空の時 true を返す．
+inline
+bool
+StrView::empty() const
+{
+  return mSize == 0;
+}
+
+// @brief 文字を返す．
+// @param[in] pos 位置 ( 0 <= pos < size() )
+inline
+char
+StrView::operator[](ymuint pos) const
+{
+  ASSERT_COND( pos < mSize );
+  return mData[pos];
+}
+
+// @brief 複写した string を返す．
+inline
+string
+StrView::str() const
+{
+  return string(mData, mSize);
+}
+
+// @brief 等価比較
+inline
+bool
+operator==(const StrView& left,
+	   const StrView& right)
+{
+  return left.size() == right.size() &&
+    memcmp(left.data(), right.data(), left.size()) == 0;
+}
+
+// @brief 等価比較
+inline
+bool
+operator==(const StrView& left,
+	   const char* right)
+{
+  return left == StrView(right, strlen(right));
+}
+
+// @brief 非等価比較
+inline
+bool
+operator!=(const StrView& left,
+	   const StrView& right)
+{
+  return !(left == right);
+}
+
+// @brief 非等価比較
+inline
+bool
+operator!=(const StrView& left,
+	   const char* right)
+{
+  return !(left == right);
+}
+
+// @brief ストリーム出力
+inline
+ostream&
+operator<<(ostream& s,
+	   const StrView& view)
+{
+  s.write(view.data(), view.size());
+  return s;
+}
+
+END_NAMESPACE_YM
+
+#endif // STRVIEW_H
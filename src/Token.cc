@@ -26,6 +26,7 @@ Token::Token(ymuint id,
 	     ymuint pri,
 	     AssocType assoc) :
   mId(id),
+  mDenseId(id),
   mStr(str),
   mPri(pri),
   mAssocType(assoc)
@@ -44,8 +45,22 @@ Token::id() const
   return mId;
 }
 
+// @brief 終端記号と非終端記号で分けた通し番号を返す．
+ymuint
+Token::dense_id() const
+{
+  return mDenseId;
+}
+
+// @brief 終端記号の時 true を返す．
+bool
+Token::is_terminal() const
+{
+  return mRuleList.empty();
+}
+
 // @brief 文字列を返す．
-string
+const string&
 Token::str() const
 {
   return mStr;
@@ -65,6 +80,13 @@ Token::assoc_type() const
   return mAssocType;
 }
 
+// @brief 字句のパターンを返す．
+const string&
+Token::pattern() const
+{
+  return mPattern;
+}
+
 // @brief 文法規則のリストを返す．
 const vector<const Rule*>&
 Token::rule_list() const
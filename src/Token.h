@@ -46,11 +46,26 @@ public:
   //////////////////////////////////////////////////////////////////////
 
   /// @brief ID番号を返す．
+  ///
+  /// add_token() で作られた順の番号で，Grammer::freeze() の後も変わらない．
   ymuint
   id() const;
 
+  /// @brief 終端記号と非終端記号で分けた通し番号を返す．
+  ///
+  /// 終端記号が [0, T)，非終端記号が [T, T + N) を占める．
+  /// Grammer::freeze() の後でのみ意味を持つ．
+  ymuint
+  dense_id() const;
+
+  /// @brief 終端記号の時 true を返す．
+  ///
+  /// このトークンを左辺に持つ文法規則がないものを終端記号とする．
+  bool
+  is_terminal() const;
+
   /// @brief 文字列を返す．
-  string
+  const string&
   str() const;
 
   /// @brief 優先順位を返す．
@@ -61,6 +76,13 @@ public:
   AssocType
   assoc_type() const;
 
+  /// @brief 字句のパターンを返す．
+  ///
+  /// Grammer::set_pattern() で設定した正規表現である．
+  /// 設定していない時は空文字列を返す．
+  const string&
+  pattern() const;
+
   /// @brief 文法規則のリストを返す．
   const vector<const Rule*>&
   rule_list() const;
@@ -82,6 +104,9 @@ private:
   // ID番号
   ymuint mId;
 
+  // 終端記号と非終端記号で分けた通し番号
+  ymuint mDenseId;
+
   // 文字列
   string mStr;
 
@@ -92,6 +117,9 @@ private:
   // 結合性
   AssocType mAssocType;
 
+  // 字句のパターン
+  string mPattern;
+
   // このトークンを左辺に持つ文法規則のリスト
   vector<const Rule*> mRuleList;
 
@@ -0,0 +1,214 @@
+
+/// @file Trace.cc
+/// @brief TraceSink, StreamTraceSink の実装ファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "Trace.h"
+#include "LR0State.h"
+#include "LR0Term.h"
+#include "LR1Term.h"
+#include "Rule.h"
+#include "Token.h"
+
+
+BEGIN_NAMESPACE_YM
+
+//////////////////////////////////////////////////////////////////////
+// クラス TraceSink
+//////////////////////////////////////////////////////////////////////
+
+// @brief デストラクタ
+TraceSink::~TraceSink()
+{
+}
+
+// @brief LR(0)項集合の閉包を求めた．
+void
+TraceSink::lr0_closure(const vector<LR0Term>& input,
+		       const vector<LR0Term>& output)
+{
+}
+
+// @brief LR(1)項集合の閉包を求めた．
+void
+TraceSink::lr1_closure(const vector<LR1Term>& input,
+		       const vector<LR1Term>& output)
+{
+}
+
+// @brief 状態を生成した．
+void
+TraceSink::new_state(const LR0State* state)
+{
+}
+
+// @brief 先読みが生成された．
+void
+TraceSink::generation(const LR0State* state,
+		      ymuint local_term_id,
+		      const Token* token)
+{
+}
+
+// @brief 先読みの伝搬の枝を見つけた．
+void
+TraceSink::propagation(const LR0State* src_state,
+		       ymuint src_term_id,
+		       const LR0State* dst_state,
+		       ymuint dst_term_id)
+{
+}
+
+// @brief 項の先読みトークンが確定した．
+void
+TraceSink::lookahead(const LR0State* state,
+		     ymuint local_term_id,
+		     const vector<const Token*>& token_list)
+{
+}
+
+// @brief shift/reduce 衝突を見つけた．
+void
+TraceSink::shift_reduce_conflict(const LR0State* state,
+				 const Token* token,
+				 const Rule* rule)
+{
+}
+
+// @brief reduce/reduce 衝突を見つけた．
+void
+TraceSink::reduce_reduce_conflict(const LR0State* state,
+				  const Token* token,
+				  const Rule* rule1,
+				  const Rule* rule2)
+{
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// クラス StreamTraceSink
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] s 出力先のストリーム
+StreamTraceSink::StreamTraceSink(ostream& s) :
+  mS(s)
+{
+}
+
+// @brief デストラクタ
+StreamTraceSink::~StreamTraceSink()
+{
+}
+
+// @brief LR(0)項集合の閉包を求めた．
+void
+StreamTraceSink::lr0_closure(const vector<LR0Term>& input,
+			     const vector<LR0Term>& output)
+{
+  mS << "LR(0) closure:" << endl;
+  for (vector<LR0Term>::const_iterator p = input.begin();
+       p != input.end(); ++ p) {
+    mS << *p << endl;
+  }
+  mS << endl;
+  mS << "LR(0) closure end:" << endl;
+  for (vector<LR0Term>::const_iterator p = output.begin();
+       p != output.end(); ++ p) {
+    mS << *p << endl;
+  }
+  mS << endl;
+}
+
+// @brief LR(1)項集合の閉包を求めた．
+void
+StreamTraceSink::lr1_closure(const vector<LR1Term>& input,
+			     const vector<LR1Term>& output)
+{
+  mS << "LR1_closure" << endl;
+  for (vector<LR1Term>::const_iterator p = input.begin();
+       p != input.end(); ++ p) {
+    mS << *p << endl;
+  }
+  mS << endl;
+  mS << "LR1_closure end" << endl;
+  for (vector<LR1Term>::const_iterator p = output.begin();
+       p != output.end(); ++ p) {
+    mS << *p << endl;
+  }
+  mS << endl;
+}
+
+// @brief 状態を生成した．
+void
+StreamTraceSink::new_state(const LR0State* state)
+{
+  state->print(mS);
+}
+
+// @brief 先読みが生成された．
+void
+StreamTraceSink::generation(const LR0State* state,
+			    ymuint local_term_id,
+			    const Token* token)
+{
+  mS << "Generation: " << token->str()
+     << " at State#" << state->id() << endl
+     << state->term_list()[local_term_id] << endl;
+}
+
+// @brief 先読みの伝搬の枝を見つけた．
+void
+StreamTraceSink::propagation(const LR0State* src_state,
+			     ymuint src_term_id,
+			     const LR0State* dst_state,
+			     ymuint dst_term_id)
+{
+  mS << "Propagation: State#" << src_state->id()
+     << " -> State#" << dst_state->id() << endl
+     << src_state->term_list()[src_term_id] << endl
+     << dst_state->term_list()[dst_term_id] << endl;
+}
+
+// @brief 項の先読みトークンが確定した．
+void
+StreamTraceSink::lookahead(const LR0State* state,
+			   ymuint local_term_id,
+			   const vector<const Token*>& token_list)
+{
+  mS << "State#" << state->id() << ":"
+     << state->term_list()[local_term_id] << ", ";
+  for (vector<const Token*>::const_iterator p = token_list.begin();
+       p != token_list.end(); ++ p) {
+    mS << " " << (*p)->str();
+  }
+  mS << endl;
+}
+
+// @brief shift/reduce 衝突を見つけた．
+void
+StreamTraceSink::shift_reduce_conflict(const LR0State* state,
+				       const Token* token,
+				       const Rule* rule)
+{
+  mS << "State#" << state->id() << ": shift/reduce conflict on "
+     << token->str() << " with Rule#" << rule->id() << endl;
+}
+
+// @brief reduce/reduce 衝突を見つけた．
+void
+StreamTraceSink::reduce_reduce_conflict(const LR0State* state,
+					const Token* token,
+					const Rule* rule1,
+					const Rule* rule2)
+{
+  mS << "State#" << state->id() << ": reduce/reduce conflict on "
+     << token->str() << " between Rule#" << rule1->id()
+     << " and Rule#" << rule2->id() << endl;
+}
+
+END_NAMESPACE_YM
@@ -0,0 +1,343 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/// @file Trace.h
+/// @brief Tracer, TraceSink のヘッダファイル
+/// @author Yusuke Matsunaga (松永 裕介)
+///
+/// Copyright (C) 2014 Yusuke Matsunaga
+/// All rights reserved.
+
+
+#include "YmTools.h"
+
+
+/// @brief トレース呼び出しをコンパイルするかどうかを決めるフラグ
+///
+/// 0 にするとすべての PARSER_TRACE() が空文になる．
+#ifndef PARSER_ENABLE_TRACE
+#define PARSER_ENABLE_TRACE 1
+#endif
+
+
+BEGIN_NAMESPACE_YM
+
+class LR0State;
+class LR0Term;
+class LR1Term;
+class Rule;
+class Token;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief トレースイベントの種類を表す列挙型
+///
+/// ビットマスクとして OR を取って用いる．
+//////////////////////////////////////////////////////////////////////
+enum TraceCategory {
+  /// @brief 項集合の閉包
+  kTraceClosure     = 1U << 0,
+  /// @brief 状態の生成
+  kTraceState       = 1U << 1,
+  /// @brief 先読みの生成
+  kTraceGeneration  = 1U << 2,
+  /// @brief 先読みの伝搬
+  kTracePropagation = 1U << 3,
+  /// @brief 先読みの計算結果
+  kTraceLookahead   = 1U << 4,
+  /// @brief 衝突
+  kTraceConflict    = 1U << 5,
+  /// @brief 全て
+  kTraceAll         = (1U << 6) - 1U
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class TraceSink Trace.h "Trace.h"
+/// @brief 構文解析表の生成中のイベントを受け取るクラス
+///
+/// 各関数のデフォルトの実装はなにもしない．
+/// 必要なものだけを継承クラスで上書きする．
+//////////////////////////////////////////////////////////////////////
+class TraceSink
+{
+public:
+
+  /// @brief デストラクタ
+  virtual
+  ~TraceSink();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief LR(0)項集合の閉包を求めた．(kTraceClosure)
+  /// @param[in] input 入力の項集合
+  /// @param[in] output 閉包集合
+  virtual
+  void
+  lr0_closure(const vector<LR0Term>& input,
+	      const vector<LR0Term>& output);
+
+  /// @brief LR(1)項集合の閉包を求めた．(kTraceClosure)
+  /// @param[in] input 入力の項集合
+  /// @param[in] output 閉包集合
+  virtual
+  void
+  lr1_closure(const vector<LR1Term>& input,
+	      const vector<LR1Term>& output);
+
+  /// @brief 状態を生成した．(kTraceState)
+  /// @param[in] state 生成された状態
+  virtual
+  void
+  new_state(const LR0State* state);
+
+  /// @brief 先読みが生成された．(kTraceGeneration)
+  /// @param[in] state 生成先の状態
+  /// @param[in] local_term_id 生成先の状態中の項番号
+  /// @param[in] token 先読みトークン
+  virtual
+  void
+  generation(const LR0State* state,
+	     ymuint local_term_id,
+	     const Token* token);
+
+  /// @brief 先読みの伝搬の枝を見つけた．(kTracePropagation)
+  /// @param[in] src_state 伝搬元の状態
+  /// @param[in] src_term_id 伝搬元の状態中の項番号
+  /// @param[in] dst_state 伝搬先の状態
+  /// @param[in] dst_term_id 伝搬先の状態中の項番号
+  virtual
+  void
+  propagation(const LR0State* src_state,
+	      ymuint src_term_id,
+	      const LR0State* dst_state,
+	      ymuint dst_term_id);
+
+  /// @brief 項の先読みトークンが確定した．(kTraceLookahead)
+  /// @param[in] state 状態
+  /// @param[in] local_term_id 状態中の項番号
+  /// @param[in] token_list 先読みトークンのリスト
+  virtual
+  void
+  lookahead(const LR0State* state,
+	    ymuint local_term_id,
+	    const vector<const Token*>& token_list);
+
+  /// @brief shift/reduce 衝突を見つけた．(kTraceConflict)
+  /// @param[in] state 状態
+  /// @param[in] token 先読みトークン
+  /// @param[in] rule reduce 側の文法規則
+  virtual
+  void
+  shift_reduce_conflict(const LR0State* state,
+			const Token* token,
+			const Rule* rule);
+
+  /// @brief reduce/reduce 衝突を見つけた．(kTraceConflict)
+  /// @param[in] state 状態
+  /// @param[in] token 先読みトークン
+  /// @param[in] rule1 採用された文法規則
+  /// @param[in] rule2 捨てられた文法規則
+  virtual
+  void
+  reduce_reduce_conflict(const LR0State* state,
+			 const Token* token,
+			 const Rule* rule1,
+			 const Rule* rule2);
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class StreamTraceSink Trace.h "Trace.h"
+/// @brief イベントをテキストとしてストリームに書き出す TraceSink
+//////////////////////////////////////////////////////////////////////
+class StreamTraceSink :
+  public TraceSink
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] s 出力先のストリーム
+  StreamTraceSink(ostream& s);
+
+  /// @brief デストラクタ
+  virtual
+  ~StreamTraceSink();
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // TraceSink の仮想関数
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief LR(0)項集合の閉包を求めた．
+  virtual
+  void
+  lr0_closure(const vector<LR0Term>& input,
+	      const vector<LR0Term>& output);
+
+  /// @brief LR(1)項集合の閉包を求めた．
+  virtual
+  void
+  lr1_closure(const vector<LR1Term>& input,
+	      const vector<LR1Term>& output);
+
+  /// @brief 状態を生成した．
+  virtual
+  void
+  new_state(const LR0State* state);
+
+  /// @brief 先読みが生成された．
+  virtual
+  void
+  generation(const LR0State* state,
+	     ymuint local_term_id,
+	     const Token* token);
+
+  /// @brief 先読みの伝搬の枝を見つけた．
+  virtual
+  void
+  propagation(const LR0State* src_state,
+	      ymuint src_term_id,
+	      const LR0State* dst_state,
+	      ymuint dst_term_id);
+
+  /// @brief 項の先読みトークンが確定した．
+  virtual
+  void
+  lookahead(const LR0State* state,
+	    ymuint local_term_id,
+	    const vector<const Token*>& token_list);
+
+  /// @brief shift/reduce 衝突を見つけた．
+  virtual
+  void
+  shift_reduce_conflict(const LR0State* state,
+			const Token* token,
+			const Rule* rule);
+
+  /// @brief reduce/reduce 衝突を見つけた．
+  virtual
+  void
+  reduce_reduce_conflict(const LR0State* state,
+			 const Token* token,
+			 const Rule* rule1,
+			 const Rule* rule2);
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 出力先のストリーム
+  ostream& mS;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+/// @class Tracer Trace.h "Trace.h"
+/// @brief TraceSink と出力するイベントの種類の組
+///
+/// sink が NULL かマスクが 0 の時は何も出力しない．
+//////////////////////////////////////////////////////////////////////
+class Tracer
+{
+public:
+
+  /// @brief コンストラクタ
+  /// @param[in] sink イベントの出力先
+  /// @param[in] mask 出力するイベントの種類 (TraceCategory の OR)
+  Tracer(TraceSink* sink = NULL,
+	 ymuint mask = kTraceAll);
+
+
+public:
+  //////////////////////////////////////////////////////////////////////
+  // 外部インターフェイス
+  //////////////////////////////////////////////////////////////////////
+
+  /// @brief 指定された種類のイベントを出力するか調べる．
+  /// @param[in] cat イベントの種類
+  bool
+  enabled(TraceCategory cat) const;
+
+  /// @brief 出力先を返す．
+  TraceSink*
+  sink() const;
+
+
+private:
+  //////////////////////////////////////////////////////////////////////
+  // データメンバ
+  //////////////////////////////////////////////////////////////////////
+
+  // 出力先
+  TraceSink* mSink;
+
+  // 出力するイベントの種類
+  ymuint mMask;
+
+};
+
+
+//////////////////////////////////////////////////////////////////////
+// インライン関数の定義
+//////////////////////////////////////////////////////////////////////
+
+// @brief コンストラクタ
+// @param[in] sink イベントの出力先
+// @param[in] mask 出力するイベントの種類 (TraceCategory の OR)
+inline
+Tracer::Tracer(TraceSink* sink,
+	       ymuint mask) :
+  mSink(sink),
+  mMask(sink != NULL ? mask : 0U)
+{
+}
+
+// @brief 指定された種類のイベントを出力するか調べる．
+// @param[in] cat イベントの種類
+inline
+bool
+Tracer::enabled(TraceCategory cat) const
+{
+  return (mMask & cat) != 0U;
+}
+
+// @brief 出力先を返す．
+inline
+TraceSink*
+Tracer::sink() const
+{
+  return mSink;
+}
+
+END_NAMESPACE_YM
+
+
+/// @brief トレースイベントを出力するマクロ
+/// @param[in] tracer Tracer オブジェクト
+/// @param[in] cat イベントの種類
+/// @param[in] call TraceSink のメンバ関数呼び出し
+///
+/// 例: PARSER_TRACE(tracer, kTraceState, new_state(state));
+/// PARSER_ENABLE_TRACE が 0 の時は引数の評価も含めて何も行わない．
+#if PARSER_ENABLE_TRACE
+#define PARSER_TRACE(tracer, cat, call) \
+  do { \
+    if ( (tracer).enabled(cat) ) { \
+      (tracer).sink()->call; \
+    } \
+  } while ( 0 )
+#else
+#define PARSER_TRACE(tracer, cat, call) \
+  do { } while ( 0 )
+#endif
+
+#endif // TRACE_H
@@ -10,12 +10,405 @@
 #include "../src/Grammer.h"
 #include "../src/LR0Set.h"
 #include "../src/LALR1Set.h"
+#include "../src/Trace.h"
+#include "../src/BuildStats.h"
+#include "../src/PhaseProfiler.h"
+#include "../src/ParseTable.h"
+#include "../src/LRParser.h"
+#include "../src/PackedParser.h"
+#include "../src/GLRParser.h"
+#include "../src/IncrParser.h"
+#include "../src/Lexer.h"
+#include "../src/MappedFile.h"
+#include "../src/ParseProfile.h"
+#include "../src/ParseCounter.h"
+#include "../src/SentenceGen.h"
+#include "../src/Token.h"
+#include "../src/Rule.h"
+#include <sstream>
+#include <cstdio>
 
 
 BEGIN_NAMESPACE_YM
 
+// 失敗した照合の数
+ymuint gFailNum = 0;
+
+// 照合の結果を調べる．
+// count が n と等しくない時は失敗として数える．
 void
-test1()
+check_all(const char* name,
+	  ymuint count,
+	  ymuint n)
+{
+  if ( count != n ) {
+    cerr << name << " check failed: " << count << " / " << n << endl;
+    ++ gFailNum;
+  }
+}
+
+// 生成された終端記号の番号を記録する SentenceSink
+class TokenListSink :
+  public SentenceSink
+{
+public:
+
+  // 終端記号を受け取る．
+  virtual
+  void
+  put_token(const Token* token)
+  {
+    mList.push_back(token->id());
+  }
+
+  // 終端記号の番号のリスト
+  vector<ymuint> mList;
+
+};
+
+// 構文解析表を作って出力し，入口ごとに無作為に生成した文を構文解析する．
+// 要素を狭い型にした表でも同じ結果になることを確かめる．
+// トークンを一つずつ渡す構文解析と再解析でも同じ結果になることを確かめる．
+// 衝突で捨てた動作を持つ表の GLR 構文解析では全ての文を受理する．
+void
+check_table(const Grammer& g,
+	    const LALR1Set& lalr1set,
+	    BuildStats* stats)
+{
+  ParseTable table(g, lalr1set, stats);
+
+  table.print(cout);
+
+  SentenceGen gen(g);
+  gen.set_growth(4.0);
+  LRParser parser(table);
+  PackedParser* packed = PackedParser::new_obj(table);
+  ParseProfile profile(table.state_num());
+  parser.set_profile(&profile);
+  TokenListSink sink;
+  const ymuint n = 100;
+  for (ymuint k = 0; k < g.start_num(); ++ k) {
+    const Token* start = g.start_rule(k)->right(0);
+    ymuint ok = 0;
+    ymuint same = 0;
+    for (ymuint i = 0; i < n; ++ i) {
+      sink.mList.clear();
+      gen.generate(start, i, sink);
+      bool stat = parser.parse(sink.mList, k);
+      if ( stat ) {
+	++ ok;
+      }
+      if ( packed->parse(sink.mList, k) == stat &&
+	   packed->reduce_num() == parser.reduce_num() ) {
+	++ same;
+      }
+    }
+    cout << "parse check: " << ok << " / " << n << " accepted" << endl
+	 << "packed check: " << same << " / " << n << " agreed" << endl;
+    check_all("parse", ok, n);
+    check_all("packed", same, n);
+  }
+
+  // 書き出した使用回数を読み直して状態番号をつけ直す．
+  ostringstream profile_out;
+  profile.write(profile_out);
+  istringstream profile_in(profile_out.str());
+  ParseProfile profile2;
+  bool read_stat = profile2.read(profile_in);
+  ASSERT_COND( read_stat );
+  ParseTable hot_table(table);
+  hot_table.reorder(profile2);
+  LRParser hot_parser(hot_table);
+  parser.set_profile(NULL);
+  LRParserT<ParseTable, ParseCounter> counted_parser(table);
+  for (ymuint k = 0; k < g.start_num(); ++ k) {
+    const Token* start = g.start_rule(k)->right(0);
+    ymuint same = 0;
+    for (ymuint i = 0; i < n; ++ i) {
+      sink.mList.clear();
+      gen.generate(start, i, sink);
+      bool stat = parser.parse(sink.mList, k);
+      if ( hot_parser.parse(sink.mList, k) == stat &&
+	   hot_parser.reduce_num() == parser.reduce_num() &&
+	   hot_parser.error_pos() == parser.error_pos() ) {
+	++ same;
+      }
+      counted_parser.parse(sink.mList, k);
+    }
+    cout << "reorder check: " << same << " / " << n << " agreed" << endl;
+    check_all("reorder", same, n);
+  }
+  counted_parser.counter().write_json(cout, g);
+
+  // トークンを一つずつ渡しても parse() と同じ結果になる．
+  // PackedParser に渡しても同じになる．
+  // 途中のトークンを入れ替えた誤りのある文も試す．
+  LRParser push_parser(table);
+  for (ymuint k = 0; k < g.start_num(); ++ k) {
+    const Token* start = g.start_rule(k)->right(0);
+    ymuint same = 0;
+    for (ymuint i = 0; i < n; ++ i) {
+      sink.mList.clear();
+      gen.generate(start, i, sink);
+      if ( i % 2 == 1 && !sink.mList.empty() ) {
+	sink.mList[i % sink.mList.size()] = sink.mList[0];
+      }
+      bool stat = parser.parse(sink.mList, k);
+      push_parser.start(k);
+      LRParser::PushResult result = LRParser::kNeedMore;
+      for (vector<ymuint>::iterator p = sink.mList.begin();
+	   p != sink.mList.end() && result == LRParser::kNeedMore; ++ p) {
+	result = push_parser.push(*p);
+      }
+      if ( result == LRParser::kNeedMore ) {
+	result = push_parser.push(Grammer::kEnd);
+      }
+      packed->start(k);
+      PackedParser::PushResult packed_result = PackedParser::kNeedMore;
+      for (vector<ymuint>::iterator p = sink.mList.begin();
+	   p != sink.mList.end() && packed_result == PackedParser::kNeedMore; ++ p) {
+	packed_result = packed->push(*p);
+      }
+      if ( packed_result == PackedParser::kNeedMore ) {
+	packed_result = packed->push(Grammer::kEnd);
+      }
+      if ( (result == LRParser::kAccepted) == stat &&
+	   push_parser.error_pos() == parser.error_pos() &&
+	   (packed_result == PackedParser::kAccepted) == stat &&
+	   packed->error_pos() == parser.error_pos() ) {
+	++ same;
+      }
+    }
+    cout << "push check: " << same << " / " << n << " agreed" << endl;
+    check_all("push", same, n);
+  }
+
+  // 入力の一部を置き換えて再解析した木が全体を構文解析し直した木と
+  // 同じになる．置き換えるのは同じトークンか別の位置のトークンで，
+  // 置き換えた後に元に戻したものも再解析する．
+  IncrParser incr_parser(table);
+  IncrParser full_parser(table);
+  for (ymuint k = 0; k < g.start_num(); ++ k) {
+    const Token* start = g.start_rule(k)->right(0);
+    ymuint same = 0;
+    ymuint incr_shift = 0;
+    ymuint full_shift = 0;
+    for (ymuint i = 0; i < n; ++ i) {
+      sink.mList.clear();
+      gen.generate(start, i, sink);
+      vector<ymuint> input1(sink.mList);
+      ymuint len1 = input1.size();
+      ymuint edit_pos = i % (len1 + 1);
+      ymuint old_len = i % 3;
+      if ( old_len > len1 - edit_pos ) {
+	old_len = len1 - edit_pos;
+      }
+      ymuint new_len = (i / 3) % 3;
+      vector<ymuint> input2(input1.begin(), input1.begin() + edit_pos);
+      for (ymuint j = 0; j < new_len && len1 > 0; ++ j) {
+	ymuint src = i % 2 == 0 ? edit_pos + j : j * 7 + i;
+	input2.push_back(input1[src % len1]);
+      }
+      new_len = input2.size() - edit_pos;
+      input2.insert(input2.end(), input1.begin() + edit_pos + old_len, input1.end());
+
+      incr_parser.parse(input1, k);
+      bool ok = true;
+      for (ymuint step = 0; step < 2; ++ step) {
+	const vector<ymuint>& input = step == 0 ? input2 : input1;
+	bool stat = step == 0 ?
+	  incr_parser.reparse(input2, edit_pos, old_len, new_len) :
+	  incr_parser.reparse(input1, edit_pos, new_len, old_len);
+	if ( full_parser.parse(input, k) != stat ||
+	     full_parser.error_pos() != incr_parser.error_pos() ) {
+	  ok = false;
+	}
+	else if ( stat ) {
+	  ostringstream incr_tree;
+	  incr_parser.print_tree(incr_tree, g);
+	  ostringstream full_tree;
+	  full_parser.print_tree(full_tree, g);
+	  if ( incr_tree.str() != full_tree.str() ||
+	       incr_parser.node_length(incr_parser.root()) != input.size() ) {
+	    ok = false;
+	  }
+	}
+	incr_shift += incr_parser.shift_num();
+	full_shift += full_parser.shift_num();
+      }
+      if ( ok ) {
+	++ same;
+      }
+    }
+    cout << "incr check: " << same << " / " << n << " agreed (shift: "
+	 << incr_shift << " / " << full_shift << ")" << endl;
+    check_all("incr", same, n);
+  }
+
+  ParseTable glr_table(g, lalr1set, NULL, true);
+  GLRParser glr_parser(glr_table);
+  for (ymuint k = 0; k < g.start_num(); ++ k) {
+    const Token* start = g.start_rule(k)->right(0);
+    ymuint ok = 0;
+    ymuint max_width = 0;
+    for (ymuint i = 0; i < n; ++ i) {
+      sink.mList.clear();
+      gen.generate(start, i, sink);
+      if ( glr_parser.parse(sink.mList, k) ) {
+	++ ok;
+      }
+      if ( max_width < glr_parser.max_width() ) {
+	max_width = glr_parser.max_width();
+      }
+    }
+    cout << "glr check: " << ok << " / " << n << " accepted (max width: "
+	 << max_width << ")" << endl;
+    check_all("glr", ok, n);
+  }
+  cout << "packed table: " << packed->table_bytes() << " / "
+       << table.table_bytes() << " bytes (symbol: "
+       << packed->symbol_width() << ", state: "
+       << packed->state_width() << ", code: "
+       << packed->code_width() << ")" << endl
+       << endl;
+  delete packed;
+}
+
+// SentenceGen が求めた最短の導出の長さを手で求めた値と比べる．
+// token_list と length_list は NULL で終わる記号の配列とその長さである．
+// 生成した文の長さが max(target, min_length(開始記号)) 以下であり，
+// generate() の返す値が sink に渡した終端記号数と等しいことも確かめる．
+void
+check_sentence_gen(const Grammer& g,
+		   const Token* const token_list[],
+		   const ymuint length_list[])
+{
+  SentenceGen gen(g);
+  gen.set_growth(4.0);
+
+  ymuint num = 0;
+  ymuint same = 0;
+  cout << "min_length:";
+  for ( ; token_list[num] != NULL; ++ num) {
+    ymuint len = gen.min_length(token_list[num]);
+    cout << " " << token_list[num]->str() << "=" << len;
+    if ( len == length_list[num] ) {
+      ++ same;
+    }
+  }
+  cout << endl;
+  check_all("min_length", same, num);
+
+  // 入口ごとの開始記号と全体の開始記号について試す．
+  vector<const Token*> start_list;
+  for (ymuint k = 0; k < g.start_num(); ++ k) {
+    start_list.push_back(g.start_rule(k)->right(0));
+  }
+  start_list.push_back(g.token(Grammer::kStart));
+  const ymuint n = 100;
+  TokenListSink sink;
+  ymuint ok = 0;
+  for (ymuint k = 0; k < start_list.size(); ++ k) {
+    const Token* start = start_list[k];
+    ymuint bound0 = gen.min_length(start);
+    for (ymuint i = 0; i < n; ++ i) {
+      sink.mList.clear();
+      ymuint64 len = start == g.token(Grammer::kStart) ?
+	gen.generate(i, sink) : gen.generate(start, i, sink);
+      ymuint bound = i > bound0 ? i : bound0;
+      if ( len == sink.mList.size() && len <= bound ) {
+	++ ok;
+      }
+    }
+  }
+  cout << "sentence length check: " << ok << " / "
+       << n * start_list.size() << " agreed" << endl;
+  check_all("sentence length", ok, n * start_list.size());
+}
+
+// 空記号を導出する非終端記号を含む文法．
+// FIRST と FOLLOW は右辺の残りが空記号を導出する場合も考慮し，
+// 状態 0 では空の規則 A ::= と B ::= を b と c で還元する．
+void
+test0(const Tracer& tracer,
+      BuildStats* stats)
+{
+  Grammer g;
+
+  Token* a = g.add_token("a");
+  Token* b = g.add_token("b");
+  Token* c = g.add_token("c");
+  Token* S = g.add_token("S");
+  Token* A = g.add_token("A");
+  Token* B = g.add_token("B");
+
+  {
+    vector<Token*> right;
+    right.push_back(A);
+    right.push_back(B);
+    right.push_back(c);
+    g.add_rule(S, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(a);
+    g.add_rule(A, right);
+  }
+  {
+    vector<Token*> right;
+    g.add_rule(A, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(b);
+    g.add_rule(B, right);
+  }
+  {
+    vector<Token*> right;
+    g.add_rule(B, right);
+  }
+  g.set_start(S, stats);
+
+  g.print_tokens(cout);
+
+  g.print_rules(cout);
+
+  Token* nonterminal_list[] = { S, A, B, NULL };
+  for (ymuint i = 0; nonterminal_list[i] != NULL; ++ i) {
+    const Token* token = nonterminal_list[i];
+    cout << "FIRST(" << token->str() << "):";
+    for (vector<const Token*>::const_iterator p = token->first().begin();
+	 p != token->first().end(); ++ p) {
+      cout << " " << (*p)->str();
+    }
+    cout << endl
+	 << "FOLLOW(" << token->str() << "):";
+    for (vector<const Token*>::const_iterator p = token->follow().begin();
+	 p != token->follow().end(); ++ p) {
+      cout << " " << (*p)->str();
+    }
+    cout << endl;
+  }
+  cout << endl;
+
+  {
+    const Token* token_list[] = { S, A, B, c, NULL };
+    const ymuint length_list[] = { 1, 0, 0, 1 };
+    check_sentence_gen(g, token_list, length_list);
+  }
+
+  LALR1Set lr0set(&g, tracer, stats);
+
+  lr0set.print(cout);
+
+  if ( stats != NULL ) {
+    stats->dump_json(cout);
+  }
+}
+
+void
+test1(const Tracer& tracer,
+      BuildStats* stats)
 {
   Grammer g;
 
@@ -64,19 +457,32 @@ test1()
     right.push_back(id);
     g.add_rule(factor, right);
   }
-  g.set_start(expr);
+  g.set_start(expr, stats);
 
   g.print_tokens(cout);
 
   g.print_rules(cout);
 
-  LALR1Set lr0set(&g);
+  LALR1Set lr0set(&g, tracer, stats);
 
   lr0set.print(cout);
+
+  {
+    const Token* token_list[] = { expr, term, factor, id, NULL };
+    const ymuint length_list[] = { 1, 1, 1, 1 };
+    check_sentence_gen(g, token_list, length_list);
+  }
+
+  check_table(g, lr0set, stats);
+
+  if ( stats != NULL ) {
+    stats->dump_json(cout);
+  }
 }
 
 void
-test2()
+test2(const Tracer& tracer,
+      BuildStats* stats)
 {
   Grammer g;
 
@@ -117,19 +523,26 @@ test2()
     g.add_rule(R, right);
   }
 
-  g.set_start(S);
+  g.set_start(S, stats);
 
   g.print_tokens(cout);
 
   g.print_rules(cout);
 
-  LALR1Set lr0set(&g);
+  LALR1Set lr0set(&g, tracer, stats);
 
   lr0set.print(cout);
+
+  check_table(g, lr0set, stats);
+
+  if ( stats != NULL ) {
+    stats->dump_json(cout);
+  }
 }
 
 void
-test3()
+test3(const Tracer& tracer,
+      BuildStats* stats)
 {
   Grammer g;
 
@@ -168,32 +581,644 @@ test3()
     g.add_rule(expr, right);
   }
 
-  g.set_start(expr);
+  g.set_start(expr, stats);
+
+  g.print_tokens(cout);
+
+  g.print_rules(cout);
+
+  LALR1Set lr0set(&g, tracer, stats);
+
+  lr0set.print(cout);
+
+  check_table(g, lr0set, stats);
+
+  if ( stats != NULL ) {
+    stats->dump_json(cout);
+  }
+}
+
+void
+test4(const Tracer& tracer,
+      BuildStats* stats)
+{
+  // 式と文の二つの入口を持つ文法
+  Grammer g;
+
+  Token* id = g.add_token("id");
+  Token* plus = g.add_token("+", 1, kLeftAssoc);
+  Token* eq = g.add_token("=");
+  Token* semi = g.add_token(";");
+
+  Token* stmt_list = g.add_token("stmt_list");
+  Token* stmt = g.add_token("stmt");
+  Token* expr = g.add_token("expr");
+
+  {
+    vector<Token*> right;
+    right.push_back(stmt_list);
+    right.push_back(stmt);
+    g.add_rule(stmt_list, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(stmt);
+    g.add_rule(stmt_list, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(id);
+    right.push_back(eq);
+    right.push_back(expr);
+    right.push_back(semi);
+    g.add_rule(stmt, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(expr);
+    right.push_back(plus);
+    right.push_back(expr);
+    g.add_rule(expr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(id);
+    g.add_rule(expr, right);
+  }
+
+  g.add_start(stmt_list);
+  g.add_start(expr);
+  g.analyze(stats);
 
   g.print_tokens(cout);
 
   g.print_rules(cout);
 
-  LALR1Set lr0set(&g);
+  LALR1Set lr0set(&g, tracer, stats);
 
   lr0set.print(cout);
+
+  // 文は id = id ; が最短である．
+  {
+    const Token* token_list[] = { stmt_list, stmt, expr, NULL };
+    const ymuint length_list[] = { 4, 4, 1 };
+    check_sentence_gen(g, token_list, length_list);
+  }
+
+  check_table(g, lr0set, stats);
+
+  if ( stats != NULL ) {
+    stats->dump_json(cout);
+  }
 }
 
 void
+test5(const Tracer& tracer,
+      BuildStats* stats)
+{
+  // 式と定数式が reduce/reduce 衝突を起こす文法
+  // 優先順位を持たない + は shift/reduce 衝突も起こす．
+  Grammer g;
+
+  Token* id = g.add_token("id");
+  Token* num = g.add_token("num");
+  Token* plus = g.add_token("+");
+  Token* semi = g.add_token(";");
+
+  Token* stmt = g.add_token("stmt");
+  Token* expr = g.add_token("expr");
+  Token* cexpr = g.add_token("constant_expr");
+
+  {
+    vector<Token*> right;
+    right.push_back(expr);
+    right.push_back(semi);
+    g.add_rule(stmt, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(cexpr);
+    right.push_back(semi);
+    g.add_rule(stmt, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(expr);
+    right.push_back(plus);
+    right.push_back(expr);
+    g.add_rule(expr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(id);
+    g.add_rule(expr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(num);
+    g.add_rule(expr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(cexpr);
+    right.push_back(plus);
+    right.push_back(cexpr);
+    g.add_rule(cexpr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(num);
+    g.add_rule(cexpr, right);
+  }
+
+  g.set_start(stmt);
+
+  g.print_tokens(cout);
+
+  g.print_rules(cout);
+
+  LALR1Set lr0set(&g, tracer, stats);
+
+  lr0set.print(cout);
+
+  {
+    const Token* token_list[] = { stmt, expr, cexpr, semi, NULL };
+    const ymuint length_list[] = { 2, 1, 1, 1 };
+    check_sentence_gen(g, token_list, length_list);
+  }
+
+  check_table(g, lr0set, stats);
+
+  // num + num + num ; の構文森を出力する．
+  ParseTable glr_table(g, lr0set, NULL, true);
+  glr_table.print(cout);
+  GLRParser glr_parser(glr_table);
+  vector<ymuint> input;
+  input.push_back(num->id());
+  input.push_back(plus->id());
+  input.push_back(num->id());
+  input.push_back(plus->id());
+  input.push_back(num->id());
+  input.push_back(semi->id());
+  bool stat = glr_parser.parse(input);
+  cout << "glr parse: " << (stat ? "accepted" : "rejected")
+       << " (reduce: " << glr_parser.reduce_num()
+       << ", max width: " << glr_parser.max_width() << ")" << endl;
+  glr_parser.print_forest(cout, g);
+
+  if ( stats != NULL ) {
+    stats->dump_json(cout);
+  }
+}
+
+// 字句のパターンを持つ式の文法で字句解析器を作り，
+// 字句解析した結果を構文解析する．
+void
+test6(const Tracer& tracer,
+      BuildStats* stats)
+{
+  Grammer g;
+
+  // if は識別子より先に追加したので識別子より優先される．
+  Token* kw_if = g.add_token("if");
+  Token* id = g.add_token("id");
+  Token* num = g.add_token("num");
+  Token* plus = g.add_token("+");
+  Token* times = g.add_token("*");
+  Token* lpar = g.add_token("(");
+  Token* rpar = g.add_token(")");
+  Token* expr = g.add_token("expr");
+  Token* term = g.add_token("term");
+  Token* factor = g.add_token("factor");
+
+  g.set_pattern(kw_if, "if");
+  g.set_pattern(id, "[A-Za-z_]\\w*");
+  g.set_pattern(num, "[0-9]+|0x[0-9a-fA-F]+");
+  g.set_pattern(plus, "\\+");
+  g.set_pattern(times, "\\*");
+  g.set_pattern(lpar, "\\(");
+  g.set_pattern(rpar, "\\)");
+  g.add_skip_pattern("\\s+");
+  g.add_skip_pattern("//[^\\n]*");
+
+  {
+    vector<Token*> right;
+    right.push_back(expr);
+    right.push_back(plus);
+    right.push_back(term);
+    g.add_rule(expr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(term);
+    g.add_rule(expr, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(term);
+    right.push_back(times);
+    right.push_back(factor);
+    g.add_rule(term, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(factor);
+    g.add_rule(term, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(lpar);
+    right.push_back(expr);
+    right.push_back(rpar);
+    g.add_rule(factor, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(id);
+    g.add_rule(factor, right);
+  }
+  {
+    vector<Token*> right;
+    right.push_back(num);
+    g.add_rule(factor, right);
+  }
+  g.set_start(expr, stats);
+
+  Lexer lexer(g);
+  lexer.print(cout, g);
+
+  LALR1Set lalr1set(&g, tracer, stats);
+  ParseTable table(g, lalr1set, stats);
+  LRParser parser(table);
+
+  const char* text_list[] = {
+    "if ifx + 0x1F * (y2 + 3) // comment\n+ 10",
+    "ifx + 0x1F * (y2 + 3) // comment\n+ 10",
+    "a + $b",
+    NULL
+  };
+  for (ymuint i = 0; text_list[i] != NULL; ++ i) {
+    string text(text_list[i]);
+    vector<ymuint> token_list;
+    ymuint64 n = lexer.scan(text.c_str(), text.size(), token_list);
+    cout << "lexer scan: " << n << " / " << text.size() << " bytes:";
+    for (vector<ymuint>::iterator p = token_list.begin();
+	 p != token_list.end(); ++ p) {
+      cout << " " << g.token(*p)->str();
+    }
+    cout << endl;
+    if ( n == text.size() ) {
+      bool stat = parser.parse(token_list);
+      cout << "lexer parse: " << (stat ? "accepted" : "rejected") << endl;
+    }
+  }
+
+  // ファイルを写像して字句解析すると字句は写像の中を指す．
+  {
+    const char* filename = "Grammer_test.lex";
+    string text(text_list[0]);
+    {
+      ofstream out(filename, ios::binary);
+      out << text;
+    }
+    MappedFile file;
+    if ( file.open(filename, MappedFile::kSequential | MappedFile::kHugePage) ) {
+      vector<ymuint> token_list;
+      vector<StrView> view_list;
+      ymuint64 n = lexer.scan(file.data(), file.size(), token_list, view_list);
+      cout << "mapped scan: " << n << " / " << file.size() << " bytes:";
+      bool inside = true;
+      for (ymuint i = 0; i < token_list.size(); ++ i) {
+	cout << " " << g.token(token_list[i])->str() << "[" << view_list[i] << "]";
+	if ( view_list[i].data() < file.data() ||
+	     view_list[i].data() + view_list[i].size() > file.data() + file.size() ) {
+	  inside = false;
+	}
+      }
+      cout << endl
+	   << "mapped views: " << (inside ? "inside" : "outside") << endl;
+      file.close();
+    }
+    remove(filename);
+  }
+
+  // 生成した文をトークンごとの見本の字句でつないだものを字句解析すると
+  // 元のトークンの列に戻る．
+  vector<string> sample(g.token_num());
+  sample[id->id()] = "if2";
+  sample[num->id()] = "0x2a";
+  sample[plus->id()] = "+";
+  sample[times->id()] = "*";
+  sample[lpar->id()] = "(";
+  sample[rpar->id()] = ")";
+  SentenceGen gen(g);
+  gen.set_growth(4.0);
+  TokenListSink sink;
+  const ymuint n = 100;
+  ymuint same = 0;
+  for (ymuint i = 0; i < n; ++ i) {
+    sink.mList.clear();
+    gen.generate(expr, i, sink);
+    string text;
+    for (vector<ymuint>::iterator p = sink.mList.begin();
+	 p != sink.mList.end(); ++ p) {
+      text += sample[*p];
+      text += i % 2 == 0 ? " " : "\t//\n";
+    }
+    vector<ymuint> token_list;
+    if ( lexer.scan(text.c_str(), text.size(), token_list) == text.size() &&
+	 token_list == sink.mList ) {
+      ++ same;
+    }
+  }
+  cout << "lexer check: " << same << " / " << n << " agreed" << endl;
+  check_all("lexer", same, n);
+
+  // 長い空白，識別子，注釈を含む入力はどの読み飛ばし方式でも
+  // 同じトークンの列になる．
+  cout << "lexer run states: " << lexer.run_state_num() << endl;
+  ymuint simd_same = 0;
+  for (ymuint i = 0; i < n; ++ i) {
+    sink.mList.clear();
+    gen.generate(expr, i, sink);
+    string text;
+    for (vector<ymuint>::iterator p = sink.mList.begin();
+	 p != sink.mList.end(); ++ p) {
+      if ( *p == id->id() ) {
+	text += "x" + string((i * 7 + text.size()) % 67, 'z') + "_9";
+      }
+      else {
+	text += sample[*p];
+      }
+      text += string((i * 13 + text.size()) % 90, ' ');
+      if ( text.size() % 3 == 0 ) {
+	text += "//" + string(i % 80, 'c') + "\n";
+      }
+    }
+    bool ok = true;
+    for (ymuint mode = Lexer::kScalar; mode <= Lexer::kAVX2; ++ mode) {
+      lexer.set_simd_mode(static_cast<Lexer::SimdMode>(mode));
+      vector<ymuint> token_list;
+      if ( lexer.scan(text.c_str(), text.size(), token_list) != text.size() ||
+	   token_list != sink.mList ) {
+	ok = false;
+      }
+    }
+    lexer.set_simd_mode(Lexer::best_simd_mode());
+    if ( ok ) {
+      ++ simd_same;
+    }
+  }
+  cout << "simd check: " << simd_same << " / " << n << " agreed" << endl;
+  check_all("simd", simd_same, n);
+
+  // キーワードを DFA から除いても除かない時と同じトークンの列になる．
+  // キーワードに似た識別子も試す．
+  {
+    const char* kw_list[] = {
+      "always", "and", "assign", "begin", "buf", "case", "casex", "casez",
+      "default", "defparam", "else", "end", "endcase", "endfunction",
+      "endmodule", "endtask", "for", "forever", "function", "if", "initial",
+      "inout", "input", "integer", "module", "nand", "negedge", "nor", "not",
+      "or", "output", "parameter", "posedge", "reg", "repeat", "task",
+      "wire", "while", "xor", NULL
+    };
+    Grammer g3;
+    for (ymuint i = 0; kw_list[i] != NULL; ++ i) {
+      Token* kw = g3.add_token(kw_list[i]);
+      g3.set_pattern(kw, kw_list[i]);
+    }
+    Token* id3 = g3.add_token("id");
+    g3.set_pattern(id3, "[A-Za-z_][A-Za-z_0-9]*");
+    Token* semi3 = g3.add_token(";");
+    g3.set_pattern(semi3, ";");
+    g3.add_skip_pattern("\\s+");
+    Lexer split_lexer(g3);
+    Lexer whole_lexer(g3, false);
+    cout << "keyword lexer: " << split_lexer.keyword_num() << " keywords, "
+	 << split_lexer.state_num() << " / " << whole_lexer.state_num()
+	 << " states" << endl;
+    string text;
+    for (ymuint i = 0; kw_list[i] != NULL; ++ i) {
+      string kw(kw_list[i]);
+      text += kw + " " + kw + "x " + kw.substr(0, kw.size() - 1) + "; _"
+	+ kw + " " + static_cast<char>(kw[0] - 'a' + 'A') + kw.substr(1) + "\n";
+    }
+    vector<ymuint> split_list;
+    vector<ymuint> whole_list;
+    split_lexer.scan(text.c_str(), text.size(), split_list);
+    whole_lexer.scan(text.c_str(), text.size(), whole_list);
+    ymuint kw_num = 0;
+    for (vector<ymuint>::iterator p = split_list.begin();
+	 p != split_list.end(); ++ p) {
+      if ( *p < id3->id() ) {
+	++ kw_num;
+      }
+    }
+    cout << "keyword check: " << (split_list == whole_list ? "agreed" : "differ")
+	 << " (" << kw_num << " keywords in " << split_list.size() << " tokens)"
+	 << endl;
+    check_all("keyword", split_list == whole_list ? 1 : 0, 1);
+
+    // 受け付けるトークンを絞っても二つの字句解析器は同じ結果になる．
+    const ymuint word_num = (g3.token_num() + 63) / 64;
+    const ymuint mask_num = 64;
+    ymuint mask_same = 0;
+    ymuint64 seed = 1;
+    for (ymuint i = 0; i < mask_num; ++ i) {
+      vector<ymuint64> acceptable(word_num, 0ULL);
+      for (ymuint t = 0; t < g3.token_num(); ++ t) {
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	if ( (seed >> 33) % 4 != 0 ) {
+	  acceptable[t / 64] |= 1ULL << (t % 64);
+	}
+      }
+      vector<ymuint> result_list[2];
+      const Lexer* lexer_list[2] = { &split_lexer, &whole_lexer };
+      for (ymuint j = 0; j < 2; ++ j) {
+	const char* pos = text.c_str();
+	const char* end = pos + text.size();
+	for ( ; ; ) {
+	  const char* start;
+	  ymuint token = lexer_list[j]->next_token(pos, end, start, &acceptable[0]);
+	  result_list[j].push_back(token);
+	  result_list[j].push_back(start - text.c_str());
+	  if ( token == Grammer::kEnd ) {
+	    break;
+	  }
+	  if ( token == Lexer::kNoToken ) {
+	    pos = start + 1;
+	  }
+	}
+      }
+      if ( result_list[0] == result_list[1] ) {
+	++ mask_same;
+      }
+    }
+    cout << "keyword context check: " << mask_same << " / " << mask_num
+	 << " agreed" << endl;
+    check_all("keyword context", mask_same, mask_num);
+  }
+
+  // 構文解析器の状態で受け付けるトークンだけを読むと，キーワードと
+  // 同じ綴りの識別子も読める．
+  {
+    Grammer g4;
+    Token* get4 = g4.add_token("get");
+    g4.set_pattern(get4, "get");
+    Token* id4 = g4.add_token("id");
+    g4.set_pattern(id4, "[a-z]+");
+    Token* semi4 = g4.add_token(";");
+    g4.set_pattern(semi4, ";");
+    Token* eq4 = g4.add_token("=");
+    g4.set_pattern(eq4, "=");
+    g4.add_skip_pattern("\\s+");
+    Token* list4 = g4.add_token("list");
+    Token* stmt4 = g4.add_token("stmt");
+    {
+      vector<Token*> right;
+      right.push_back(list4);
+      right.push_back(stmt4);
+      g4.add_rule(list4, right);
+    }
+    {
+      vector<Token*> right;
+      right.push_back(stmt4);
+      g4.add_rule(list4, right);
+    }
+    {
+      vector<Token*> right;
+      right.push_back(get4);
+      right.push_back(id4);
+      right.push_back(semi4);
+      g4.add_rule(stmt4, right);
+    }
+    {
+      vector<Token*> right;
+      right.push_back(id4);
+      right.push_back(eq4);
+      right.push_back(id4);
+      right.push_back(semi4);
+      g4.add_rule(stmt4, right);
+    }
+    g4.set_start(list4, stats);
+    LALR1Set lalr1set4(&g4, tracer, stats);
+    ParseTable table4(g4, lalr1set4, stats);
+    LRParser parser4(table4);
+    Lexer split_lexer(g4);
+    Lexer whole_lexer(g4, false);
+
+    const char* text_list[] = {
+      "get x; x = y;",
+      "get get; x = get;",
+      "get = x;",
+      NULL
+    };
+    for (ymuint i = 0; text_list[i] != NULL; ++ i) {
+      string text(text_list[i]);
+      vector<ymuint> token_list;
+      bool stat = split_lexer.scan(text.c_str(), text.size(), token_list) == text.size() &&
+	parser4.parse(token_list);
+      cout << "context text: " << text << endl
+	   << "  plain parse: " << (stat ? "accepted" : "rejected") << endl;
+
+      vector<ymuint> result_list[2];
+      LRParser::PushResult end_list[2];
+      const Lexer* lexer_list[2] = { &split_lexer, &whole_lexer };
+      for (ymuint j = 0; j < 2; ++ j) {
+	const char* pos = text.c_str();
+	const char* end = pos + text.size();
+	parser4.start();
+	LRParser::PushResult result = LRParser::kNeedMore;
+	while ( result == LRParser::kNeedMore ) {
+	  const char* start;
+	  ymuint token = lexer_list[j]->next_token(pos, end, start,
+						   parser4.acceptable_tokens());
+	  if ( token == Lexer::kNoToken ) {
+	    result = LRParser::kRejected;
+	    break;
+	  }
+	  result_list[j].push_back(token);
+	  result = parser4.push(token);
+	}
+	end_list[j] = result;
+      }
+      bool same = result_list[0] == result_list[1] && end_list[0] == end_list[1];
+      check_all("context lexers", same ? 1 : 0, 1);
+      cout << "  context parse:";
+      for (vector<ymuint>::iterator p = result_list[0].begin();
+	   p != result_list[0].end(); ++ p) {
+	cout << " " << g4.token(*p)->str();
+      }
+      cout << " : " << (end_list[0] == LRParser::kAccepted ? "accepted" : "rejected")
+	   << endl
+	   << "  context lexers: " << (same ? "agreed" : "differ") << endl;
+    }
+  }
+
+  // 書き方の誤ったパターンは無視される．
+  Grammer g2;
+  Token* bad = g2.add_token("bad");
+  g2.set_pattern(bad, "(ab");
+  Lexer lexer2(g2);
+  cout << "lexer errors: " << lexer2.error_num() << endl;
+}
+
+// 失敗した照合があれば 1 を返す．
+int
 Grammer_test(int argc,
 	     char** argv)
 {
-#if 0
-  test1();
+  // -t が指定されたら構文解析表生成のトレースを出力する．
+  // -s が指定されたら統計情報を出力する．
+  // -p <prefix> が指定されたらフェーズごとのプロファイルを出力する．
+  StreamTraceSink sink(cout);
+  Tracer tracer;
+  BuildStats build_stats;
+  BuildStats* stats = NULL;
+  for (int i = 1; i < argc; ++ i) {
+    string opt(argv[i]);
+    if ( opt == "-t" ) {
+      tracer = Tracer(&sink, kTraceAll);
+    }
+    else if ( opt == "-s" ) {
+      stats = &build_stats;
+    }
+    else if ( opt == "-p" && i + 1 < argc ) {
+      ++ i;
+      PhaseProfiler::set_default_prefix(argv[i]);
+    }
+  }
+
+#if 1
+  test0(tracer, stats);
+#endif
+
+#if 1
+  test1(tracer, stats);
+#endif
+
+#if 1
+  test2(tracer, stats);
 #endif
 
-#if 0
-  test2();
+#if 1
+  test3(tracer, stats);
 #endif
 
 #if 1
-  test3();
+  test4(tracer, stats);
 #endif
+
+#if 1
+  test5(tracer, stats);
+#endif
+
+#if 1
+  test6(tracer, stats);
+#endif
+
+  return gFailNum == 0 ? 0 : 1;
 }
 
 END_NAMESPACE_YM
@@ -203,7 +1228,5 @@ int
 main(int argc,
      char** argv)
 {
-  YMTOOLS_NAMESPACE::Grammer_test(argc, argv);
-
-  return 0;
+  return YMTOOLS_NAMESPACE::Grammer_test(argc, argv);
 }